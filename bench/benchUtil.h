@@ -0,0 +1,49 @@
+#pragma once
+
+// Helpers shared by the bench and check programs: fixture loading, tolerant
+// comparison, failure reporting and small hand-built books.
+#include "bookSnapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#ifndef TRADESIM_FIXTURE_DIR
+#define TRADESIM_FIXTURE_DIR "bench/fixtures"
+#endif
+
+// Whole file as a string; empty if it cannot be read
+inline std::string loadFixture(const std::string& dir, const char* name) {
+    std::ifstream in(dir + "/" + name, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+inline std::string loadFixture(const char* name) { return loadFixture(TRADESIM_FIXTURE_DIR, name); }
+
+// Equal to within a relative tolerance, absolute below magnitude 1
+inline bool near(double a, double b, double relative = 1e-9) {
+    return std::fabs(a - b) <= relative * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+// Reports a failed check on stderr; returns the condition
+inline bool expect(bool condition, const char* what) {
+    if (!condition) std::fprintf(stderr, "FAIL: %s\n", what);
+    return condition;
+}
+
+// Indexed snapshot from hand-written levels (default grid)
+inline OrderBookSnapshot makeBook(OrderBookSide bids, OrderBookSide asks,
+                                  std::chrono::steady_clock::time_point when = {}) {
+    OrderBookSnapshot book;
+    book.bids = std::move(bids);
+    book.asks = std::move(asks);
+    book.timestamp = when;
+    indexSnapshot(book);
+    return book;
+}
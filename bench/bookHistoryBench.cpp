@@ -0,0 +1,184 @@
+// Book history: ring capture, segment spill and as-of queries. Feeds the
+// OKX fixture book plus synthetic deltas through an Orderbook with a
+// BookHistory observer spilling to a scratch directory, keeping reference
+// copies of sampled books. Exits non-zero if
+//   - "book as of T" from the ring or from the mapped segments differs from
+//     the reference book published at T;
+//   - a column decoded from the segments differs from the same ring column.
+// Also reports bytes per row on disk and times capture, lookups and scans.
+// Build with the book_history_bench target; pass the fixture directory as
+// argv[1] to override.
+// Usage: book_history_bench [fixtures] [updates]
+#include "benchUtil.h"
+#include "bookHistory.h"
+#include "logger.h"
+#include "syntheticFeed.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile double sink = 0.0;
+
+double nsSince(Clock::time_point start, size_t count) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+}
+
+struct Reference {
+    int64_t timestampNs;
+    OrderBookSnapshot book;  // top levels only
+};
+
+bool sameBook(const OrderBookSnapshot& a, const OrderBookSnapshot& b) {
+    return a.version == b.version && a.bids.prices == b.bids.prices && a.bids.quantities == b.bids.quantities &&
+           a.asks.prices == b.asks.prices && a.asks.quantities == b.asks.quantities;
+}
+
+OrderBookSnapshot topOf(const OrderBookSnapshot& book, size_t levels) {
+    OrderBookSnapshot top;
+    for (size_t k = 0; k < levels && k < book.bids.size(); ++k) top.bids.push_back(book.bids[k]);
+    for (size_t k = 0; k < levels && k < book.asks.size(); ++k) top.asks.push_back(book.asks[k]);
+    top.version = book.version;
+    return top;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : TRADESIM_FIXTURE_DIR;
+    size_t updates = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200000;
+    Logger::instance().setLevel(LogLevel::Error);
+
+    std::string snapshotJson = loadFixture(dir, "okx_books_snapshot.json");
+    BookMessage message;
+    if (parseOkxBookMessage(snapshotJson, message) != BookParseStatus::Book) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json in %s\n", dir.c_str());
+        return 1;
+    }
+    SyntheticDeltas generator(message);
+    std::vector<std::string> deltas;
+    size_t jsonBytes = 0;
+    for (size_t i = 0; i < updates; ++i) {
+        deltas.push_back(generator.next());
+        jsonBytes += deltas.back().size();
+    }
+
+    std::filesystem::path scratch = std::filesystem::temp_directory_path() / "tradesim_history_bench";
+    std::filesystem::remove_all(scratch);
+    HistoryConfig config;
+    config.directory = scratch.string();
+    bool ok = true;
+    std::vector<Reference> references;
+    {
+        BookHistory history(config);
+        Orderbook book;
+        book.addObserver(&history);
+        if (book.updateFromJson(snapshotJson) != BookUpdateResult::Applied) return 1;
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < updates; ++i) {
+            if (book.updateFromJson(deltas[i]) != BookUpdateResult::Applied) {
+                std::fprintf(stderr, "synthetic delta %zu did not apply\n", i);
+                return 1;
+            }
+            if (i % 97 == 0) references.push_back({history.newestNs(), topOf(*book.snapshot(), history.levels())});
+        }
+        double feedNs = nsSince(start, updates);
+
+        // The same capture without the book in front of it
+        BookHistory memoryOnly(HistoryConfig{});
+        SnapshotHandle last = book.snapshot();
+        start = Clock::now();
+        for (size_t i = 0; i < updates; ++i) memoryOnly.append(*last, static_cast<int64_t>(i));
+        double ringNs = nsSince(start, updates);
+        HistoryConfig encodeOnly = config;
+        encodeOnly.directory = (scratch / "encode").string();
+        BookHistory spilling(encodeOnly);
+        start = Clock::now();
+        for (size_t i = 0; i < updates; ++i) spilling.append(*last, static_cast<int64_t>(i) - 1000000000);
+        double spillNs = nsSince(start, updates);
+        std::printf("capture: %.0f ns per row into the ring, %.0f ns with segment encoding; "
+                    "feed + capture %.0f ns per delta (%llu waits on the segment writer)\n", ringNs, spillNs,
+                    feedNs, static_cast<unsigned long long>(history.writerStalls() + spilling.writerStalls()));
+
+        // As-of from the ring, for the references it still holds
+        size_t checked = 0;
+        OrderBookSnapshot out;
+        start = Clock::now();
+        for (const Reference& r : references) {
+            if (r.timestampNs < history.oldestNs()) continue;
+            if (!history.bookAt(r.timestampNs, out) || !sameBook(topOf(out, history.levels()), r.book)) ok = false;
+            ++checked;
+        }
+        std::printf("ring as-of: %zu lookups, %.0f ns each\n", checked, checked ? nsSince(start, checked) : 0.0);
+        if (!ok) std::fprintf(stderr, "FAIL: ring as-of lookup returned a different book\n");
+
+        // Vectorized scan: mean best bid over everything in memory
+        HistorySpan<double> bids =
+            history.column(HistoryField::BidPrice, 0, history.oldestNs(), history.newestNs() + 1);
+        start = Clock::now();
+        double sum = 0.0;
+        for (int run = 0; run < 2; ++run)
+            for (size_t i = 0; i < bids.count[run]; ++i) sum += bids.data[run][i];
+        std::printf("ring scan: %zu rows of best bid, %.2f ns per row, mean %.2f\n", bids.size(),
+                    nsSince(start, bids.size()), sum / bids.size());
+        sink = sum;
+
+        // Segment decode of the newest rows against the ring
+        history.flush();
+        HistoryArchive archive;
+        if (!archive.open(config.directory)) {
+            std::fprintf(stderr, "FAIL: no segments written to %s\n", config.directory.c_str());
+            return 1;
+        }
+        const HistorySegment& newest = archive.segment(archive.segmentCount() - 1);
+        std::vector<double> decoded(newest.rows());
+        start = Clock::now();
+        newest.decodeColumn(HistoryField::AskQuantity, 3, 0, newest.rows(), decoded.data());
+        double decodeNs = nsSince(start, newest.rows());
+        std::vector<int64_t> stamps(newest.rows());
+        newest.decodeTimestamps(0, newest.rows(), stamps.data());
+        HistorySpan<double> ring = history.column(HistoryField::AskQuantity, 3, stamps.front(), stamps.back() + 1);
+        bool sameColumn = ring.size() == decoded.size();
+        for (size_t i = 0; sameColumn && i < decoded.size(); ++i) sameColumn = ring[i] == decoded[i];
+        std::printf("segment decode: %zu rows of one column, %.1f ns per row\n", decoded.size(), decodeNs);
+        if (!sameColumn) {
+            std::fprintf(stderr, "FAIL: decoded segment column differs from the ring\n");
+            ok = false;
+        }
+    }
+
+    // Segments alone, after the writer is gone
+    HistoryArchive archive;
+    archive.open(config.directory);
+    size_t diskBytes = 0;
+    size_t rows = 0;
+    for (size_t i = 0; i < archive.segmentCount(); ++i) rows += archive.segment(i).rows();
+    for (const auto& entry : std::filesystem::directory_iterator(scratch))
+        if (entry.path().extension() == ".seg") diskBytes += entry.file_size();
+    std::printf("segments: %zu files, %zu rows of %zu levels per side, %.1f bytes per row on disk "
+                "(%zu raw, %.0f bytes of JSON per delta)\n",
+                archive.segmentCount(), rows, config.levels, double(diskBytes) / rows,
+                (2 + 4 * config.levels) * sizeof(double), double(jsonBytes) / updates);
+
+    OrderBookSnapshot out;
+    size_t mismatches = 0;
+    auto start = Clock::now();
+    for (const Reference& r : references)
+        if (!archive.bookAt(r.timestampNs, out) || !sameBook(out, r.book)) ++mismatches;
+    std::printf("segment as-of: %zu lookups, %.1f us each, %zu mismatches\n", references.size(),
+                nsSince(start, references.size()) / 1000.0, mismatches);
+    if (mismatches) {
+        std::fprintf(stderr, "FAIL: segment as-of lookup returned a different book\n");
+        ok = false;
+    }
+    std::filesystem::remove_all(scratch);
+    Logger::instance().flush();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// Checks each exchange policy end to end on recorded-shape fixtures: decode,
+// snapshot + delta application, the venue's sequencing rules (stale vs gap),
+// control-message handling, subscribe payloads and grids derived for unlisted
+// symbols. Exits non-zero on the
+// first mismatch. Build with the exchange_adapter_check target; pass the
+// fixture directory as argv[1] to override.
+#include "benchUtil.h"
+#include "exchange.h"
+#include "logger.h"
+#include "orderbook.h"
+#include <cstdio>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* venue, const char* what) {
+    if (condition) return;
+    std::fprintf(stderr, "FAIL: %s: %s\n", venue, what);
+    ++failures;
+}
+
+struct VenueCase {
+    const char* snapshot;
+    const char* delta;
+    double bestBid, bestAsk;                  // after the snapshot
+    double bidQuantityAfterDelta, askAfterDelta;
+    BookUpdateResult repeatedDelta;           // the same delta applied twice
+    const char* ack;                          // subscribe acknowledgement
+    const char* error;                        // error reply
+    const char* subscribeText;                // must appear in the subscribe payload
+};
+
+template <class Venue>
+void check(const std::string& dir, const VenueCase& c) {
+    const char* name = Venue::kName.data();
+    std::string snapshot = loadFixture(dir, c.snapshot);
+    std::string delta = loadFixture(dir, c.delta);
+    if (snapshot.empty() || delta.empty()) {
+        expect(false, name, "missing fixture");
+        return;
+    }
+
+    BookMessage message;
+    expect(Venue::decode(snapshot, message) == BookParseStatus::Book && message.isSnapshot(), name,
+           "snapshot decodes as a snapshot");
+    expect(Venue::decode(delta, message) == BookParseStatus::Book && !message.isSnapshot(), name,
+           "delta decodes as an update");
+    expect(Venue::decode(c.ack, message) == BookParseStatus::NotBook, name, "ack is not a book");
+    expect(Venue::decode("{\"data\":[", message) == BookParseStatus::Malformed, name, "truncated JSON is malformed");
+
+    Orderbook book(400, 400, Venue::instrument(Venue::kDefaultSymbol));
+    expect(book.update<Venue>(delta) == BookUpdateResult::Ignored, name, "delta before a snapshot is ignored");
+    expect(book.update<Venue>(snapshot) == BookUpdateResult::Applied, name, "snapshot applies");
+    TopOfBook top = book.getTopOfBook();
+    expect(top.bidPrice == c.bestBid && top.askPrice == c.bestAsk, name, "snapshot top of book");
+
+    expect(book.update<Venue>(delta) == BookUpdateResult::Applied, name, "delta applies");
+    top = book.getTopOfBook();
+    expect(top.bidQuantity == c.bidQuantityAfterDelta && top.askPrice == c.askAfterDelta, name,
+           "delta top of book");
+
+    expect(book.update<Venue>(delta) == c.repeatedDelta, name, "repeated delta follows the venue's rule");
+    expect(book.isSynced() == (c.repeatedDelta != BookUpdateResult::ResyncRequired), name,
+           "sync state after the repeated delta");
+
+    expect(Venue::controlError(c.ack).empty(), name, "ack is not an error");
+    expect(!Venue::controlError(c.error).empty(), name, "error reply is reported");
+    expect(Venue::subscribeMessage(Venue::kDefaultSymbol, true).find(c.subscribeText) != std::string::npos, name,
+           "subscribe payload names the book");
+}
+
+// A symbol with no listed grid whose sizes go finer than the 1e-8 stand-in:
+// the first fine delta forces one resync, after which the book keeps up
+void checkDerivedGrid() {
+    const char* snapshot =
+        R"({"arg":{"channel":"books","instId":"TINY-USDT"},"action":"snapshot","data":[{"asks":[["0.000000123","5000","0","1"]],)"
+        R"("bids":[["0.000000122","4000","0","1"]],"ts":"1","seqId":10,"prevSeqId":-1}]})";
+    const char* delta =
+        R"({"arg":{"channel":"books","instId":"TINY-USDT"},"action":"update","data":[{"asks":[],)"
+        R"("bids":[["0.000000122","4000.0000000005","0","1"]],"ts":"2","seqId":11,"prevSeqId":10}]})";
+
+    Orderbook book(400, 400, Okx::instrument("TINY-USDT"));
+    expect(book.updateFromJson(snapshot) == BookUpdateResult::Applied, "derived grid", "9-decimal snapshot applies");
+    expect(book.getBestBid() == 0.000000122, "derived grid", "sub-1e-8 price is exact");
+    expect(book.updateFromJson(delta) == BookUpdateResult::ResyncRequired, "derived grid",
+           "finer delta asks for a resync");
+    expect(book.updateFromJson(snapshot) == BookUpdateResult::Applied, "derived grid", "resnapshot applies");
+    expect(book.updateFromJson(delta) == BookUpdateResult::Applied, "derived grid", "finer delta then applies");
+    expect(book.getTopOfBook().bidQuantity == 4000.0000000005, "derived grid", "delta size is exact");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : TRADESIM_FIXTURE_DIR;
+    Logger::instance().setLevel(LogLevel::Error);  // the gap warnings are expected
+
+    check<Okx>(dir, {"okx_books_snapshot.json", "okx_books_update.json", 67321.3, 67321.5, 0.97156591, 67321.5,
+                     BookUpdateResult::ResyncRequired,
+                     R"({"event":"subscribe","arg":{"channel":"books","instId":"BTC-USDT"},"connId":"a4d3ae55"})",
+                     R"({"event":"error","code":"60012","msg":"Invalid request","connId":"a4d3ae55"})",
+                     R"("instId":"BTC-USDT")"});
+    check<Binance>(dir, {"binance_depth_snapshot.json", "binance_depth_update.json", 67320.5, 67320.51, 1.9,
+                         67320.52, BookUpdateResult::Ignored, R"({"result":null,"id":1})",
+                         R"({"error":{"code":2,"msg":"Invalid request: unknown variant"},"id":1})",
+                         "btcusdt@depth20@100ms"});
+    check<Bybit>(dir, {"bybit_orderbook_snapshot.json", "bybit_orderbook_delta.json", 67320.5, 67320.51, 1.9,
+                       67320.52, BookUpdateResult::ResyncRequired,
+                       R"({"success":true,"ret_msg":"","conn_id":"0970e817","req_id":"","op":"subscribe"})",
+                       R"({"success":false,"ret_msg":"error:handler not found","conn_id":"0970e817","op":"subscribe"})",
+                       "orderbook.50.BTCUSDT"});
+
+    // Fee tiers are table lookups evaluated at compile time
+    static_assert(Okx::feeTier(1).taker == 0.001, "OKX entry tier");
+    static_assert(Binance::feeRate(4, true) == 0.00042, "Binance VIP3 maker");
+    static_assert(Bybit::feeRate(0, false) == Bybit::feeRate(1, false), "tiers clamp");
+
+    checkDerivedGrid();
+
+    ExchangeId id;
+    expect(parseExchangeId("binance", id) && id == ExchangeId::Binance, "ExchangeId", "parses lowercase names");
+    expect(!parseExchangeId("kraken", id), "ExchangeId", "rejects unknown venues");
+
+    Logger::instance().flush();
+    if (failures) return 1;
+    std::printf("exchange adapters OK\n");
+    return 0;
+}
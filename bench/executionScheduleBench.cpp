@@ -0,0 +1,284 @@
+// TWAP/VWAP/POV/custom execution schedules against a recorded book path.
+// Exits non-zero if
+//   - a one-child schedule differs from simulateMarketOrder on the same book;
+//   - children on a static path do not cost N independent sweeps when the
+//     book refills at once, or one sweep of the whole order when it never
+//     refills;
+//   - the volume proxy or POV child sizes differ from a scripted path;
+//   - an order the book cannot fill is reported as filled or chosen;
+//   - parallel evaluation differs from simulating each schedule alone.
+// Then times evaluating about a thousand candidate schedules over a path
+// built from the fixture book plus synthetic deltas, and prints the
+// cheapest.
+// Build with the execution_schedule_bench target; pass the fixture
+// directory as argv[1] to override.
+// Usage: execution_schedule_bench [fixtures] [updates]
+#include "benchUtil.h"
+#include "executionSchedule.h"
+#include "logger.h"
+#include "models/impact.h"
+#include "syntheticFeed.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int64_t kSecond = 1000000000LL;
+constexpr int64_t kUpdateNs = 10000000LL;  // replayed books 10 ms apart
+
+// Average price of sweeping quantity from the top of one side
+double sweepNotional(const OrderBookSide& levels, double quantity) {
+    double notional = 0.0;
+    for (size_t k = 0; k < levels.size() && quantity > 0.0; ++k) {
+        double take = std::min(quantity, levels.quantities[k]);
+        notional += take * levels.prices[k];
+        quantity -= take;
+    }
+    return notional;
+}
+
+ScheduleSpec twap(double seconds, size_t slices) {
+    ScheduleSpec spec;
+    spec.policy = SchedulePolicy::Twap;
+    spec.durationSeconds = seconds;
+    spec.slices = slices;
+    return spec;
+}
+
+bool checkAgainstSweeps() {
+    bool ok = true;
+    OrderBookSnapshot book = makeBook({{99.5, 3.0}, {99.0, 4.0}, {98.0, 10.0}},
+                                      {{100.0, 1.0}, {100.5, 2.0}, {101.0, 5.0}, {102.0, 10.0}});
+    const double mid = 99.75;
+
+    // One child is one market order
+    BookPath single;
+    single.append(book, 0);
+    ParentOrder order;
+    order.side = Side::Buy;
+    order.quantity = 6.0;
+    ScheduleCost cost = ScheduleSimulator::simulate(single, order, twap(0.0, 1));
+    TradeResult reference = simulateMarketOrder(book, Side::Buy, 6.0, order.fees, Clock::now());
+    ok &= expect(cost.childOrders == 1 && near(cost.executedQuantity, 6.0) &&
+                     near(cost.averagePrice, reference.averagePrice) && near(cost.fees, reference.feesPaid) &&
+                     near(cost.slippageCost, (reference.averagePrice - mid) * 6.0),
+                 "one child matches simulateMarketOrder");
+
+    order.side = Side::Sell;
+    order.quantity = 5.0;
+    cost = ScheduleSimulator::simulate(single, order, twap(0.0, 1));
+    reference = simulateMarketOrder(book, Side::Sell, 5.0, order.fees, Clock::now());
+    ok &= expect(near(cost.averagePrice, reference.averagePrice) &&
+                     near(cost.slippageCost, (mid - reference.averagePrice) * 5.0),
+                 "one sell child matches simulateMarketOrder");
+
+    // The same book every second for ten seconds
+    BookPath still;
+    for (int64_t s = 0; s <= 10; ++s) still.append(book, s * kSecond);
+    order.side = Side::Buy;
+    order.quantity = 8.0;
+    order.resilienceSeconds = 1e-6;
+    cost = ScheduleSimulator::simulate(still, order, twap(10.0, 4));
+    ok &= expect(cost.childOrders == 4 && near(cost.executedQuantity, 8.0) &&
+                     near(cost.averagePrice * 8.0, 4 * sweepNotional(book.asks, 2.0)),
+                 "a book that refills at once prices each child from the top");
+    order.resilienceSeconds = 1e9;
+    cost = ScheduleSimulator::simulate(still, order, twap(10.0, 4));
+    ok &= expect(near(cost.averagePrice * 8.0, sweepNotional(book.asks, 8.0), 1e-6),
+                 "a book that never refills prices the children as one sweep");
+    order.resilienceSeconds = 2.0;
+    ScheduleCost slow = ScheduleSimulator::simulate(still, order, twap(10.0, 4));
+    ScheduleCost fast = ScheduleSimulator::simulate(still, order, twap(1.0, 4));
+    ok &= expect(slow.totalCost < fast.totalCost, "slicing faster than the book refills costs more");
+
+    // More than the kept depth: reported unfilled and never chosen
+    order.quantity = 100.0;
+    cost = ScheduleSimulator::simulate(still, order, twap(0.0, 1));
+    ok &= expect(near(cost.executedQuantity, 18.0) && near(cost.unfilledQuantity, 82.0),
+                 "the rest of an order deeper than the book is unfilled");
+    order.quantity = 8.0;
+    std::vector<ScheduleCost> costs = {cost, slow, fast};
+    ok &= expect(ScheduleSimulator::cheapest(costs) == 1, "cheapest skips unfilled schedules");
+
+    // Children past the end of the path do not trade
+    order.quantity = 4.0;
+    cost = ScheduleSimulator::simulate(still, order, twap(40.0, 4));
+    ok &= expect(cost.childOrders == 2 && near(cost.unfilledQuantity, 2.0), "children past the path are unfilled");
+    return ok;
+}
+
+bool checkVolumeAndPov() {
+    bool ok = true;
+    // Touch quantity leaving: 1 at the bid, then the ask level of 2 traded through
+    BookPath path;
+    path.append(makeBook({{99.5, 3.0}}, {{100.0, 2.0}, {100.5, 5.0}}), 0);
+    path.append(makeBook({{99.5, 2.0}}, {{100.0, 2.0}, {100.5, 5.0}}), 1 * kSecond);
+    path.append(makeBook({{99.5, 2.0}}, {{100.5, 5.0}}), 2 * kSecond);
+    path.append(makeBook({{99.5, 4.0}}, {{100.5, 5.0}}), 3 * kSecond);
+    ok &= expect(near(path.activityAt(1), 1.0) && near(path.activityAt(2), 2.0) && near(path.activityAt(3), 0.0) &&
+                     near(path.activityThrough(3), 3.0),
+                 "volume proxy counts quantity leaving the touch");
+
+    std::vector<double> profile = path.activityProfile(0, 3.0, 3);
+    ok &= expect(profile.size() == 3 && near(profile[0], 0.0) && near(profile[1], 1.0 / 3.0) &&
+                     near(profile[2], 2.0 / 3.0),
+                 "activity profile is the proxy per slice");
+
+    ParentOrder order;
+    order.quantity = 10.0;
+    order.resilienceSeconds = 0.0;
+    ScheduleSpec pov;
+    pov.policy = SchedulePolicy::Pov;
+    pov.durationSeconds = 3.0;
+    pov.participation = 0.5;
+    pov.finishAtEnd = false;
+    ScheduleCost cost = ScheduleSimulator::simulate(path, order, pov);
+    ok &= expect(cost.childOrders == 2 && near(cost.executedQuantity, 1.5) &&
+                     near(cost.averagePrice, (0.5 * 100.0 + 1.0 * 100.5) / 1.5),
+                 "POV children follow participation x the proxy");
+    pov.finishAtEnd = true;
+    cost = ScheduleSimulator::simulate(path, order, pov);
+    ok &= expect(cost.childOrders == 3 && near(cost.unfilledQuantity, 3.5),
+                 "POV sweeps what is left at the end, as far as the book goes");
+
+    // VWAP with the profile puts nothing in the first slice
+    ScheduleSpec vwap;
+    vwap.policy = SchedulePolicy::Vwap;
+    vwap.durationSeconds = 3.0;
+    vwap.volumeProfile = profile;
+    order.quantity = 3.0;
+    cost = ScheduleSimulator::simulate(path, order, vwap);
+    ok &= expect(cost.childOrders == 2 && near(cost.averagePrice, (100.0 + 2 * 100.5) / 3.0) &&
+                     cost.unfilledQuantity == 0.0,
+                 "VWAP children follow the profile");
+    return ok;
+}
+
+// Candidates over TWAP, VWAP, POV and Almgren-Chriss schedules
+std::vector<ScheduleSpec> candidateSet(const BookPath& path, const OrderBookSnapshot& book, double quantity) {
+    std::vector<ScheduleSpec> candidates;
+    const double durations[] = {5.0, 15.0, 30.0, 60.0, 120.0, 300.0, 600.0};
+    for (double seconds : durations) {
+        for (size_t slices = 1; slices <= 120; slices += (slices < 20 ? 1 : 10)) {
+            candidates.push_back(twap(seconds, slices));
+            ScheduleSpec vwap = twap(seconds, slices);
+            vwap.policy = SchedulePolicy::Vwap;
+            vwap.volumeProfile = path.activityProfile(0, seconds, slices);
+            candidates.push_back(vwap);
+        }
+        for (double participation = 0.01; participation <= 0.5; participation *= 1.25) {
+            for (double interval : {0.5, 1.0, 5.0}) {
+                ScheduleSpec pov;
+                pov.policy = SchedulePolicy::Pov;
+                pov.durationSeconds = seconds;
+                pov.participation = participation;
+                pov.povIntervalSeconds = interval;
+                candidates.push_back(pov);
+            }
+        }
+        MarketImpactModel model({}, 32);
+        for (double lambda = 1e-9; lambda <= 1e-2; lambda *= 3.0) {
+            ImpactCalibration calibration;
+            calibration.riskAversion = lambda;
+            ScheduleSpec custom;
+            custom.policy = SchedulePolicy::Custom;
+            custom.durationSeconds = seconds;
+            custom.trajectory = model.trajectory(calibrateImpact(book, calibration), quantity, seconds);
+            candidates.push_back(custom);
+        }
+    }
+    return candidates;
+}
+
+const char* policyName(SchedulePolicy policy) {
+    switch (policy) {
+    case SchedulePolicy::Twap: return "twap";
+    case SchedulePolicy::Vwap: return "vwap";
+    case SchedulePolicy::Pov: return "pov";
+    case SchedulePolicy::Custom: return "almgren-chriss";
+    }
+    return "?";
+}
+
+bool measureThroughput(const std::string& snapshotJson, size_t updates) {
+    BookMessage message;
+    if (parseOkxBookMessage(snapshotJson, message) != BookParseStatus::Book) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json\n");
+        return false;
+    }
+    SyntheticDeltas generator(message);
+    Orderbook book(400, 400, InstrumentSpec(0.1, 1e-8));
+    if (book.updateFromJson(snapshotJson) != BookUpdateResult::Applied) return false;
+
+    BookPath path(25, updates + 1);
+    SnapshotHandle first = book.snapshot();
+    path.append(*first, 0);
+    double recordSeconds = 0.0;
+    for (size_t u = 1; u <= updates; ++u) {
+        if (book.updateFromJson(generator.next()) != BookUpdateResult::Applied) return false;
+        SnapshotHandle snap = book.snapshot();
+        auto appendStart = Clock::now();
+        path.append(*snap, static_cast<int64_t>(u) * kUpdateNs);
+        recordSeconds += std::chrono::duration<double>(Clock::now() - appendStart).count();
+    }
+
+    ParentOrder order;
+    order.side = Side::Buy;
+    order.quantity = 5.0;  // BTC; several times the visible top levels
+    std::vector<ScheduleSpec> candidates = candidateSet(path, *first, order.quantity);
+
+    ScheduleSimulator simulator;
+    auto start = Clock::now();
+    std::vector<ScheduleCost> costs = simulator.evaluate(path, order, candidates);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    bool ok = true;
+    size_t children = 0, filled = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        ScheduleCost alone = ScheduleSimulator::simulate(path, order, candidates[i]);
+        if (alone.totalCost != costs[i].totalCost || alone.childOrders != costs[i].childOrders) ok = false;
+        children += costs[i].childOrders;
+        filled += costs[i].unfilledQuantity == 0.0;
+    }
+    ok = expect(ok, "parallel evaluation matches simulating each schedule alone");
+
+    std::printf("path: %zu books over %.0f s recorded in %.0f ns each\n", path.size(),
+                static_cast<double>(updates) * kUpdateNs / 1e9, recordSeconds / updates * 1e9);
+    std::printf("evaluate: %zu schedules (%zu children) on %zu threads in %.3f s = %.0f schedules/s, "
+                "%.0f ns per child\n",
+                candidates.size(), children, simulator.threadCount(), seconds, candidates.size() / seconds,
+                seconds / std::max<size_t>(children, 1) * 1e9);
+    size_t best = ScheduleSimulator::cheapest(costs);
+    ok &= expect(best < candidates.size(), "some schedule fills the order");
+    if (best < candidates.size()) {
+        const ScheduleSpec& spec = candidates[best];
+        const ScheduleCost& c = costs[best];
+        ScheduleCost sweep = costs[0];  // twap over one slice: one market order at arrival
+        std::printf("cheapest of %zu filled: %s over %.0f s, %zu children, %.2f bps (slippage %.2f, fees %.2f); "
+                    "one sweep at arrival %.2f bps\n",
+                    filled, policyName(spec.policy), spec.durationSeconds, c.childOrders, c.costBps, c.slippageCost,
+                    c.fees, sweep.costBps);
+        ok &= expect(c.totalCost <= sweep.totalCost || sweep.unfilledQuantity > 0.0,
+                     "cheapest is no worse than one sweep");
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : TRADESIM_FIXTURE_DIR;
+    size_t updates = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 60000;
+    Logger::instance().setLevel(LogLevel::Error);
+    bool ok = checkAgainstSweeps();
+    ok &= checkVolumeAndPov();
+    ok &= measureThroughput(loadFixture(dir, "okx_books_snapshot.json"), updates);
+    Logger::instance().flush();
+    return ok ? 0 : 1;
+}
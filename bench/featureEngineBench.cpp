@@ -0,0 +1,152 @@
+// Incremental book features. Exits non-zero if
+//   - on the fixture book plus synthetic deltas, any feature differs from the
+//     same statistic recomputed from the snapshot (bookKernels walks);
+//   - order-flow imbalance gets the sign or size of scripted queue changes wrong;
+//   - realized volatility misses the volatility of a simulated mid path.
+// Also times an engine update against the from-scratch recomputation.
+// Build with the feature_engine_bench target; pass the fixture directory as
+// argv[1] to override.
+#include "benchUtil.h"
+#include "bookFeatures.h"
+#include "bookKernels.h"
+#include "logger.h"
+#include "okxParser.h"
+#include "syntheticFeed.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile double sink = 0.0;
+
+// Every published book against the statistics recomputed from it
+bool checkAgainstRecompute(const std::string& snapshotJson, size_t updates) {
+    BookMessage message;
+    if (parseOkxBookMessage(snapshotJson, message) != BookParseStatus::Book) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json\n");
+        return false;
+    }
+    SyntheticDeltas generator(message);
+    Orderbook book;
+    FeatureEngine engine;
+    book.addObserver(&engine);
+    if (book.updateFromJson(snapshotJson) != BookUpdateResult::Applied) return false;
+
+    const FeatureConfig& config = engine.configuration();
+    size_t mismatches = 0;
+    double engineNs = 0.0, recomputeNs = 0.0;
+    for (size_t u = 0; u < updates; ++u) {
+        if (book.updateFromJson(generator.next()) != BookUpdateResult::Applied) return false;
+        SnapshotHandle snap = book.snapshot();
+        BookFeatures f = engine.latest();
+        if (f.version != snap->version) ++mismatches;
+
+        double bid = snap->bids.front().price, ask = snap->asks.front().price;
+        double bidQty = snap->bids.front().quantity, askQty = snap->asks.front().quantity;
+        double mid = (bid + ask) / 2.0;
+        if (!near(f.mid, mid) || !near(f.spread, ask - bid) ||
+            !near(f.microprice, (bid * askQty + ask * bidQty) / (bidQty + askQty)))
+            ++mismatches;
+        for (size_t i = 0; i < FeatureConfig::kDepthBands; ++i) {
+            if (!near(f.bidDepthWithin[i], notionalWithinBps(snap->bids, mid, config.depthBandsBps[i])) ||
+                !near(f.askDepthWithin[i], notionalWithinBps(snap->asks, mid, config.depthBandsBps[i])))
+                ++mismatches;
+        }
+
+        // Cost of one update each way on this book
+        auto start = Clock::now();
+        engine.onPublish(*snap);
+        auto mid1 = Clock::now();
+        double scratch = imbalance(*snap, BookFeatures::kFlowLevels);
+        for (size_t i = 0; i < FeatureConfig::kDepthBands; ++i)
+            scratch += notionalWithinBps(snap->bids, mid, config.depthBandsBps[i]) +
+                       notionalWithinBps(snap->asks, mid, config.depthBandsBps[i]);
+        auto end = Clock::now();
+        sink = scratch;
+        engineNs += std::chrono::duration<double, std::nano>(mid1 - start).count();
+        recomputeNs += std::chrono::duration<double, std::nano>(end - mid1).count();
+    }
+    SnapshotHandle snap = book.snapshot();
+    std::printf("recompute check: %zu updates on a %zu/%zu-level book, %zu mismatches\n", updates,
+                snap->bids.size(), snap->asks.size(), mismatches);
+    std::printf("per update: engine %.0f ns, depth bands and imbalance walked from scratch %.0f ns\n",
+                engineNs / updates, recomputeNs / updates);
+    return mismatches == 0;
+}
+
+// Two levels a side with the given top
+OrderBookSnapshot topBook(double bid, double bidQty, double ask, double askQty, Clock::time_point when) {
+    return makeBook({{bid, bidQty}, {bid - 1.0, 5.0}}, {{ask, askQty}, {ask + 1.0, 5.0}}, when);
+}
+
+// Scripted queue changes with known flow; no decay so the sums are exact
+bool checkOrderFlow() {
+    FeatureConfig config;
+    config.flowHalfLife = 1e300;
+    FeatureEngine engine(config);
+    Clock::time_point t;
+    engine.onPublish(topBook(100.0, 1.0, 101.0, 1.0, t));
+    engine.onPublish(topBook(100.0, 3.0, 101.0, 1.0, t));   // +2 joins the bid
+    double joined = engine.latest().orderFlowImbalance[0];
+    engine.onPublish(topBook(100.0, 3.0, 100.5, 4.0, t));   // new better ask of 4
+    double undercut = engine.latest().orderFlowImbalance[0] - joined;
+    engine.onPublish(topBook(99.5, 2.0, 100.5, 4.0, t));    // bid of 3 taken out, next bid 2
+    double swept = engine.latest().orderFlowImbalance[0] - joined - undercut;
+    std::printf("order flow: join %+.1f, undercut %+.1f, bid swept %+.1f\n", joined, undercut, swept);
+    return joined == 2.0 && undercut == -4.0 && swept == -3.0;
+}
+
+// Mid follows a log random walk at a known annual volatility, one book every 100 ms
+bool checkVolatility() {
+    const double annual = 0.8;
+    const double stepSeconds = 0.1;
+    const double perStep = annual * std::sqrt(stepSeconds / (365.0 * 24.0 * 3600.0));
+    FeatureEngine engine;
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> normal;
+    double mid = 60000.0;
+    Clock::time_point t;
+    TradeConfig config;
+    config.realizedVolatility = true;
+    bool fallback = true;  // configured value until enough returns
+    for (int i = 0; i < 20000; ++i) {
+        mid *= std::exp(perStep * normal(rng));
+        engine.onPublish(topBook(mid - 0.5, 1.0, mid + 0.5, 1.0, t));
+        t += std::chrono::milliseconds(100);
+        if (i < 50 && effectiveVolatility(config, engine.latest()) != config.volatility) fallback = false;
+    }
+    BookFeatures f = engine.latest();
+    std::printf("volatility: realized %.3f vs %.3f annual (%.3f vs %.3f bps per update) after %llu returns\n",
+                f.volatility, annual, f.returnVolatilityBps, perStep * 1e4,
+                static_cast<unsigned long long>(f.returns));
+    return fallback && std::fabs(f.volatility / annual - 1.0) < 0.1 &&
+           std::fabs(f.returnVolatilityBps / (perStep * 1e4) - 1.0) < 0.1 &&
+           effectiveVolatility(config, f) == f.volatility;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : TRADESIM_FIXTURE_DIR;
+    Logger::instance().setLevel(LogLevel::Error);
+    bool ok = true;
+    if (!checkAgainstRecompute(loadFixture(dir, "okx_books_snapshot.json"), 100000)) {
+        std::fprintf(stderr, "FAIL: incremental features differ from a recompute\n");
+        ok = false;
+    }
+    if (!checkOrderFlow()) {
+        std::fprintf(stderr, "FAIL: order-flow imbalance of scripted changes is wrong\n");
+        ok = false;
+    }
+    if (!checkVolatility()) {
+        std::fprintf(stderr, "FAIL: realized volatility misses the simulated path\n");
+        ok = false;
+    }
+    Logger::instance().flush();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Enforces that the steady-state feed path never touches the heap: parse,
+// apply, publish, and the reader calls the UI makes per frame. Replaces the
+// global operator new with a counting one, warms every buffer up, then fails
+// (exit code 1) if a further pass allocates. Build with the
+// feed_allocation_check target; pass the fixture directory as argv[1] to override.
+#include "benchUtil.h"
+#include "datafeed.h"
+#include "okxParser.h"
+#include "orderbook.h"
+#include "syntheticFeed.h"
+#include "tradeSim.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocations{0};
+
+void* countedAlloc(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+volatile double sink = 0.0;
+
+std::vector<std::string> makeDeltas(const BookMessage& snapshot, size_t count) {
+    SyntheticDeltas generator(snapshot);
+    std::vector<std::string> deltas;
+    for (size_t i = 0; i < count; ++i) deltas.push_back(generator.next());
+    return deltas;
+}
+
+// One full resync plus a run of deltas, with the reader calls that follow each message
+bool runCycle(Orderbook& book, BookMessage& message, const std::string& snapshot,
+              const std::vector<std::string>& deltas, std::vector<std::pair<double, double>>& levels) {
+    if (book.updateFromJson(snapshot) != BookUpdateResult::Applied) return false;
+    for (const auto& delta : deltas) {
+        if (parseOkxBookMessage(delta, message) != BookParseStatus::Book) return false;
+        if (book.apply(message) != BookUpdateResult::Applied) return false;
+
+        SnapshotHandle snap = book.snapshot();
+        if (!snap) return false;
+        TradeResult result = simulateMarketOrder(*snap, Side::Buy, 1.5, 1, std::chrono::steady_clock::now());
+        book.getBidLevels(levels, 10);
+        book.getAskLevels(levels, 10);
+        SnapshotHandle dummy = getCurrentOrderBookSnapshot();
+        sink = result.averagePrice + book.getTopOfBook().bidPrice + levels.front().first + dummy->version;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : TRADESIM_FIXTURE_DIR;
+    std::string snapshot = loadFixture(dir, "okx_books_snapshot.json");
+
+    BookMessage message;
+    if (parseOkxBookMessage(snapshot, message) != BookParseStatus::Book) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json in %s\n", dir.c_str());
+        return 1;
+    }
+    std::vector<std::string> deltas = makeDeltas(message, 512);
+
+    Orderbook book;
+    std::vector<std::pair<double, double>> levels;
+
+    // Warm-up: grows parser buffers, pool slots and the caller's level buffer
+    for (int i = 0; i < 3; ++i) {
+        if (!runCycle(book, message, snapshot, deltas, levels)) {
+            std::fprintf(stderr, "feed sequence failed to apply\n");
+            return 1;
+        }
+    }
+
+    const int kCycles = 20;
+    allocations = 0;
+    counting = true;
+    bool ok = true;
+    for (int i = 0; i < kCycles && ok; ++i) ok = runCycle(book, message, snapshot, deltas, levels);
+    counting = false;
+
+    size_t messages = kCycles * (deltas.size() + 1);
+    if (!ok) {
+        std::fprintf(stderr, "feed sequence failed to apply\n");
+        return 1;
+    }
+    std::printf("%zu messages   %zu heap allocations\n", messages, allocations.load());
+    if (allocations != 0) {
+        std::fprintf(stderr, "FAIL: steady-state feed path allocated\n");
+        return 1;
+    }
+    std::printf("OK: zero-allocation steady state\n");
+    return 0;
+}
@@ -0,0 +1,182 @@
+// Feed path under load: runs a FeedServer and a WebSocketClient in one
+// process over loopback and measures
+//   1. throughput: the server streams as fast as the client drains;
+//   2. latency at a fixed rate: server send -> book published on the client
+//      (matched per seqId), plus the client's own stage histograms;
+//   3. fault recovery: drops, gaps, bad checksums and disconnects, then
+//      checks the client resyncs and ends up in step with the server.
+// Fails if a clean run needs a resync or the client never recovers.
+// Build with the feed_load_bench target.
+// Usage: feed_load_bench [seconds per phase] [first port] [rate for phase 2]
+#include "feedServer.h"
+#include "latency.h"
+#include "logger.h"
+#include "orderbook.h"
+#include "webSocketClient.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Phase {
+    const char* name;
+    double rate;
+    FeedFaults faults;
+};
+
+struct PhaseResult {
+    bool connected = false;
+    bool recovered = true;
+    uint64_t applied = 0;
+    uint64_t resyncs = 0;
+    double seconds = 0.0;
+    FeedServerStats server;
+};
+
+void printStage(const char* name, const LatencySummary& s) {
+    std::printf("  %-22s p50 %8.2f  p99 %8.2f  p99.9 %8.2f  max %9.2f us  (%llu)\n", name, s.p50Ns / 1000.0,
+                s.p99Ns / 1000.0, s.p999Ns / 1000.0, s.maxNs / 1000.0, static_cast<unsigned long long>(s.count));
+}
+
+LatencySummary summarize(const LatencyHistogram& h) {
+    LatencySummary s;
+    s.count = h.count();
+    s.p50Ns = h.percentile(0.50);
+    s.p99Ns = h.percentile(0.99);
+    s.p999Ns = h.percentile(0.999);
+    s.maxNs = h.max();
+    return s;
+}
+
+bool waitFor(const Orderbook& book, double seconds) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (book.isSynced()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// Synced and still applying updates (a stale book left by a dropped
+// connection stays "synced" but stops advancing)
+bool waitForLiveUpdates(const Orderbook& book, double seconds) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    uint64_t from = book.getVersion();
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (book.isSynced() && book.getVersion() >= from + 100) return true;
+        if (!book.isSynced()) from = book.getVersion();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+PhaseResult runPhase(const Phase& phase, int port, double seconds) {
+    PhaseResult result;
+    FeedServerConfig config;
+    config.port = port;
+    config.rate = phase.rate;
+    FeedServer server(config);
+    if (!server.start()) return result;
+
+    Orderbook book;
+    WebSocketClient client("ws://127.0.0.1:" + std::to_string(port), book);
+    client.start();
+    result.connected = waitFor(book, 5.0);
+    if (!result.connected) return result;
+
+    latencyStats().reset();
+    server.setFaults(phase.faults);
+
+    // Samples wire-to-book latency off the top of book while the feed runs
+    LatencyHistogram wireToBook;
+    std::atomic<bool> sampling{true};
+    std::thread sampler([&] {
+        uint64_t lastVersion = 0;
+        while (sampling.load(std::memory_order_relaxed)) {
+            TopOfBook top = book.getTopOfBook();
+            if (top.version != lastVersion) {
+                lastVersion = top.version;
+                if (int64_t sentNs = server.sendTimeNs(0, top.seqId)) wireToBook.record(top.timestampNs - sentNs);
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    uint64_t resyncsBefore = client.resyncCount();
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.applied = latencyStats().summary(LatencyStage::FeedTotal).count;
+    result.resyncs = client.resyncCount() - resyncsBefore;
+    result.server = server.stats();
+
+    // Faults off; the client must get back in sync (a reconnect waits 2 s)
+    server.setFaults(FeedFaults());
+    result.recovered = waitForLiveUpdates(book, 10.0);
+
+    sampling = false;
+    sampler.join();
+    client.stop();
+    server.stop();
+
+    std::printf("%s: %.0f msg/s applied over %.1f s, %llu resyncs\n", phase.name, result.applied / result.seconds,
+                result.seconds, static_cast<unsigned long long>(result.resyncs));
+    if (result.server.dropped || result.server.gaps || result.server.corrupted || result.server.disconnects)
+        std::printf("  injected: %llu dropped, %llu gaps, %llu corrupted, %llu disconnects\n",
+                    static_cast<unsigned long long>(result.server.dropped),
+                    static_cast<unsigned long long>(result.server.gaps),
+                    static_cast<unsigned long long>(result.server.corrupted),
+                    static_cast<unsigned long long>(result.server.disconnects));
+    printStage("server send -> book", summarize(wireToBook));
+    for (LatencyStage stage : {LatencyStage::Parse, LatencyStage::Apply, LatencyStage::Publish,
+                               LatencyStage::FeedTotal})
+        printStage(latencyStageName(stage), latencyStats().summary(stage));
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    int port = argc > 2 ? std::atoi(argv[2]) : 18765;
+    double rate = argc > 3 ? std::atof(argv[3]) : 10000.0;
+    Logger::instance().setLevel(LogLevel::Error);  // resync warnings are expected in phase 3
+
+    FeedFaults faults;
+    faults.drop = 1e-3;
+    faults.gap = 1e-3;
+    faults.corrupt = 1e-3;
+    faults.disconnect = 1e-4;
+    const Phase phases[] = {
+        {"saturated", 0.0, FeedFaults()},
+        {"fixed rate", rate, FeedFaults()},
+        {"faults", rate, faults},
+    };
+
+    bool ok = true;
+    for (size_t i = 0; i < 3; ++i) {
+        PhaseResult result = runPhase(phases[i], port + static_cast<int>(i), seconds);
+        bool clean = i < 2;
+        if (!result.connected) {
+            std::fprintf(stderr, "FAIL: %s: client never synced with the server\n", phases[i].name);
+            ok = false;
+        } else if (clean && result.resyncs) {
+            std::fprintf(stderr, "FAIL: %s: %llu resyncs without injected faults\n", phases[i].name,
+                         static_cast<unsigned long long>(result.resyncs));
+            ok = false;
+        } else if (!clean && (!result.resyncs || !result.recovered)) {
+            std::fprintf(stderr, "FAIL: %s: client %s\n", phases[i].name,
+                         result.resyncs ? "did not recover" : "never noticed the faults");
+            ok = false;
+        } else if (!result.applied) {
+            std::fprintf(stderr, "FAIL: %s: no updates applied\n", phases[i].name);
+            ok = false;
+        }
+    }
+    Logger::instance().flush();
+    return ok ? 0 : 1;
+}
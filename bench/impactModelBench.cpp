@@ -0,0 +1,148 @@
+// Almgren-Chriss impact model: accuracy of the cached urgency grid against
+// the closed form, over random sizes, horizons and parameters, and the cost
+// of a query either way. Exits non-zero if
+//   - interpolated cost, risk or schedule drift past kTolerance of exact;
+//   - with no risk aversion the schedule is not the straight line, or the
+//     temporary cost differs from eta~ X^2 / T;
+//   - a schedule fails to start at the size, end at zero, or ever buy back.
+// Also prints the estimate for the fixture book. Build with the
+// impact_model_bench target.
+// Usage: impact_model_bench [queries]
+#include "benchUtil.h"
+#include "models/impact.h"
+#include "orderbook.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double kTolerance = 1e-6;  // relative
+
+struct Case {
+    ImpactParameters params;
+    double quantity;
+    double duration;
+};
+
+double relative(double a, double b) {
+    double scale = std::max(std::fabs(a), std::fabs(b));
+    return scale > 0.0 ? std::fabs(a - b) / scale : 0.0;
+}
+
+std::vector<Case> randomCases(size_t count) {
+    std::mt19937_64 rng(7);
+    auto logUniform = [&](double lo, double hi) {
+        return std::exp(std::uniform_real_distribution<double>(std::log(lo), std::log(hi))(rng));
+    };
+    std::vector<Case> cases(count);
+    for (Case& c : cases) {
+        c.params.sigma = logUniform(0.1, 50.0);
+        c.params.epsilon = logUniform(0.01, 5.0);
+        c.params.eta = logUniform(1e-2, 1e3);
+        c.params.gamma = logUniform(1e-3, 10.0);
+        c.params.riskAversion = logUniform(1e-9, 1e-2);
+        c.quantity = logUniform(1e-3, 100.0);
+        c.duration = logUniform(1.0, 3600.0);
+    }
+    return cases;
+}
+
+bool wellFormed(const ExecutionTrajectory& t, double quantity) {
+    if (t.holdings.size() < 2 || t.holdings.front() != quantity || std::fabs(t.holdings.back()) > 1e-12 * quantity)
+        return false;
+    for (size_t j = 1; j < t.holdings.size(); ++j)
+        if (t.holdings[j] > t.holdings[j - 1]) return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    bool ok = true;
+
+    auto built = std::chrono::steady_clock::now();
+    MarketImpactModel model;
+    double buildUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - built).count();
+
+    std::vector<Case> cases = randomCases(count);
+    double worstCost = 0.0, worstVariance = 0.0, worstHolding = 0.0;
+    size_t malformed = 0;
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const Case& c = cases[i];
+        ImpactEstimate fast = model.estimate(c.params, c.quantity, c.duration);
+        ImpactEstimate exact = model.exactEstimate(c.params, c.quantity, c.duration);
+        worstCost = std::max(worstCost, relative(fast.expectedCost, exact.expectedCost));
+        worstVariance = std::max(worstVariance, relative(fast.variance, exact.variance));
+        if (i % 16 != 0) continue;  // schedules are longer; sample them
+        ExecutionTrajectory path = model.trajectory(c.params, c.quantity, c.duration);
+        ExecutionTrajectory exactPath = model.exactTrajectory(c.params, c.quantity, c.duration);
+        for (size_t j = 0; j < path.holdings.size(); ++j)
+            worstHolding = std::max(worstHolding, std::fabs(path.holdings[j] - exactPath.holdings[j]) / c.quantity);
+        malformed += !wellFormed(path, c.quantity) || !wellFormed(exactPath, c.quantity);
+    }
+    std::printf("%zu queries, grid built in %.0f us\n", count, buildUs);
+    std::printf("worst relative error vs closed form: cost %.2e  variance %.2e  holdings %.2e\n", worstCost,
+                worstVariance, worstHolding);
+    if (worstCost > kTolerance || worstVariance > kTolerance || worstHolding > kTolerance) {
+        std::fprintf(stderr, "FAIL: interpolation error above %.0e\n", kTolerance);
+        ok = false;
+    }
+    if (malformed) {
+        std::fprintf(stderr, "FAIL: %zu schedules do not run monotonically from the size to zero\n", malformed);
+        ok = false;
+    }
+
+    // Risk neutral: TWAP, and the temporary cost has a closed form
+    {
+        ImpactParameters p = cases.front().params;
+        p.riskAversion = 0.0;
+        double x = 3.0, t = 120.0;
+        ImpactEstimate e = model.estimate(p, x, t);
+        double tau = t / model.intervals();
+        double etaTilde = std::max(p.eta - 0.5 * p.gamma * tau, 0.5 * p.eta);
+        ExecutionTrajectory path = model.trajectory(p, x, t);
+        bool straight = path.holdings.size() == model.intervals() + 1;
+        for (size_t j = 0; straight && j < path.holdings.size(); ++j)
+            straight = std::fabs(path.holdings[j] - x * (1.0 - double(j) / model.intervals())) < 1e-12;
+        if (!straight || relative(e.temporaryCost, etaTilde * x * x / t) > 1e-12) {
+            std::fprintf(stderr, "FAIL: risk-neutral schedule is not the straight line\n");
+            ok = false;
+        }
+    }
+
+    // Per-query cost, grid vs closed form
+    double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Case& c : cases) sink += model.estimate(c.params, c.quantity, c.duration).expectedCost;
+    auto mid = std::chrono::steady_clock::now();
+    for (const Case& c : cases) sink += model.exactEstimate(c.params, c.quantity, c.duration).expectedCost;
+    auto end = std::chrono::steady_clock::now();
+    double gridNs = std::chrono::duration<double, std::nano>(mid - start).count() / count;
+    double exactNs = std::chrono::duration<double, std::nano>(end - mid).count() / count;
+    std::printf("estimate: %.1f ns/query cached, %.1f ns/query closed form (checksum %.3g)\n", gridNs, exactNs,
+                sink);
+
+    Orderbook orderbook;
+    if (orderbook.updateFromJson(loadFixture("okx_books_snapshot.json")) == BookUpdateResult::Applied) {
+        SnapshotHandle book = orderbook.snapshot();
+        ImpactParameters p = calibrateImpact(*book);
+        std::printf("fixture book: sigma %.4f/sqrt(s)  epsilon %.4f  eta %.4g  gamma %.4g\n", p.sigma, p.epsilon,
+                    p.eta, p.gamma);
+        for (double horizon : {1.0, 60.0, 600.0}) {
+            ImpactEstimate e = model.estimate(p, 5.0, horizon);
+            std::printf("  5 BTC over %5.0f s: cost %10.4f (spread %.4f, temporary %.4f, permanent %.4f)  "
+                        "sd %.4f  urgency %.3g\n",
+                        horizon, e.expectedCost, e.spreadCost, e.temporaryCost, e.permanentCost,
+                        std::sqrt(e.variance), e.urgency);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Scalar vs AVX2 book kernels at depths of 5, 50 and 400 levels. Also checks
+// that both kernel tables agree to within rounding (exactly, for the
+// ticks-to-doubles conversion). Build with kernel_bench.
+#include "bookKernels.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+volatile double sink = 0.0;
+
+template <typename Fn>
+double nsPerCall(Fn&& fn) {
+    // Size the run so each measurement takes a few milliseconds
+    size_t iterations = 1000;
+    for (;;) {
+        auto start = std::chrono::steady_clock::now();
+        double acc = 0.0;
+        for (size_t i = 0; i < iterations; ++i) acc += fn();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        sink = acc;
+        if (ns > 5e6 || iterations > (1u << 26)) return ns / iterations;
+        iterations *= 4;
+    }
+}
+
+bool close(double a, double b) {
+    return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+} // namespace
+
+int main() {
+    const BookKernels& scalar = scalarBookKernels();
+    const BookKernels* simd = avx2BookKernels();
+    std::printf("dispatch selects: %s\n", bookKernels().name);
+    if (!simd) std::printf("AVX2 not available on this CPU/build; timing scalar only\n");
+
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> size(0.001, 5.0);
+    bool mismatch = false;
+
+    for (size_t depth : {5u, 50u, 400u}) {
+        std::vector<double> prices(depth), quantities(depth), cumQty(depth), cumNotional(depth);
+        for (size_t i = 0; i < depth; ++i) {
+            prices[i] = 60000.0 + 0.1 * i;
+            quantities[i] = size(rng);
+        }
+        const double* p = prices.data();
+        const double* q = quantities.data();
+        double total = scalar.sumQuantity(q, depth);
+        double mid = 60000.0 - 0.05;
+
+        struct Case {
+            const char* name;
+            double (*run)(const BookKernels&, const double*, const double*, size_t, double, double,
+                          double*, double*);
+        };
+        const Case cases[] = {
+            {"prefix sums", [](const BookKernels& k, const double* p, const double* q, size_t n, double, double,
+                               double* cq, double* cn) { k.prefixSums(p, q, n, 0.0, 0.0, cq, cn); return cn[n - 1]; }},
+            {"fill half depth", [](const BookKernels& k, const double* p, const double* q, size_t n, double total, double,
+                                   double*, double*) { double f; return k.fill(p, q, n, total / 2, &f); }},
+            {"total liquidity", [](const BookKernels& k, const double*, const double* q, size_t n, double, double,
+                                   double*, double*) { return k.sumQuantity(q, n); }},
+            {"vwap", [](const BookKernels& k, const double* p, const double* q, size_t n, double, double,
+                        double*, double*) { return k.sumNotional(p, q, n) / k.sumQuantity(q, n); }},
+            {"notional within 10bps", [](const BookKernels& k, const double* p, const double* q, size_t n, double, double mid,
+                                         double*, double*) { return k.notionalInRange(p, q, n, mid * 0.999, mid * 1.001); }},
+        };
+
+        std::printf("\ndepth %zu\n", depth);
+        for (const Case& c : cases) {
+            double scalarValue = c.run(scalar, p, q, depth, total, mid, cumQty.data(), cumNotional.data());
+            double scalarNs = nsPerCall([&] { return c.run(scalar, p, q, depth, total, mid, cumQty.data(), cumNotional.data()); });
+            if (!simd) {
+                std::printf("  %-22s scalar %8.1f ns\n", c.name, scalarNs);
+                continue;
+            }
+            double simdValue = c.run(*simd, p, q, depth, total, mid, cumQty.data(), cumNotional.data());
+            double simdNs = nsPerCall([&] { return c.run(*simd, p, q, depth, total, mid, cumQty.data(), cumNotional.data()); });
+            bool ok = close(scalarValue, simdValue);
+            mismatch |= !ok;
+            std::printf("  %-22s scalar %8.1f ns   avx2 %8.1f ns   x%.2f%s\n", c.name, scalarNs, simdNs,
+                        scalarNs / simdNs, ok ? "" : "   MISMATCH");
+        }
+
+        // Publishing turns ladder ticks into doubles; the tables must agree exactly
+        std::vector<int64_t> units(depth);
+        std::vector<double> scalarOut(depth), simdOut(depth);
+        for (size_t i = 0; i < depth; ++i) units[i] = 600000 + static_cast<int64_t>(i) * 7;
+        if (depth > 3) units[3] = int64_t(1) << 60;  // outside the fast range
+        auto convert = [&](const BookKernels& k, std::vector<double>& out) {
+            k.unitsToDoubles(units.data(), depth, 5, 100.0, out.data());
+            return out[depth - 1];
+        };
+        double scalarNs = nsPerCall([&] { return convert(scalar, scalarOut); });
+        if (!simd) {
+            std::printf("  %-22s scalar %8.1f ns\n", "ticks to doubles", scalarNs);
+            continue;
+        }
+        double simdNs = nsPerCall([&] { return convert(*simd, simdOut); });
+        bool ok = scalarOut == simdOut;
+        mismatch |= !ok;
+        std::printf("  %-22s scalar %8.1f ns   avx2 %8.1f ns   x%.2f%s\n", "ticks to doubles", scalarNs, simdNs,
+                    scalarNs / simdNs, ok ? "" : "   MISMATCH");
+    }
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+// Caller-side cost of a burst of warnings (the shape of a parse-error storm):
+// the async logger vs the synchronous stream writes it replaced. Output goes
+// to a scratch file so terminal speed does not skew the comparison. Build
+// with the logger_bench target.
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+struct Percentiles {
+    double p50, p99, max;
+};
+
+template <typename Fn>
+Percentiles measureBurst(size_t count, Fn&& logOne) {
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        logOne(i);
+        samples[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+    return {samples[count / 2], samples[count * 99 / 100], samples.back()};
+}
+
+void report(const char* name, const Percentiles& p) {
+    std::printf("%-22s p50 %8.0f ns   p99 %8.0f ns   max %10.0f ns\n", name, p.p50, p.p99, p.max);
+}
+
+} // namespace
+
+int main() {
+    const size_t kBurst = 20000;
+    const char* path = "logger_bench.log";
+
+    std::ofstream sync(path);
+    report("synchronous stream", measureBurst(kBurst, [&](size_t i) {
+        sync << "[Orderbook] Checksum mismatch: expected " << 1033051379 << ", computed " << i << std::endl;
+    }));
+    sync.close();
+
+    Logger& logger = Logger::instance();
+    logger.openFile(path);
+    report("async (drop policy)", measureBurst(kBurst, [](size_t i) {
+        LOG_WARN("Orderbook", "Checksum mismatch: expected {}, computed {}", 1033051379, i);
+    }));
+    logger.flush();
+
+    logger.setOverflowPolicy(LogOverflowPolicy::Block);
+    report("async (block policy)", measureBurst(kBurst, [](size_t i) {
+        LOG_WARN("Orderbook", "Checksum mismatch: expected {}, computed {}", 1033051379, i);
+    }));
+    logger.flush();
+    std::printf("dropped under drop policy: %llu\n", static_cast<unsigned long long>(logger.droppedCount()));
+    std::remove(path);
+    return 0;
+}
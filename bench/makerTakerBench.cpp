@@ -0,0 +1,217 @@
+// Online logistic maker/taker model. Exits non-zero if
+//   - FTRL does not recover the weights of a known logistic model;
+//   - batch scoring differs from one-at-a-time scoring;
+//   - a reader ever sees weights go backwards while the trainer runs;
+//   - on a synthetic book where imbalance drives the next move, the trained
+//     maker model does not beat the base rate.
+// Also times batch scoring, training steps and the per-update observer cost.
+// Build with the maker_taker_bench target.
+// Usage: maker_taker_bench [rows]
+#include "models/makerTaker.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nsPer(Clock::time_point start, Clock::time_point end, size_t count) {
+    return std::chrono::duration<double, std::nano>(end - start).count() / count;
+}
+
+double binaryEntropy(double p) {
+    return p <= 0.0 || p >= 1.0 ? 0.0 : -(p * std::log(p) + (1.0 - p) * std::log(1.0 - p));
+}
+
+// Streams samples of a known model and compares the learned weights
+bool checkRecovery() {
+    const double bias = -0.3;
+    const double truth[LogisticWeights::kFeatures] = {0.8, -1.2, 0.5, 0.0};
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> normal;
+    std::uniform_real_distribution<double> uniform;
+
+    LogisticRegression model;
+    auto start = Clock::now();
+    const size_t samples = 400000;
+    for (size_t i = 0; i < samples; ++i) {
+        FeatureVector x;
+        double z = bias;
+        for (size_t k = 0; k < x.size(); ++k) {
+            x[k] = normal(rng);
+            z += truth[k] * x[k];
+        }
+        model.update(x, uniform(rng) < LogisticRegression::sigmoid(z));
+    }
+    double updateNs = nsPer(start, Clock::now(), samples);
+
+    LogisticWeights w = model.weights();
+    double worst = std::fabs(w.bias - bias);
+    for (size_t k = 0; k < LogisticWeights::kFeatures; ++k) worst = std::max(worst, std::fabs(w.w[k] - truth[k]));
+    std::printf("recovery: bias %.3f  w %.3f %.3f %.3f %.3f  worst error %.3f  (%.1f ns/update)\n", w.bias, w.w[0],
+                w.w[1], w.w[2], w.w[3], worst, updateNs);
+    return worst < 0.05;
+}
+
+bool checkBatch(size_t rows) {
+    LogisticRegression model;
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> normal;
+    for (int i = 0; i < 1000; ++i) {
+        FeatureVector x;
+        for (double& v : x) v = normal(rng);
+        model.update(x, x[0] + x[1] > 0.0);
+    }
+
+    std::vector<double> columns[LogisticWeights::kFeatures];
+    FeatureColumns view;
+    for (size_t k = 0; k < LogisticWeights::kFeatures; ++k) {
+        columns[k].resize(rows);
+        for (double& v : columns[k]) v = normal(rng);
+        view[k] = columns[k].data();
+    }
+    std::vector<double> batch(rows), single(rows);
+
+    auto start = Clock::now();
+    model.predictBatch(view, rows, batch.data());
+    auto mid = Clock::now();
+    for (size_t i = 0; i < rows; ++i) {
+        FeatureVector x;
+        for (size_t k = 0; k < x.size(); ++k) x[k] = columns[k][i];
+        single[i] = model.predictProbability(x);
+    }
+    auto end = Clock::now();
+
+    double worst = 0.0;
+    for (size_t i = 0; i < rows; ++i) worst = std::max(worst, std::fabs(batch[i] - single[i]));
+    std::printf("scoring %zu rows: batch %.2f ns/row, one at a time %.2f ns/row, max difference %.1e\n", rows,
+                nsPer(start, mid, rows), nsPer(mid, end, rows), worst);
+    return worst < 1e-12;
+}
+
+// Trainer publishes as fast as it can while readers predict
+bool checkConcurrentReads() {
+    LogisticRegression model;
+    std::atomic<bool> stop{false};
+    std::atomic<bool> backwards{false};
+    std::atomic<uint64_t> reads{0};
+
+    auto reader = [&] {
+        uint64_t seen = 0, count = 0;
+        FeatureVector x = {0.1, -0.2, 0.3, 0.0};
+        while (!stop.load(std::memory_order_relaxed)) {
+            LogisticWeights w = model.weights();
+            if (w.examples < seen) backwards = true;
+            seen = w.examples;
+            double p = model.predictProbability(x);
+            if (!(p > 0.0 && p < 1.0)) backwards = true;
+            ++count;
+        }
+        reads += count;
+    };
+    std::thread readers[] = {std::thread(reader), std::thread(reader)};
+
+    std::mt19937_64 rng(5);
+    std::normal_distribution<double> normal;
+    auto start = Clock::now();
+    size_t updates = 0;
+    while (Clock::now() - start < std::chrono::milliseconds(200)) {
+        FeatureVector x;
+        for (double& v : x) v = normal(rng);
+        model.update(x, x[2] > 0.0);
+        ++updates;
+    }
+    auto end = Clock::now();
+    stop = true;
+    for (std::thread& t : readers) t.join();
+    std::printf("concurrent: %zu updates (%.1f ns each) alongside %llu reader predictions\n", updates,
+                nsPer(start, end, updates), static_cast<unsigned long long>(reads.load()));
+    return !backwards.load();
+}
+
+// One-tick-wide random-walk book whose next move follows the top-level
+// imbalance: heavy bids push the price up, so a resting bid tends to be left
+// behind and a resting ask to be lifted
+bool checkBookStream() {
+    MakerTakerModel model;
+    std::mt19937_64 rng(21);
+    std::uniform_real_distribution<double> uniform;
+    const double tick = 0.1;
+    double bid = 60000.0;
+    OrderBookSnapshot book;
+
+    const size_t updates = 200000;
+    double trainingNs = 0.0;
+    double loss = 0.0, makerRate = 0.0;
+    size_t scored = 0;
+    for (size_t u = 0; u < updates; ++u) {
+        book.bids.clear();
+        book.asks.clear();
+        double bidWeight = 0.2 + 1.6 * uniform(rng);  // x the ask side's size
+        for (int i = 0; i < 10; ++i) {
+            book.bids.push_back({bid - i * tick, bidWeight * (1.0 + uniform(rng))});
+            book.asks.push_back({bid + (1 + i) * tick, 1.0 + uniform(rng)});
+        }
+        indexSnapshot(book);
+
+        auto start = Clock::now();
+        model.onPublish(book);
+        trainingNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        double imbalance = (bidWeight - 1.0) / (bidWeight + 1.0);
+        double up = 0.5 + 0.4 * imbalance;
+        bid += (uniform(rng) < up ? 1 : -1) * tick;
+
+        // Out of sample: this book's features against its next move; the
+        // model only learns the label at the next update
+        if (u > updates / 2) {
+            double p = model.predict(Side::Buy);
+            bool filled = bid < book.bids.front().price;  // next touch traded through the bid
+            loss -= std::log(filled ? p : 1.0 - p);
+            makerRate += filled;
+            ++scored;
+        }
+    }
+    loss /= scored;
+    makerRate /= scored;
+    double baseline = binaryEntropy(makerRate);
+    LogisticWeights w = model.model().weights();
+    std::printf("book stream: %llu filled / %llu missed, %.0f ns per update\n",
+                static_cast<unsigned long long>(model.filledCount()),
+                static_cast<unsigned long long>(model.missedCount()), trainingNs / updates);
+    std::printf("  weights: bias %.3f spread %.3f imbalance %.3f depth %.3f volatility %.3f\n", w.bias, w.w[0],
+                w.w[1], w.w[2], w.w[3]);
+    std::printf("  next-update log loss %.4f vs base rate %.4f (maker rate %.3f)\n", loss, baseline, makerRate);
+    return model.filledCount() > 0 && model.missedCount() > 0 && w.w[1] < 0.0 && loss < baseline;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    bool ok = true;
+    if (!checkRecovery()) {
+        std::fprintf(stderr, "FAIL: FTRL did not recover the generating weights\n");
+        ok = false;
+    }
+    if (!checkBatch(rows)) {
+        std::fprintf(stderr, "FAIL: batch scores differ from single scores\n");
+        ok = false;
+    }
+    if (!checkConcurrentReads()) {
+        std::fprintf(stderr, "FAIL: a reader saw torn or stale-after-newer weights\n");
+        ok = false;
+    }
+    if (!checkBookStream()) {
+        std::fprintf(stderr, "FAIL: the maker model learned nothing from the book stream\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+// Simulated limit/post-only/IOC/market matching. Exits non-zero if a
+// scripted book sequence gives the wrong
+//   - taker sweep (levels taken, average price, limit respected);
+//   - post-only rejection or IOC cancellation;
+//   - queue position after growth and decreases, or maker fill when the
+//     queue ahead is traded through or the book crosses a resting order;
+//   - cancel and id reuse behaviour.
+// Then times order entry and book updates with thousands of orders resting
+// against the fixture book plus synthetic deltas. Build with the
+// matching_engine_bench target; pass the fixture directory as argv[1] to
+// override.
+// Usage: matching_engine_bench [fixtures] [updates]
+#include "benchUtil.h"
+#include "logger.h"
+#include "matchingEngine.h"
+#include "syntheticFeed.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+MatchingConfig scriptedConfig(double frontShare) {
+    MatchingConfig config;
+    config.spec = InstrumentSpec(0.5, 0.5);
+    config.frontShare = frontShare;
+    return config;
+}
+
+bool checkTakerAndTypes() {
+    MatchingEngine engine(scriptedConfig(0.5));
+    Clock::time_point t;
+    engine.onPublish(makeBook({{99.5, 3.0}, {99.0, 4.0}}, {{100.0, 1.0}, {100.5, 2.0}, {101.0, 5.0}}, t));
+    std::vector<SimFill> fills;
+    bool ok = true;
+
+    // Limit through two levels, remainder rests at the limit
+    OrderId id = engine.submit({Side::Buy, OrderType::Limit, 100.5, 4.0, 1});
+    engine.drainFills(fills);
+    ok &= expect(id != 0 && fills.size() == 1 && !fills[0].maker && near(fills[0].quantity, 3.0) &&
+                     near(fills[0].price, (100.0 + 2 * 100.5) / 3.0) && near(engine.remaining(id), 1.0),
+                 "limit sweep up to its price with the rest resting");
+
+    // The book still shows what it swept: no maker fill until that clears
+    engine.onPublish(makeBook({{99.5, 3.0}}, {{100.0, 1.0}, {100.5, 2.0}}, t + std::chrono::seconds(1)));
+    ok &= expect(engine.isResting(id), "swept liquidity still in the book fills the resting remainder");
+    engine.onPublish(makeBook({{99.5, 3.0}}, {{101.0, 5.0}}, t + std::chrono::seconds(2)));
+    engine.onPublish(makeBook({{99.5, 3.0}}, {{100.5, 1.0}}, t + std::chrono::seconds(5)));
+    engine.drainFills(fills);
+    ok &= expect(!engine.isResting(id) && fills.size() == 1 && fills[0].maker && fills[0].complete &&
+                     near(fills[0].price, 100.5) && fills[0].sinceSubmitNs == 5000000000LL,
+                 "a book crossing a resting bid fills it as maker at its price");
+
+    // Post-only: rejected when it would take, rests otherwise
+    engine.onPublish(makeBook({{99.5, 3.0}, {99.0, 4.0}}, {{100.0, 1.0}, {100.5, 2.0}}, t));
+    uint64_t rejected = engine.stats().rejected;
+    ok &= expect(engine.submit({Side::Buy, OrderType::PostOnly, 100.0, 1.0, 2}) == 0 &&
+                     engine.stats().rejected == rejected + 1,
+                 "crossing post-only is rejected");
+    id = engine.submit({Side::Buy, OrderType::PostOnly, 99.5, 1.0, 3});
+    ok &= expect(id != 0 && near(engine.queueAhead(id), 3.0), "passive post-only rests behind the level");
+
+    // IOC: takes what is there up to its price, cancels the rest
+    uint64_t canceled = engine.stats().canceled;
+    ok &= expect(engine.submit({Side::Buy, OrderType::ImmediateOrCancel, 100.0, 2.0, 4}) == 0 &&
+                     engine.stats().canceled == canceled + 1,
+                 "IOC remainder is canceled");
+    engine.drainFills(fills);
+    ok &= expect(fills.size() == 1 && near(fills[0].quantity, 1.0) && !fills[0].complete, "IOC fills one level");
+
+    // Market sell through both bid levels
+    engine.submit({Side::Sell, OrderType::Market, 0.0, 5.0, 5});
+    engine.drainFills(fills);
+    ok &= expect(fills.size() == 1 && fills[0].complete && near(fills[0].price, (3 * 99.5 + 2 * 99.0) / 5.0),
+                 "market order sweeps the bids");
+
+    // Cancel, stale ids, node reuse
+    ok &= expect(engine.cancel(id) && !engine.cancel(id) && !engine.isResting(id), "cancel once only");
+    OrderId reused = engine.submit({Side::Buy, OrderType::Limit, 99.5, 1.0, 6});
+    ok &= expect(reused != 0 && reused != id && engine.restingOrders() == 1 && !engine.cancel(id),
+                 "a reused node gets a new id");
+    return ok;
+}
+
+bool checkQueue() {
+    bool ok = true;
+    Clock::time_point t;
+    std::vector<SimFill> fills;
+    {
+        // Every decrease comes off the front
+        MatchingEngine engine(scriptedConfig(1.0));
+        engine.onPublish(makeBook({{99.5, 3.0}}, {{100.0, 2.0}}, t));
+        OrderId id = engine.submit({Side::Buy, OrderType::Limit, 99.5, 1.0, 1});
+        engine.onPublish(makeBook({{99.5, 1.0}}, {{100.0, 2.0}}, t));
+        ok &= expect(near(engine.queueAhead(id), 1.0), "a decrease moves the order up");
+        engine.onPublish(makeBook({{99.5, 4.0}}, {{100.0, 2.0}}, t));
+        ok &= expect(near(engine.queueAhead(id), 1.0), "growth joins behind the order");
+        engine.onPublish(makeBook({{99.5, 1.5}}, {{100.0, 2.0}}, t + std::chrono::milliseconds(3)));
+        engine.drainFills(fills);
+        ok &= expect(!engine.isResting(id) && fills.size() == 1 && fills[0].maker && near(fills[0].quantity, 1.0) &&
+                         fills[0].sinceSubmitNs == 3000000,
+                     "trading through the queue ahead fills the order at the touch");
+    }
+    {
+        // Away from the touch decreases are cancels: the order reaches the front, no further
+        MatchingEngine engine(scriptedConfig(1.0));
+        engine.onPublish(makeBook({{99.5, 3.0}, {99.0, 4.0}}, {{100.0, 2.0}}, t));
+        OrderId id = engine.submit({Side::Buy, OrderType::Limit, 99.0, 1.0, 1});
+        engine.onPublish(makeBook({{99.5, 3.0}, {99.0, 0.5}}, {{100.0, 2.0}}, t));
+        engine.onPublish(makeBook({{99.5, 3.0}}, {{100.0, 2.0}}, t));
+        engine.drainFills(fills);
+        ok &= expect(engine.isResting(id) && fills.empty() && near(engine.queueAhead(id), 0.0),
+                     "behind the touch the order reaches the front without filling");
+    }
+    {
+        // Half of each decrease is ahead; never more ahead than the level holds
+        MatchingEngine engine(scriptedConfig(0.5));
+        engine.onPublish(makeBook({{99.5, 4.0}}, {{100.0, 2.0}}, t));
+        OrderId id = engine.submit({Side::Buy, OrderType::Limit, 99.5, 1.0, 1});
+        engine.onPublish(makeBook({{99.5, 2.0}}, {{100.0, 2.0}}, t));
+        ok &= expect(near(engine.queueAhead(id), 2.0), "ahead capped at the level's size");
+        engine.onPublish(makeBook({{99.5, 6.0}}, {{100.0, 2.0}}, t));
+        engine.onPublish(makeBook({{99.5, 2.0}}, {{100.0, 2.0}}, t));
+        ok &= expect(near(engine.queueAhead(id), 0.0), "half of a decrease of 4 clears the 2 ahead");
+    }
+    {
+        // A reset book between two real ones leaves the queue alone
+        MatchingEngine engine(scriptedConfig(1.0));
+        engine.onPublish(makeBook({{99.5, 5.0}}, {{100.0, 2.0}}, t));
+        OrderId id = engine.submit({Side::Buy, OrderType::Limit, 99.5, 1.0, 1});
+        engine.onPublish(makeBook({}, {}, t));
+        engine.onPublish(makeBook({{99.5, 5.0}}, {{100.0, 2.0}}, t));
+        engine.onPublish(makeBook({{99.5, 4.0}}, {{100.0, 2.0}}, t));
+        engine.drainFills(fills);
+        ok &= expect(engine.isResting(id) && fills.empty() && near(engine.queueAhead(id), 4.0),
+                     "an empty book does not move resting orders to the front");
+    }
+    return ok;
+}
+
+// Thousands of orders resting near the touch of a real book while it moves
+bool measureThroughput(const std::string& snapshotJson, size_t updates) {
+    BookMessage message;
+    if (parseOkxBookMessage(snapshotJson, message) != BookParseStatus::Book) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json\n");
+        return false;
+    }
+    SyntheticDeltas generator(message);
+    std::vector<std::string> deltas;
+    for (size_t i = 0; i < updates; ++i) deltas.push_back(generator.next());
+
+    MatchingConfig config;
+    config.spec = InstrumentSpec(0.1, 1e-8);
+    MatchingEngine engine(config);
+    Orderbook book(400, 400, config.spec);
+    if (book.updateFromJson(snapshotJson) != BookUpdateResult::Applied) return false;
+
+    std::mt19937_64 rng(11);
+    std::vector<OrderId> live;
+    std::vector<SimFill> fills;
+    const size_t ordersPerUpdate = 20;
+    double orderSeconds = 0.0, bookSeconds = 0.0;
+    size_t orders = 0, peakResting = 0;
+    for (size_t u = 0; u < updates; ++u) {
+        if (book.updateFromJson(deltas[u]) != BookUpdateResult::Applied) return false;
+        SnapshotHandle snap = book.snapshot();
+        auto fed = Clock::now();
+        engine.onPublish(*snap);
+        auto updated = Clock::now();
+        bookSeconds += std::chrono::duration<double>(updated - fed).count();
+
+        // New orders within 20 ticks either side of the touch, and cancels
+        double bid = snap->bids.front().price, ask = snap->asks.front().price;
+        for (size_t i = 0; i < ordersPerUpdate; ++i) {
+            uint64_t r = rng();
+            Side side = r & 1 ? Side::Buy : Side::Sell;
+            double offset = 0.1 * static_cast<double>((r >> 8) % 40) - 0.5;
+            double price = side == Side::Buy ? bid - offset : ask + offset;
+            OrderType type = (r >> 16) % 10 < 6 ? OrderType::Limit
+                           : (r >> 16) % 10 < 8 ? OrderType::PostOnly
+                           : (r >> 16) % 10 < 9 ? OrderType::ImmediateOrCancel
+                                                : OrderType::Market;
+            OrderId id = engine.submit({side, type, price, 0.001 * (1 + (r >> 24) % 100), u});
+            if (id) live.push_back(id);
+            if (live.size() > 4000) {
+                size_t victim = (r >> 40) % live.size();
+                engine.cancel(live[victim]);
+                live[victim] = live.back();
+                live.pop_back();
+            }
+        }
+        orders += ordersPerUpdate;
+        engine.drainFills(fills);
+        peakResting = std::max(peakResting, engine.restingOrders());
+        orderSeconds += std::chrono::duration<double>(Clock::now() - updated).count();
+    }
+    const MatchingStats& s = engine.stats();
+    std::printf("throughput: %zu orders in %.3f s = %.2f M orders/s (submit, cancel, fills drained)\n", orders,
+                orderSeconds, orders / orderSeconds / 1e6);
+    std::printf("book updates: %.0f ns each with up to %zu orders resting on %zu levels\n",
+                bookSeconds / updates * 1e9, peakResting, engine.activeLevels());
+    std::printf("outcomes: %llu submitted, %llu filled in full (%llu after resting), %llu canceled, %llu rejected; "
+                "maker share %.3f, fees %.2f\n",
+                static_cast<unsigned long long>(s.submitted), static_cast<unsigned long long>(s.completed),
+                static_cast<unsigned long long>(s.restedFills), static_cast<unsigned long long>(s.canceled),
+                static_cast<unsigned long long>(s.rejected), s.makerTakerRatio(), s.fees);
+    return s.restedFills > 0 && s.makerQuantity > 0.0 && s.takerQuantity > 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : TRADESIM_FIXTURE_DIR;
+    size_t updates = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+    Logger::instance().setLevel(LogLevel::Error);
+    bool ok = checkTakerAndTypes();
+    ok &= checkQueue();
+    if (!measureThroughput(loadFixture(dir, "okx_books_snapshot.json"), updates)) {
+        std::fprintf(stderr, "FAIL: replayed orders never filled both ways\n");
+        ok = false;
+    }
+    Logger::instance().flush();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+// Monte Carlo cost engine: time for a run of N paths (default 100k) at
+// several thread counts against a one-frame (16.7 ms) budget, plus checks
+// that fail the run (exit 1):
+//   - Philox4x32-10 matches the published known-answer vectors;
+//   - results are bit-identical for every thread count;
+//   - with both volatilities at zero every path equals simulateMarketOrder;
+//   - CVaR >= VaR >= mean for the total cost.
+// Build with the monte_carlo_bench target.
+// Usage: monte_carlo_bench [paths] [max threads]
+#include "benchUtil.h"
+#include "monteCarlo.h"
+#include "orderbook.h"
+#include "philox.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr double kFrameMs = 1000.0 / 60.0;
+constexpr double kQuantity = 5.0;  // BTC; walks well into the fixture book
+
+bool checkPhilox() {
+    struct Vector {
+        uint64_t seed, stream, index;
+        uint32_t expected[4];
+    };
+    // Random123 kat_vectors for philox4x32_10, counter words packed as (index, stream)
+    const Vector vectors[] = {
+        {0, 0, 0, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+        {~0ull, ~0ull, ~0ull, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+        {0x299f31d0a4093822ull, 0x0370734413198a2eull, 0x85a308d3243f6a88ull,
+         {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+    };
+    for (const Vector& v : vectors) {
+        Philox4x32::Block b = Philox4x32(v.seed)(v.stream, v.index);
+        if (std::memcmp(b.v, v.expected, sizeof(b.v)) != 0) return false;
+    }
+    return true;
+}
+
+bool sameDistribution(const CostDistribution& a, const CostDistribution& b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+bool sameResult(const MonteCarloResult& a, const MonteCarloResult& b) {
+    return a.unfilledPaths == b.unfilledPaths && sameDistribution(a.slippage, b.slippage) &&
+           sameDistribution(a.fees, b.fees) && sameDistribution(a.totalCost, b.totalCost);
+}
+
+double bestOf(MonteCarloEngine& engine, const OrderBookSnapshot& book, const MonteCarloConfig& config,
+              MonteCarloResult& out, int runs) {
+    double best = 1e300;
+    for (int i = 0; i < runs; ++i) {
+        out = engine.run(book, Side::Buy, kQuantity, Okx::feeTier(1), config);
+        best = std::min(best, out.elapsedUs / 1000.0);
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t paths = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    size_t maxThreads = argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+                                 : std::max(4u, std::thread::hardware_concurrency());
+    bool ok = true;
+
+    if (!checkPhilox()) {
+        std::fprintf(stderr, "FAIL: Philox4x32-10 known-answer vectors\n");
+        ok = false;
+    }
+
+    Orderbook orderbook;
+    if (orderbook.updateFromJson(loadFixture("okx_books_snapshot.json")) != BookUpdateResult::Applied) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json in %s\n", TRADESIM_FIXTURE_DIR);
+        return 1;
+    }
+    SnapshotHandle book = orderbook.snapshot();
+
+    MonteCarloConfig config;
+    config.paths = paths;
+
+    // Degenerate model: every path is the plain market order
+    {
+        MonteCarloEngine engine(1);
+        MonteCarloConfig still = config;
+        still.volatility = 0.0;
+        still.depthVolatility = 0.0;
+        MonteCarloResult r = engine.run(*book, Side::Buy, kQuantity, Okx::feeTier(1), still);
+        TradeResult direct = simulateMarketOrder(*book, Side::Buy, kQuantity, Okx::feeTier(1),
+                                                 std::chrono::steady_clock::now());
+        double expected = direct.slippage * r.midPrice * direct.executedQuantity + direct.feesPaid;
+        // Paths are identical; the spread is only the rounding of the mean
+        double tolerance = 1e-9 * std::fabs(expected);
+        if (r.totalCost.stdDev > tolerance || std::fabs(r.totalCost.mean - expected) > tolerance) {
+            std::fprintf(stderr, "FAIL: zero volatility gives %.10f, market order costs %.10f\n", r.totalCost.mean,
+                         expected);
+            ok = false;
+        }
+    }
+
+    std::printf("%zu paths, %.1f BTC buy, %u hardware threads, budget %.1f ms\n", paths, kQuantity,
+                std::thread::hardware_concurrency(), kFrameMs);
+    std::printf("%8s %10s %10s\n", "threads", "ms", "paths/us");
+    MonteCarloResult reference;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        MonteCarloEngine engine(threads);
+        MonteCarloResult r;
+        double ms = bestOf(engine, *book, config, r, 5);
+        std::printf("%8zu %10.2f %10.1f%s\n", threads, ms, paths / (ms * 1000.0), ms < kFrameMs ? "" : "  over budget");
+        if (threads == 1) {
+            reference = r;
+        } else if (!sameResult(r, reference)) {
+            std::fprintf(stderr, "FAIL: %zu threads differ from 1 thread\n", threads);
+            ok = false;
+        }
+    }
+
+    const CostDistribution& t = reference.totalCost;
+    std::printf("mid %.2f  total cost: mean %.4f  sd %.4f  VaR%.0f %.4f  CVaR %.4f  (%zu unfilled)\n",
+                reference.midPrice, t.mean, t.stdDev, config.confidence * 100, t.var, t.cvar,
+                reference.unfilledPaths);
+    std::printf("slippage mean %.4f  VaR %.4f  CVaR %.4f | fees mean %.4f  VaR %.4f  CVaR %.4f\n",
+                reference.slippage.mean, reference.slippage.var, reference.slippage.cvar, reference.fees.mean,
+                reference.fees.var, reference.fees.cvar);
+    if (!(t.cvar >= t.var && t.var >= t.mean)) {
+        std::fprintf(stderr, "FAIL: expected CVaR >= VaR >= mean\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
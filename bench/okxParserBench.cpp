@@ -0,0 +1,86 @@
+// Compares the streaming OKX parser against the nlohmann DOM + std::stod path
+// Orderbook used before, on fixtures in bench/fixtures. Build with the
+// okx_parser_bench target; pass the fixture directory as argv[1] to override.
+#include "benchUtil.h"
+#include "okxParser.h"
+#include "orderbook.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+using json = nlohmann::json;
+
+volatile double sink = 0.0;
+
+// The pre-streaming path: build a DOM, then stod every price/size string
+double parseWithDom(const std::string& message) {
+    auto j = json::parse(message);
+    const auto& book = j["data"][0];
+    double sum = 0.0;
+    for (const char* side : {"bids", "asks"}) {
+        for (const auto& level : book[side]) {
+            sum += std::stod(level[0].get<std::string>());
+            sum += std::stod(level[1].get<std::string>());
+        }
+    }
+    return sum;
+}
+
+double parseStreaming(const std::string& message, BookMessage& out) {
+    parseOkxBookMessage(message, out);
+    double sum = 0.0;
+    for (const auto& l : out.bids) sum += l.price + l.quantity;
+    for (const auto& l : out.asks) sum += l.price + l.quantity;
+    return sum;
+}
+
+template <typename Fn>
+double nsPerMessage(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    double acc = 0.0;
+    for (size_t i = 0; i < iterations; ++i) acc += fn();
+    auto end = std::chrono::steady_clock::now();
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : TRADESIM_FIXTURE_DIR;
+    const char* fixtures[] = {
+        "okx_books_snapshot.json",
+        "okx_books_update.json",
+        "okx_books5.json",
+        "okx_bbo_tbt.json",
+    };
+
+    // Sanity check: the streaming path must apply and verify the captured sequence
+    Orderbook book;
+    if (book.updateFromJson(loadFixture(dir, "okx_books_snapshot.json")) != BookUpdateResult::Applied ||
+        book.updateFromJson(loadFixture(dir, "okx_books_update.json")) != BookUpdateResult::Applied) {
+        std::fprintf(stderr, "fixture sequence failed to apply (missing fixtures or checksum mismatch)\n");
+        return 1;
+    }
+
+    BookMessage message;
+    for (const char* name : fixtures) {
+        std::string payload = loadFixture(dir, name);
+        size_t iterations = payload.size() > 4096 ? 2000 : 200000;
+
+        if (std::abs(parseWithDom(payload) - parseStreaming(payload, message)) > 1e-6) {
+            std::fprintf(stderr, "%s: streaming parser disagrees with nlohmann\n", name);
+            return 1;
+        }
+
+        double domNs = nsPerMessage(iterations, [&] { return parseWithDom(payload); });
+        double streamNs = nsPerMessage(iterations, [&] { return parseStreaming(payload, message); });
+        std::printf("%-26s %6zu B   nlohmann+stod %10.1f ns   streaming %9.1f ns   x%.1f\n",
+                    name, payload.size(), domNs, streamNs, domNs / streamNs);
+    }
+    return 0;
+}
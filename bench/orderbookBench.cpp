@@ -0,0 +1,142 @@
+// Compares the PriceLadder book backend against the previous std::map backend
+// on 400-level OKX-style books. Build with the orderbook_bench target.
+#include "priceLadder.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t kDepth = 400;
+constexpr double kMid = 60000.0;
+constexpr double kTick = 0.1;
+
+struct Level {
+    double price;
+    double quantity;
+};
+
+// The std::map layout Orderbook used before the ladder
+struct MapBook {
+    std::map<double, double, std::greater<>> bids;
+    std::map<double, double> asks;
+
+    void apply(const std::vector<Level>& b, const std::vector<Level>& a) {
+        for (const auto& l : b) {
+            if (l.quantity > 0.0) bids[l.price] = l.quantity;
+            else bids.erase(l.price);
+        }
+        for (const auto& l : a) {
+            if (l.quantity > 0.0) asks[l.price] = l.quantity;
+            else asks.erase(l.price);
+        }
+    }
+    double best() const { return bids.begin()->first + asks.begin()->first; }
+    double topN(size_t n) const {
+        double sum = 0.0;
+        size_t i = 0;
+        for (auto it = asks.begin(); it != asks.end() && i < n; ++it, ++i) sum += it->second;
+        return sum;
+    }
+    double sweep(double qty) const {
+        double value = 0.0;
+        for (auto it = asks.begin(); it != asks.end() && qty > 0; ++it) {
+            double fill = std::min(qty, it->second);
+            value += fill * it->first;
+            qty -= fill;
+        }
+        return value;
+    }
+};
+
+struct LadderBook {
+    PriceLadder bids{LadderSide::Bid, kDepth};
+    PriceLadder asks{LadderSide::Ask, kDepth};
+
+    void apply(const std::vector<Level>& b, const std::vector<Level>& a) {
+        for (const auto& l : b) bids.set(l.price, l.quantity);
+        for (const auto& l : a) asks.set(l.price, l.quantity);
+    }
+    double best() const { return bids.bestPrice() + asks.bestPrice(); }
+    double topN(size_t n) const {
+        size_t end = std::min(n, asks.size());
+        double sum = 0.0;
+        for (size_t i = 0; i < end; ++i) sum += asks.quantityAt(i);
+        return sum;
+    }
+    double sweep(double qty) const {
+        double value = 0.0;
+        for (size_t i = 0; i < asks.size() && qty > 0; ++i) {
+            double fill = std::min(qty, asks.quantityAt(i));
+            value += fill * asks.priceAt(i);
+            qty -= fill;
+        }
+        return value;
+    }
+};
+
+volatile double sink = 0.0;
+
+double nsPerOp(size_t iterations, const std::function<double()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    double acc = 0.0;
+    for (size_t i = 0; i < iterations; ++i) acc += fn();
+    auto end = std::chrono::steady_clock::now();
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+void report(const char* name, double mapNs, double ladderNs) {
+    std::printf("%-28s map %10.1f ns   ladder %10.1f ns   x%.2f\n", name, mapNs, ladderNs, mapNs / ladderNs);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> size(0.001, 5.0);
+    std::uniform_int_distribution<int> nearTop(0, 49);
+
+    std::vector<Level> snapBids, snapAsks;
+    for (size_t i = 0; i < kDepth; ++i) {
+        snapBids.push_back({kMid - kTick * (i + 1), size(rng)});
+        snapAsks.push_back({kMid + kTick * (i + 1), size(rng)});
+    }
+
+    // Deltas: OKX sends a handful of changed levels per message, biased to the top
+    constexpr size_t kMessages = 4096;
+    std::vector<std::vector<Level>> deltaBids(kMessages), deltaAsks(kMessages);
+    for (size_t m = 0; m < kMessages; ++m) {
+        for (int k = 0; k < 4; ++k) {
+            double qty = (k == 3) ? 0.0 : size(rng);  // one delete per message
+            deltaBids[m].push_back({kMid - kTick * (nearTop(rng) + 1), qty});
+            deltaAsks[m].push_back({kMid + kTick * (nearTop(rng) + 1), qty});
+        }
+    }
+
+    MapBook mapBook;
+    LadderBook ladderBook;
+
+    report("snapshot rebuild (400x2)",
+           nsPerOp(2000, [&] { mapBook.bids.clear(); mapBook.asks.clear(); mapBook.apply(snapBids, snapAsks); return mapBook.best(); }),
+           nsPerOp(2000, [&] { ladderBook.bids.clear(); ladderBook.asks.clear(); ladderBook.apply(snapBids, snapAsks); return ladderBook.best(); }));
+
+    size_t mi = 0, li = 0;
+    report("delta apply (4+4 levels)",
+           nsPerOp(200000, [&] { size_t m = mi++ % kMessages; mapBook.apply(deltaBids[m], deltaAsks[m]); return mapBook.best(); }),
+           nsPerOp(200000, [&] { size_t m = li++ % kMessages; ladderBook.apply(deltaBids[m], deltaAsks[m]); return ladderBook.best(); }));
+
+    report("best bid + ask", nsPerOp(1000000, [&] { return mapBook.best(); }),
+           nsPerOp(1000000, [&] { return ladderBook.best(); }));
+    report("top-10 read", nsPerOp(1000000, [&] { return mapBook.topN(10); }),
+           nsPerOp(1000000, [&] { return ladderBook.topN(10); }));
+    report("top-400 read", nsPerOp(100000, [&] { return mapBook.topN(kDepth); }),
+           nsPerOp(100000, [&] { return ladderBook.topN(kDepth); }));
+    report("market sweep (200 BTC)", nsPerOp(100000, [&] { return mapBook.sweep(200.0); }),
+           nsPerOp(100000, [&] { return ladderBook.sweep(200.0); }));
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Record/replay round trip: writes a synthetic session (the fixture snapshot
+// followed by chained deltas) through FeedRecorder, then replays it as fast
+// as possible through ReplaySource into an Orderbook. Fails if any message is
+// lost or the book falls out of sync. Build with the replay_bench target.
+// Usage: replay_bench [messages] [fixture dir]
+#include "benchUtil.h"
+#include "feedRecording.h"
+#include "latency.h"
+#include "orderbook.h"
+#include "replaySource.h"
+#include "syntheticFeed.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+// Roughly a busy day of BTC-USDT "books" traffic
+constexpr size_t kDefaultMessages = 2000000;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : kDefaultMessages;
+    std::string dir = argc > 2 ? argv[2] : TRADESIM_FIXTURE_DIR;
+    const char* path = "replay_bench.tsfeed";
+
+    std::string snapshot = loadFixture(dir, "okx_books_snapshot.json");
+    BookMessage message;
+    if (parseOkxBookMessage(snapshot, message) != BookParseStatus::Book) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json in %s\n", dir.c_str());
+        return 1;
+    }
+
+    // Record, spacing messages 40 ms apart on the recorded clock
+    auto recordStart = std::chrono::steady_clock::now();
+    FeedRecorder recorder;
+    if (!recorder.open(path)) {
+        std::fprintf(stderr, "cannot create %s\n", path);
+        return 1;
+    }
+    int64_t receiveNs = latencyNow();
+    recorder.append(snapshot, receiveNs);
+    SyntheticDeltas deltas(message);
+    for (size_t i = 0; i < count; ++i) recorder.append(deltas.next(), receiveNs += 40000000);
+    recorder.close();
+    double recordSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - recordStart).count();
+
+    // Replay
+    Orderbook book;
+    ReplaySource replay(path, book);
+    if (!replay.isOpen()) return 1;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t applied = 0;
+    BookUpdateResult result;
+    while (replay.step(&result))
+        if (result == BookUpdateResult::Applied) ++applied;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::remove(path);
+
+    double recordedSeconds = (count * 40e-3);
+    std::printf("recorded %zu messages in %.2f s\n", count + 1, recordSeconds);
+    std::printf("replayed %llu messages in %.2f s: %.0f msg/s, %.0fx the recorded %.1f h\n",
+                static_cast<unsigned long long>(replay.messageCount()), seconds, replay.messageCount() / seconds,
+                recordedSeconds / seconds, recordedSeconds / 3600.0);
+
+    if (applied != count + 1 || replay.resyncCount() != 0 || !book.isSynced()) {
+        std::fprintf(stderr, "FAIL: %llu of %zu messages applied, %llu resyncs\n",
+                     static_cast<unsigned long long>(applied), count + 1,
+                     static_cast<unsigned long long>(replay.resyncCount()));
+        return 1;
+    }
+    return 0;
+}
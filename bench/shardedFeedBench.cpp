@@ -0,0 +1,138 @@
+// Aggregate feed throughput as the symbol count grows: pre-generated OKX
+// "books" traffic (one snapshot plus chained deltas per symbol) is pushed
+// through ShardedFeed::submit from one producer thread per connection, with
+// one shard and then several. Fails if any book misses an update or
+// resyncs. Build with the sharded_feed_bench target.
+// Usage: sharded_feed_bench [messages per run] [shards] [--pin]
+//   --pin pins shard i to CPU i + 1 (producers stay unpinned)
+#include "benchUtil.h"
+#include "bookRegistry.h"
+#include "shardedFeed.h"
+#include "syntheticFeed.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kDefaultMessages = 400000;
+constexpr size_t kConnections = 2;
+
+std::string symbolName(size_t i) {
+    return "SYM" + std::to_string(i) + "-USDT";
+}
+
+std::string replaceAll(std::string text, const std::string& from, const std::string& to) {
+    for (size_t at = text.find(from); at != std::string::npos; at = text.find(from, at + to.size()))
+        text.replace(at, from.size(), to);
+    return text;
+}
+
+struct RunResult {
+    double messagesPerSecond = 0.0;
+    bool ok = false;
+};
+
+RunResult run(const std::string& snapshot, size_t symbols, size_t shardCount, size_t messages, bool pin) {
+    BookRegistry registry;
+    for (size_t i = 0; i < symbols; ++i) registry.add({"OKX", symbolName(i)});
+
+    ShardedFeedConfig config;
+    config.url.clear();  // fed through submit()
+    config.shards = shardCount;
+    config.symbolsPerConnection = (symbols + kConnections - 1) / kConnections;
+    if (pin)
+        for (size_t s = 0; s < shardCount; ++s) config.shardCpus.push_back(static_cast<int>(s + 1));
+    ShardedFeed feed(registry, config);
+
+    // Each connection carries the block of symbols the feed assigned to it:
+    // their snapshots first, then deltas round-robin over them
+    BookMessage parsed;
+    parseOkxBookMessage(snapshot, parsed);
+    std::vector<std::vector<std::string>> traffic(feed.connectionCount());
+    std::vector<size_t> perSymbol(symbols, 0);
+    size_t deltas = messages > symbols ? messages - symbols : 0;
+    for (size_t c = 0; c < traffic.size(); ++c) {
+        std::vector<SyntheticDeltas> generators;
+        std::vector<size_t> owned;
+        size_t end = std::min(symbols, (c + 1) * config.symbolsPerConnection);
+        for (size_t i = c * config.symbolsPerConnection; i < end; ++i) {
+            owned.push_back(i);
+            traffic[c].push_back(replaceAll(snapshot, "BTC-USDT", symbolName(i)));
+            generators.emplace_back(parsed, static_cast<uint32_t>(i + 1), symbolName(i));
+        }
+        size_t share = deltas / traffic.size() + (c < deltas % traffic.size() ? 1 : 0);
+        for (size_t k = 0; k < share; ++k) {
+            size_t g = k % owned.size();
+            traffic[c].push_back(generators[g].next());
+            ++perSymbol[owned[g]];
+        }
+    }
+    size_t total = 0;
+    for (const auto& t : traffic) total += t.size();
+
+    feed.start();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t c = 0; c < traffic.size(); ++c)
+        producers.emplace_back([&, c] {
+            for (const std::string& message : traffic[c]) feed.submit(c, message, latencyNow());
+        });
+    for (auto& producer : producers) producer.join();
+    while (feed.messageCount() < total) std::this_thread::yield();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    feed.stop();
+
+    RunResult result;
+    result.messagesPerSecond = total / seconds;
+    result.ok = feed.resyncCount() == 0;
+    for (size_t i = 0; i < symbols; ++i) {
+        const Orderbook& book = registry.bookAt(i);
+        // One publication for the snapshot and one per delta
+        if (!book.isSynced() || book.getVersion() != perSymbol[i] + 1) {
+            std::fprintf(stderr, "FAIL: %s at version %llu, expected %zu\n", symbolName(i).c_str(),
+                         static_cast<unsigned long long>(book.getVersion()), perSymbol[i] + 1);
+            result.ok = false;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t messages = kDefaultMessages;
+    size_t shards = std::max<size_t>(2, std::min<size_t>(4, std::thread::hardware_concurrency() / 2));
+    bool pin = false;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pin") == 0) pin = true;
+        else if (positional++ == 0) messages = std::strtoull(argv[i], nullptr, 10);
+        else shards = std::strtoull(argv[i], nullptr, 10);
+    }
+
+    std::string snapshot = loadFixture("okx_books_snapshot.json");
+    BookMessage parsed;
+    if (parseOkxBookMessage(snapshot, parsed) != BookParseStatus::Book) {
+        std::fprintf(stderr, "missing or unreadable okx_books_snapshot.json in %s\n", TRADESIM_FIXTURE_DIR);
+        return 1;
+    }
+
+    std::printf("%zu messages per run, %zu producer connections, %u hardware threads%s\n", messages, kConnections,
+                std::thread::hardware_concurrency(), pin ? ", shards pinned" : "");
+    std::printf("%8s %14s %14s %8s\n", "symbols", "1 shard msg/s", "sharded msg/s", "speedup");
+    bool ok = true;
+    for (size_t symbols : {1, 4, 16, 64, 256}) {
+        RunResult single = run(snapshot, symbols, 1, messages, pin);
+        RunResult sharded = run(snapshot, symbols, shards, messages, pin);
+        ok = ok && single.ok && sharded.ok;
+        std::printf("%8zu %14.0f %14.0f %7.2fx  (%zu shards)\n", symbols, single.messagesPerSecond,
+                    sharded.messagesPerSecond, sharded.messagesPerSecond / single.messagesPerSecond, shards);
+    }
+    return ok ? 0 : 1;
+}
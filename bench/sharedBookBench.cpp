@@ -0,0 +1,198 @@
+// Shared-memory book publication. Exits non-zero if
+//   - a SharedBookReader in this process reads back anything but the book
+//     just published;
+//   - a reader in a second process (this program re-run with --reader) ever
+//     sees a torn book, or sees none at all.
+// Every published book is a function of its version, so a reader can check
+// each copy on its own. Also times publication and reads in-process, and the
+// cross-process delay from publication to a reader holding the copy.
+// Build with the shared_book_bench target.
+// Usage: shared_book_bench [updates]
+//        shared_book_bench --reader NAME UPDATES   (started by the above)
+#include "logger.h"
+#include "sharedBookPublisher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kLevels = 50;
+
+volatile double sink = 0.0;
+
+double nsSince(Clock::time_point start, size_t count) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+}
+
+// Level counts and every price and quantity of a book follow from its version
+size_t bidCount(uint64_t version) { return 1 + version % kLevels; }
+size_t askCount(uint64_t version) { return 1 + (version * 7) % kLevels; }
+double bidPrice(uint64_t version, size_t k) { return 60000.0 + static_cast<double>(version % 1000) - 0.5 * k; }
+double askPrice(uint64_t version, size_t k) { return 60001.0 + static_cast<double>(version % 1000) + 0.5 * k; }
+double quantityAt(uint64_t version, size_t k) { return static_cast<double>(version) + 0.25 * k; }
+
+void makeBook(uint64_t version, size_t depth, OrderBookSnapshot& book) {
+    book.bids.clear();
+    book.asks.clear();
+    for (size_t k = 0; k < std::min(depth, bidCount(version)); ++k)
+        book.bids.push_back({bidPrice(version, k), quantityAt(version, k)});
+    for (size_t k = 0; k < std::min(depth, askCount(version)); ++k)
+        book.asks.push_back({askPrice(version, k), quantityAt(version, k)});
+    book.version = version;
+}
+
+bool consistent(const SharedDepth& d) {
+    if (d.bids.size() != bidCount(d.version) || d.asks.size() != askCount(d.version)) return false;
+    for (size_t k = 0; k < d.bids.size(); ++k)
+        if (d.bids.prices[k] != bidPrice(d.version, k) || d.bids.quantities[k] != quantityAt(d.version, k))
+            return false;
+    for (size_t k = 0; k < d.asks.size(); ++k)
+        if (d.asks.prices[k] != askPrice(d.version, k) || d.asks.quantities[k] != quantityAt(d.version, k))
+            return false;
+    return true;
+}
+
+bool consistent(const SharedTopOfBook& t) {
+    return t.bidPrice == bidPrice(t.version, 0) && t.askPrice == askPrice(t.version, 0) &&
+           t.bidQuantity == quantityAt(t.version, 0) && t.askQuantity == quantityAt(t.version, 0);
+}
+
+double percentile(std::vector<double>& sorted, double q) {
+    return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()))];
+}
+
+// Second process: follows the book until the last version or the writer closes
+int runReader(const std::string& name, uint64_t updates) {
+    SharedBookReader reader;
+    auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (!reader.open(name)) {
+        if (Clock::now() > deadline) {
+            std::fprintf(stderr, "reader: cannot open %s\n", name.c_str());
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    SharedDepth depth;
+    SharedTopOfBook top;
+    std::vector<double> delaysNs;
+    delaysNs.reserve(updates);
+    size_t torn = 0;
+    uint64_t lastSequence = reader.sequence();
+    deadline = Clock::now() + std::chrono::seconds(60);
+    while (depth.version < updates && Clock::now() < deadline) {
+        uint64_t sequence = reader.sequence();
+        if (sequence == lastSequence) {
+            if (reader.writerClosed()) break;
+            std::this_thread::yield();  // leave the core to the writer on small machines
+            continue;
+        }
+        lastSequence = sequence;
+        if (!reader.read(depth)) continue;
+        int64_t nowNs =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+        delaysNs.push_back(static_cast<double>(nowNs - depth.timestampNs));
+        if (!consistent(depth)) ++torn;
+        if (reader.top(top) && !consistent(top)) ++torn;
+    }
+    std::sort(delaysNs.begin(), delaysNs.end());
+    std::printf("cross-process: %zu of %llu books seen, %zu torn; publication to copy p50 %.1f us, "
+                "p99 %.1f us, max %.1f us\n",
+                delaysNs.size(), static_cast<unsigned long long>(updates), torn, percentile(delaysNs, 0.5) / 1000.0,
+                percentile(delaysNs, 0.99) / 1000.0, delaysNs.empty() ? 0.0 : delaysNs.back() / 1000.0);
+    return torn == 0 && !delaysNs.empty() ? 0 : 1;
+}
+
+// Same process, no contention: what one publication and one read cost
+bool checkInProcess(const std::string& symbol) {
+    SharedBookPublisher publisher("bench", symbol, InstrumentSpec(0.5, 0.25), kLevels);
+    SharedBookReader reader;
+    if (!publisher.isOpen() || !reader.open(publisher.name())) {
+        std::fprintf(stderr, "cannot create or open %s\n", publisher.name().c_str());
+        return false;
+    }
+    SharedTopOfBook top;
+    SharedDepth depth;
+    if (reader.top(top) || reader.read(depth)) {
+        std::fprintf(stderr, "FAIL: a book was read before any was published\n");
+        return false;
+    }
+
+    const size_t rounds = 200000;
+    std::vector<OrderBookSnapshot> books(64);
+    for (size_t i = 0; i < books.size(); ++i) makeBook(kLevels - 1 + i * kLevels, 400, books[i]);  // full depth
+    auto start = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) publisher.onPublish(books[i % books.size()]);
+    double publishNs = nsSince(start, rounds);
+
+    bool ok = true;
+    for (const OrderBookSnapshot& book : books) {
+        publisher.onPublish(book);
+        ok = ok && reader.read(depth) && reader.top(top) && depth.version == book.version && consistent(depth) &&
+             top.version == book.version && consistent(top);
+    }
+    start = Clock::now();
+    double sum = 0.0;
+    for (size_t i = 0; i < rounds; ++i) sum += static_cast<double>(reader.sequence());
+    double pollNs = nsSince(start, rounds);
+    start = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) sum += reader.top(top) ? top.bidPrice : 0.0;
+    double topNs = nsSince(start, rounds);
+    start = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) sum += reader.read(depth, 10) ? depth.bids.prices[9] : 0.0;
+    double depth10Ns = nsSince(start, rounds);
+    start = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) sum += reader.read(depth) ? depth.asks.prices.back() : 0.0;
+    double depthAllNs = nsSince(start, rounds);
+    sink = sum;
+    std::printf("in-process: publish %.0f ns (%zu levels per side); read sequence %.1f ns, top of book %.1f ns, "
+                "10 levels %.0f ns, %zu levels %.0f ns\n",
+                publishNs, kLevels, pollNs, topNs, depth10Ns, kLevels, depthAllNs);
+    std::fflush(stdout);  // before the reader process writes its line
+    if (!ok) std::fprintf(stderr, "FAIL: in-process read differs from the book published\n");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Logger::instance().setLevel(LogLevel::Error);
+    if (argc > 3 && std::string(argv[1]) == "--reader")
+        return runReader(argv[2], std::strtoull(argv[3], nullptr, 10));
+
+    uint64_t updates = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    // Per-run symbol, so concurrent runs do not share a region
+    std::string symbol = "run" + std::to_string(Clock::now().time_since_epoch().count());
+    bool ok = checkInProcess(symbol + "a");
+
+    {
+        SharedBookPublisher publisher("bench", symbol, InstrumentSpec(0.5, 0.25), kLevels);
+        if (!publisher.isOpen()) return 1;
+        std::string command = "\"" + std::string(argv[0]) + "\" --reader " + publisher.name() + " " +
+                              std::to_string(updates);
+        int readerStatus = 0;
+        std::thread readerProcess([&] { readerStatus = std::system(command.c_str()); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));  // let the reader map the region
+
+        OrderBookSnapshot book;
+        for (uint64_t version = 1; version <= updates; ++version) {
+            makeBook(version, kLevels, book);
+            book.timestamp = Clock::now();
+            publisher.onPublish(book);
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        readerProcess.join();
+        if (readerStatus != 0) {
+            std::fprintf(stderr, "FAIL: the reader process saw a torn book or none at all\n");
+            ok = false;
+        }
+    }
+    Logger::instance().flush();
+    return ok ? 0 : 1;
+}
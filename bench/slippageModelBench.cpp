@@ -0,0 +1,145 @@
+// Streaming slippage quantile model on a synthetic book stream whose
+// liquidity, spread and volatility drift. After a training stretch, every
+// further update checks predictions for random order sizes against
+// simulateMarketOrder on the same book (the model's validation mode).
+// Exits non-zero if the 10/50/90% bands do not cover their share of actual
+// fills to within kCoverageTolerance, if orders far inside the top level do
+// not cost the half spread, or if orders past the visible depth are not
+// extrapolated upwards. Also times training and predictions against the
+// book walk. Build with the slippage_model_bench target.
+// Usage: slippage_model_bench [updates]
+#include "logger.h"
+#include "models/slippage.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kCoverageTolerance = 0.05;
+// Validation sizes, as fractions of the visible side. Smaller orders often
+// fill inside the top level at exactly the half spread, a point mass that
+// coverage cannot score; they are checked separately
+constexpr double kSmallestChecked = 0.02;
+constexpr double kLargestChecked = 0.9;
+constexpr size_t kLevels = 50;
+
+// Random-walk book; level sizes are lognormal around a depth that wanders
+// between regimes
+class BookStream {
+public:
+    explicit BookStream(uint64_t seed) : rng(seed) {}
+
+    void next(OrderBookSnapshot& book) {
+        std::normal_distribution<double> normal;
+        std::uniform_real_distribution<double> uniform;
+        if (uniform(rng) < 0.001) depth = std::exp(std::log(2.0) * (2.0 * uniform(rng) - 1.0));
+        if (uniform(rng) < 0.001) stepTicks = 1 + static_cast<int>(uniform(rng) * 4);
+        mid += stepTicks * tick * (uniform(rng) < 0.5 ? -1 : 1) * (uniform(rng) < 0.3);
+        int spreadTicks = 1 + static_cast<int>(uniform(rng) * uniform(rng) * 4);
+
+        book.bids.clear();
+        book.asks.clear();
+        double bestBid = std::round(mid / tick) * tick;
+        for (size_t i = 0; i < kLevels; ++i) {
+            double growth = 1.0 + 0.05 * i;  // thicker away from the touch
+            book.bids.push_back({bestBid - i * tick, depth * growth * std::exp(0.8 * normal(rng))});
+            book.asks.push_back({bestBid + (spreadTicks + i) * tick, depth * growth * std::exp(0.8 * normal(rng))});
+        }
+        indexSnapshot(book);
+    }
+
+private:
+    std::mt19937_64 rng;
+    double mid = 60000.0;
+    double tick = 0.5;
+    double depth = 1.0;  // BTC at the touch
+    int stepTicks = 1;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t updates = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    Logger::instance().setLevel(LogLevel::Error);
+    bool ok = true;
+
+    SlippageModel model;
+    BookStream stream(17);
+    OrderBookSnapshot book;
+    double trainNs = 0.0;
+    for (size_t u = 0; u < updates; ++u) {
+        stream.next(book);
+        auto start = Clock::now();
+        model.onPublish(book);
+        trainNs += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+    std::printf("trained on %zu updates (%llu fills), %.0f ns per update\n", updates,
+                static_cast<unsigned long long>(model.sampleCount()), trainNs / updates);
+
+    // Validation: predict from this book, then walk it
+    std::mt19937_64 rng(99);
+    std::uniform_real_distribution<double> uniform;
+    SlippageValidation validation;
+    double predictNs = 0.0, walkNs = 0.0;
+    const size_t checks = updates / 4;
+    for (size_t u = 0; u < checks; ++u) {
+        stream.next(book);
+        model.onPublish(book);
+        double sideUsd = book.askDepth.totalNotional();
+        double usd = sideUsd * kSmallestChecked * std::pow(kLargestChecked / kSmallestChecked, uniform(rng));
+
+        auto start = Clock::now();
+        SlippageBand band = model.quantiles(usd, Side::Buy);
+        auto mid = Clock::now();
+        SlippageCheck check = model.validate(book, Side::Buy, usd);
+        auto end = Clock::now();
+        predictNs += std::chrono::duration<double, std::nano>(mid - start).count();
+        walkNs += std::chrono::duration<double, std::nano>(end - mid).count();
+        if (band.median != check.predicted.median) ok = false;  // same book, same weights
+        validation.add(check);
+    }
+    std::printf("validation over %llu orders: actual below p10 %.3f, p50 %.3f, p90 %.3f; "
+                "mean |actual - median| %.3f bps\n",
+                static_cast<unsigned long long>(validation.count()), validation.belowLow(),
+                validation.belowMedian(), validation.belowHigh(), validation.meanAbsErrorBps());
+    std::printf("per order: model %.1f ns, validation (predict + book walk) %.1f ns\n", predictNs / checks,
+                walkNs / checks);
+    if (!ok) std::fprintf(stderr, "FAIL: validation predicted differently from quantiles() on the same book\n");
+
+    const double targets[3] = {0.1, 0.5, 0.9};
+    const double observed[3] = {validation.belowLow(), validation.belowMedian(), validation.belowHigh()};
+    for (int i = 0; i < 3; ++i) {
+        if (std::fabs(observed[i] - targets[i]) > kCoverageTolerance) {
+            std::fprintf(stderr, "FAIL: %.0f%% quantile covers %.3f of fills\n", targets[i] * 100, observed[i]);
+            ok = false;
+        }
+    }
+
+    // Far inside the top level: the half spread
+    double sideUsd = book.askDepth.totalNotional();
+    double halfSpreadBps = (book.asks.front().price - book.bids.front().price) / 2.0 /
+                           ((book.asks.front().price + book.bids.front().price) / 2.0) * 1e4;
+    SlippageBand tiny = model.quantiles(sideUsd * 1e-5, Side::Buy);
+    std::printf("tiny order: median %.4f bps, half spread %.4f bps\n", tiny.median, halfSpreadBps);
+    if (std::fabs(tiny.median - halfSpreadBps) > 0.01) {
+        std::fprintf(stderr, "FAIL: small orders do not cost the half spread\n");
+        ok = false;
+    }
+
+    // Beyond the visible side: flagged, and no cheaper than the deepest fill
+    SlippageBand inside = model.quantiles(sideUsd * 0.9, Side::Buy);
+    SlippageBand beyond = model.quantiles(sideUsd * 2.0, Side::Buy);
+    std::printf("90%% of visible asks: median %.2f bps [%.2f, %.2f]; 2x visible (extrapolated): %.2f bps\n",
+                inside.median, inside.low, inside.high, beyond.median);
+    if (!beyond.beyondDepth || beyond.median < inside.median) {
+        std::fprintf(stderr, "FAIL: orders past the visible depth are not extrapolated upwards\n");
+        ok = false;
+    }
+    Logger::instance().flush();
+    return ok ? 0 : 1;
+}
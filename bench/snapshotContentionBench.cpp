@@ -0,0 +1,137 @@
+// Contention stress test for Orderbook's lock-free read path: one writer
+// applies full-book updates while N reader threads pin snapshots and read the
+// top of book. Every update stamps all levels with the same quantity, so a
+// torn read shows up as mixed quantities. Also checks the versions observers
+// see while readers pin every slot. Exits non-zero on any violation.
+// Usage: snapshot_contention_bench [readers] [seconds]
+#include "orderbook.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kLevels = 50;
+
+struct RunResult {
+    double writerUpdatesPerSec;
+    double readsPerSec;
+    uint64_t violations;
+};
+
+RunResult run(int readerCount, double seconds) {
+    Orderbook book(kLevels, kLevels);
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> violations{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r] {
+            uint64_t localReads = 0, localBad = 0, lastVersion = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (r % 2 == 0) {
+                    SnapshotHandle snap = book.snapshot();
+                    if (!snap) continue;
+                    if (snap->version < lastVersion) ++localBad;
+                    lastVersion = snap->version;
+                    double q = snap->bids.empty() ? 0.0 : snap->bids.quantities[0];
+                    for (double v : snap->bids.quantities) localBad += v != q;
+                    for (double v : snap->asks.quantities) localBad += v != q;
+                } else {
+                    TopOfBook top = book.getTopOfBook();
+                    localBad += top.bidQuantity != top.askQuantity;
+                    if (top.version < lastVersion) ++localBad;
+                    lastVersion = top.version;
+                }
+                ++localReads;
+            }
+            reads += localReads;
+            violations += localBad;
+        });
+    }
+
+    BookMessage message;
+    message.action = "snapshot";
+    for (size_t i = 0; i < kLevels; ++i) {
+        message.bids.push_back({60000.0 - 0.1 * (i + 1), 0.0, {}, {}});
+        message.asks.push_back({60000.0 + 0.1 * (i + 1), 0.0, {}, {}});
+    }
+
+    uint64_t updates = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < deadline) {
+        double q = static_cast<double>(++updates);
+        for (auto& l : message.bids) l.quantity = q;
+        for (auto& l : message.asks) l.quantity = q;
+        message.seqId = static_cast<int64_t>(updates);
+        if (book.apply(message) != BookUpdateResult::Applied) violations++;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    stop = true;
+    for (auto& t : readers) t.join();
+    return {updates / elapsed, reads / elapsed, violations.load()};
+}
+
+// Records the version of every snapshot observers are handed
+struct VersionLog : BookObserver {
+    std::vector<uint64_t> versions;
+    void onPublish(const OrderBookSnapshot& snapshot) override { versions.push_back(snapshot.version); }
+};
+
+// Pins every slot so updates reach only observers, then releases them: the
+// observer versions must keep increasing, and published ones skip theirs
+uint64_t checkPinnedSlots() {
+    Orderbook book(kLevels, kLevels);
+    VersionLog log;
+    book.addObserver(&log);
+
+    BookMessage message;
+    message.action = "snapshot";
+    message.bids.push_back({59999.9, 1.0, {}, {}});
+    message.asks.push_back({60000.1, 1.0, {}, {}});
+
+    std::vector<SnapshotHandle> pinned;
+    int64_t seq = 0;
+    while (book.unpublishedCount() < 2 && seq < 100) {
+        message.seqId = ++seq;
+        book.apply(message);
+        pinned.push_back(book.snapshot());
+    }
+    uint64_t pinnedVersion = book.getVersion();
+    pinned.clear();
+    message.seqId = ++seq;
+    book.apply(message);
+
+    uint64_t bad = book.unpublishedCount() < 2;
+    for (size_t i = 1; i < log.versions.size(); ++i) bad += log.versions[i] <= log.versions[i - 1];
+    SnapshotHandle snap = book.snapshot();
+    bad += !snap || snap->version != log.versions.back() || snap->version != pinnedVersion + 3;
+    return bad;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxReaders = argc > 1 ? std::atoi(argv[1]) : 4;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+
+    uint64_t totalViolations = checkPinnedSlots();
+    std::printf("pinned slots: observer versions %s\n", totalViolations ? "WRONG" : "ok");
+    int lastReaders = -1;
+    for (int readers : {0, 1, maxReaders / 2, maxReaders}) {
+        if (readers <= lastReaders) continue;
+        lastReaders = readers;
+        RunResult r = run(readers, seconds);
+        std::printf("readers %3d   writer %12.0f updates/s   readers %14.0f reads/s   violations %llu\n",
+                    readers, r.writerUpdatesPerSec, r.readsPerSec,
+                    static_cast<unsigned long long>(r.violations));
+        totalViolations += r.violations;
+    }
+    return totalViolations == 0 ? 0 : 1;
+}
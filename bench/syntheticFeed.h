@@ -0,0 +1,47 @@
+#pragma once
+
+// Synthetic OKX "books" deltas for benches: size changes, deletions and new
+// levels around the top of a real snapshot, chained by seqId so Orderbook
+// accepts them. No checksum field, since they are not real venue data.
+#include "okxParser.h"
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+
+class SyntheticDeltas {
+public:
+    explicit SyntheticDeltas(const BookMessage& snapshot, uint32_t seed = 42, std::string instId = "BTC-USDT")
+        : instId(std::move(instId)), rng(seed), seqId(snapshot.seqId),
+          bestBid(snapshot.bids.front().price), bestAsk(snapshot.asks.front().price) {}
+
+    // Next message, continuing the sequence; levelsPerSide levels on each side
+    std::string next(int levelsPerSide = 4) {
+        std::string side[2];
+        char level[64];
+        for (int s = 0; s < 2; ++s) {
+            for (int k = 0; k < levelsPerSide; ++k) {
+                int offset = static_cast<int>(rng() % 40);
+                double price = s == 0 ? bestBid - offset * 0.1 : bestAsk + offset * 0.1;
+                double size = rng() % 4 == 0 ? 0.0 : (rng() % 100000) / 10000.0;
+                std::snprintf(level, sizeof(level), "%s[\"%.1f\",\"%.8f\",\"0\",\"1\"]",
+                              k ? "," : "", price, size);
+                side[s] += level;
+            }
+        }
+        std::string message = "{\"arg\":{\"channel\":\"books\",\"instId\":\"" + instId + "\"},\"action\":\"update\","
+                              "\"data\":[{\"asks\":[" + side[1] + "],\"bids\":[" + side[0] + "],"
+                              "\"ts\":\"1729000000100\",\"prevSeqId\":" + std::to_string(seqId) +
+                              ",\"seqId\":" + std::to_string(seqId + 1) + "}]}";
+        ++seqId;
+        return message;
+    }
+
+private:
+    std::string instId;
+    std::mt19937 rng;
+    int64_t seqId;
+    double bestBid;
+    double bestAsk;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string_view>
+#include "bookMessage.h"
+
+// Binance spot/futures depth payloads, raw or wrapped in a combined-stream
+// {"stream":..., "data":...} envelope:
+//   - diff events ("e":"depthUpdate"): action "update", seqId = u,
+//     firstSeqId = U, prevSeqId = pu (futures) or U - 1 (spot);
+//   - books with "lastUpdateId" (REST snapshot, partial depth streams):
+//     action "snapshot", seqId = lastUpdateId.
+// Request acks ({"result":..., "id":...}) and errors come back as NotBook.
+BookParseStatus parseBinanceDepthMessage(std::string_view message, BookMessage& out);
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+#include "orderbook.h"
+#include "seqlock.h"
+
+struct FeatureConfig {
+    static constexpr size_t kDepthBands = 4;
+
+    double depthBandsBps[kDepthBands] = {5.0, 10.0, 25.0, 100.0};  // depth within these distances of mid
+    double flowHalfLife = 100.0;         // updates, for the decayed order-flow imbalance
+    double volatilityHalfLife = 1000.0;  // updates, for the realized volatility EWMA
+};
+
+// Microstructure statistics of one published book. Every field describes the
+// snapshot with the same version, so a reader gets a consistent set.
+struct BookFeatures {
+    static constexpr size_t kFlowLevels = 5;
+    static constexpr size_t kDepthBands = FeatureConfig::kDepthBands;
+
+    uint64_t version = 0;  // snapshot version; 0 until the first book
+    int64_t timestampNs = 0;
+    double bestBid = 0.0;
+    double bestAsk = 0.0;
+    double mid = 0.0;
+    double microprice = 0.0;  // mid weighted towards the thinner side of the touch
+    double spread = 0.0;
+    double spreadBps = 0.0;
+
+    // Order-flow imbalance at each of the best levels (Cont et al.): base
+    // quantity added on the bid minus on the ask between consecutive books,
+    // decayed over flowHalfLife updates. Positive = buying pressure.
+    double orderFlowImbalance[kFlowLevels] = {};
+
+    // Notional resting within depthBandsBps[i] of mid, per side
+    double bidDepthWithin[kDepthBands] = {};
+    double askDepthWithin[kDepthBands] = {};
+
+    // Realized volatility of the mid: EWMA of log returns per update and of
+    // the time between updates, annualized (same units as TradeConfig::volatility)
+    double volatility = 0.0;
+    double returnVolatilityBps = 0.0;  // per update
+    uint64_t returns = 0;              // mid returns behind the estimate
+};
+
+// Maintains BookFeatures from the book stream as an Orderbook observer.
+// Nothing is recomputed by walking the book: top-of-book statistics are
+// O(1), order-flow imbalance looks at kFlowLevels levels, and each depth band
+// is one binary search over the snapshot's prefix sums, so an update costs
+// the same however deep the book is. Readers get the latest set through a
+// SeqLock, wait-free for the feed thread.
+class FeatureEngine : public BookObserver {
+public:
+    explicit FeatureEngine(const FeatureConfig& config = FeatureConfig());
+
+    void onPublish(const OrderBookSnapshot& snapshot) override;
+
+    // Reader side, any thread
+    BookFeatures latest() const { return published.load(); }
+    const FeatureConfig& configuration() const { return config; }
+
+private:
+    FeatureConfig config;
+    double flowDecay;
+    double volatilityDecay;
+
+    // Writer-owned state
+    BookFeatures current;
+    double previousBidPrices[BookFeatures::kFlowLevels] = {};
+    double previousBidQuantities[BookFeatures::kFlowLevels] = {};
+    double previousAskPrices[BookFeatures::kFlowLevels] = {};
+    double previousAskQuantities[BookFeatures::kFlowLevels] = {};
+    size_t previousLevels = 0;
+    double squaredReturn = 0.0;  // EWMA of squared log mid returns
+    double interval = 0.0;       // EWMA of seconds between updates
+    double returnWeight = 0.0;   // total weight of the two EWMAs so far
+
+    SeqLock<BookFeatures> published;
+};
+
+// TradeConfig::volatility, or the realized estimate when the config asks for
+// it and the engine has seen enough returns
+double effectiveVolatility(const TradeConfig& config, const BookFeatures& features);
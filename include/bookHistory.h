@@ -0,0 +1,229 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bookSnapshot.h"
+#include "instrument.h"
+#include "mappedFile.h"
+#include "orderbook.h"
+
+// History of the top N levels of every published book.
+//
+// In memory, rows go into a fixed-size ring stored by column: one array of
+// timestamps, one of versions, and one array per (field, level), so a scan of
+// e.g. the best bid over an hour is a pass over contiguous doubles. Missing
+// levels (a book shallower than N) are stored as price 0, quantity 0.
+//
+// With a directory configured, rows are also encoded as they arrive and
+// written out as immutable segment files of segmentRows rows each. A segment
+// holds every column as zigzag varints of the change from the previous row,
+// restarting every kBlockRows rows; a per-block time index makes "book as of
+// T" a binary search plus one block decode, without reading the rest.
+// Finished segments are handed to a background thread for the file write, so
+// the feed thread only encodes; it waits only if that thread is still
+// writing the previous segment when the next one fills.
+//
+// Timestamps are wall-clock nanoseconds since the Unix epoch (the snapshot's
+// steady time shifted by the offset taken at construction), so segments from
+// different sessions line up.
+
+struct HistoryConfig {
+    size_t levels = 20;          // per side
+    size_t capacity = 1 << 16;   // rows kept in memory
+    size_t segmentRows = 1 << 14;
+    std::string directory;       // where segments go; empty keeps memory only
+    InstrumentSpec spec;         // grid for the integer encoding on disk
+};
+
+enum class HistoryField { BidPrice, BidQuantity, AskPrice, AskQuantity };
+
+// A column over a row range. The ring wraps, so the range is up to two
+// contiguous runs, oldest first.
+template <typename T>
+struct HistorySpan {
+    const T* data[2] = {nullptr, nullptr};
+    size_t count[2] = {0, 0};
+
+    size_t size() const { return count[0] + count[1]; }
+    T operator[](size_t i) const { return i < count[0] ? data[0][i] : data[1][i - count[0]]; }
+};
+
+// Fixed layout shared by the writer and HistorySegment
+struct HistorySegmentHeader {
+    static constexpr char kMagic[8] = {'T', 'S', 'H', 'I', 'S', 'T', '0', '1'};
+    static constexpr uint32_t kVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t levels;
+    uint32_t rows;
+    uint32_t blockRows;
+    double tickSize;
+    double lotSize;
+    int64_t firstNs;
+    int64_t lastNs;
+    int64_t wallOffsetNs;  // writer's system_clock minus steady_clock
+};
+
+// Records published books; observer and encoding side run on the feed thread.
+// Queries of the in-memory ring are for the same thread (another observer,
+// or after the feed stops); other threads read the spilled segments, which
+// never change once written.
+class BookHistory : public BookObserver {
+public:
+    static constexpr size_t kBlockRows = 256;
+
+    explicit BookHistory(const HistoryConfig& config = HistoryConfig());
+    ~BookHistory() override;
+    BookHistory(const BookHistory&) = delete;
+    BookHistory& operator=(const BookHistory&) = delete;
+
+    void onPublish(const OrderBookSnapshot& snapshot) override;
+
+    // Appends one row at an explicit wall-clock time
+    void append(const OrderBookSnapshot& snapshot, int64_t timestampNs);
+
+    // Writes out the rows of a partly filled segment (also done on destruction)
+    // and waits until every finished segment is on disk
+    void flush();
+
+    size_t levels() const { return config.levels; }
+    size_t capacity() const { return config.capacity; }
+    uint64_t totalRows() const { return appended; }
+    size_t size() const;  // rows still in memory
+    uint64_t segmentsWritten() const { return segments.load(std::memory_order_acquire); }
+    bool writeFailed() const { return failed.load(std::memory_order_acquire); }
+    // Times the feed thread waited for the previous segment's write
+    uint64_t writerStalls() const { return stalls; }
+
+    // Timestamps of the rows still in memory, oldest first
+    int64_t oldestNs() const;
+    int64_t newestNs() const;
+
+    // Book as of timestampNs: the last row at or before it. False if that row
+    // is older than the ring or there is none.
+    bool bookAt(int64_t timestampNs, OrderBookSnapshot& out) const;
+
+    // Rows with fromNs <= timestamp < toNs, as columns
+    HistorySpan<int64_t> timestamps(int64_t fromNs, int64_t toNs) const;
+    HistorySpan<double> column(HistoryField field, size_t level, int64_t fromNs, int64_t toNs) const;
+
+private:
+    struct RowRange {
+        uint64_t begin;  // logical row numbers
+        uint64_t end;
+    };
+
+    RowRange rowsBetween(int64_t fromNs, int64_t toNs) const;
+    template <typename T>
+    HistorySpan<T> span(const T* base, RowRange rows) const;
+    const double* columnBase(HistoryField field, size_t level) const {
+        return values.data() + (static_cast<size_t>(field) * config.levels + level) * config.capacity;
+    }
+    double* columnBase(HistoryField field, size_t level) {
+        return values.data() + (static_cast<size_t>(field) * config.levels + level) * config.capacity;
+    }
+
+    // One segment's encoded columns and tables; recycled between the feed
+    // thread (filling) and the writer thread (writing out)
+    struct Segment {
+        HistorySegmentHeader header{};
+        std::vector<std::vector<uint8_t>> encoded;  // one byte stream per column, restarting each block
+        std::vector<std::vector<uint64_t>> blockOffsets;  // per column
+        std::vector<int64_t> blockFirstNs;
+    };
+
+    void encodeRow(size_t slot);
+    void finishSegment();
+    void runWriter();
+    void writeSegment(Segment& segment);
+
+    HistoryConfig config;
+    int64_t wallOffsetNs;  // system_clock minus steady_clock
+
+    // Ring, by column
+    std::vector<int64_t> times;
+    std::vector<uint64_t> versions;
+    std::vector<double> values;  // 4 * levels columns of capacity rows
+    uint64_t appended = 0;
+
+    // Segment being encoded (feed thread only)
+    std::unique_ptr<Segment> building;
+    std::vector<int64_t> previous;  // last encoded value per column
+    uint32_t segmentRowCount = 0;
+    int64_t segmentFirstNs = 0;
+    int64_t segmentLastNs = 0;
+    uint64_t stalls = 0;
+
+    // Hand-off to the writer thread
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<std::unique_ptr<Segment>> queued;
+    std::unique_ptr<Segment> spare;  // written out, ready to refill
+    size_t outstanding = 0;           // queued or being written
+    bool stopping = false;
+    std::atomic<uint64_t> segments{0};
+    std::atomic<bool> failed{false};
+
+    std::thread writer;  // runs only with a directory configured
+};
+
+// Read-only view of one segment file, memory-mapped. Move-only.
+class HistorySegment {
+public:
+    bool open(const std::string& path);
+    bool isOpen() const { return valid; }
+
+    size_t levels() const { return head.levels; }
+    size_t rows() const { return head.rows; }
+    int64_t firstNs() const { return head.firstNs; }
+    int64_t lastNs() const { return head.lastNs; }
+
+    // Book as of timestampNs within this segment; false if before its first
+    // row. The snapshot's timestamp is on the recording process's steady clock.
+    bool bookAt(int64_t timestampNs, OrderBookSnapshot& out) const;
+
+    // Decodes rows [first, first + count) of a column into out
+    void decodeTimestamps(size_t first, size_t count, int64_t* out) const;
+    void decodeColumn(HistoryField field, size_t level, size_t first, size_t count, double* out) const;
+
+private:
+    // Column 0 is timestamps, 1 versions, then prices/quantities by field and level
+    void decode(size_t column, size_t first, size_t count, int64_t* out) const;
+
+    MappedFile file;
+    HistorySegmentHeader head{};
+    InstrumentSpec spec;
+    const int64_t* blockFirstNs = nullptr;
+    const uint64_t* columnStarts = nullptr;  // per column, into the data area
+    const uint64_t* blockOffsets = nullptr;  // [column][block], within the column
+    const uint8_t* payload = nullptr;
+    size_t payloadSize = 0;
+    size_t blocks = 0;
+    bool valid = false;
+};
+
+// Every segment in a directory, ordered by time
+class HistoryArchive {
+public:
+    // Maps every *.seg file in directory; false if none could be opened
+    bool open(const std::string& directory);
+
+    size_t segmentCount() const { return segments.size(); }
+    const HistorySegment& segment(size_t i) const { return *segments[i]; }
+    int64_t firstNs() const { return segments.empty() ? 0 : segments.front()->firstNs(); }
+    int64_t lastNs() const { return segments.empty() ? 0 : segments.back()->lastNs(); }
+
+    bool bookAt(int64_t timestampNs, OrderBookSnapshot& out) const;
+
+private:
+    std::vector<std::unique_ptr<HistorySegment>> segments;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "bookSnapshot.h"
+
+// Aggregation kernels over struct-of-arrays book levels. One table per
+// instruction set; bookKernels() picks the best one for the running CPU on
+// first use (set TRADESIM_KERNELS=scalar to force the reference version).
+// SIMD variants sum in a different order, so results can differ from the
+// scalar ones in the last few ulps.
+struct BookKernels {
+    const char* name;
+
+    // cumQty[i] = baseQty + q[0] + ... + q[i]; cumNotional likewise with p * q
+    void (*prefixSums)(const double* prices, const double* quantities, size_t n,
+                       double baseQty, double baseNotional, double* cumQty, double* cumNotional);
+
+    // Sweeps levels until target quantity is filled. Returns the notional and
+    // writes the filled quantity (less than target if the levels run out).
+    double (*fill)(const double* prices, const double* quantities, size_t n,
+                   double target, double* filledQty);
+
+    double (*sumQuantity)(const double* quantities, size_t n);
+
+    // Sum of price * quantity
+    double (*sumNotional)(const double* prices, const double* quantities, size_t n);
+
+    // Notional of the levels priced within [low, high]
+    double (*notionalInRange)(const double* prices, const double* quantities, size_t n,
+                              double low, double high);
+
+    // out[i] = units[i] * step / scale, rounded once like the scalar
+    // InstrumentSpec conversion, so every table gives identical results
+    void (*unitsToDoubles)(const int64_t* units, size_t n, int64_t step, double scale, double* out);
+};
+
+const BookKernels& bookKernels();
+const BookKernels& scalarBookKernels();
+
+// Null if the CPU (or build) has no AVX2 support
+const BookKernels* avx2BookKernels();
+
+// Volume-weighted average price of the best topN levels (0 if empty)
+double vwap(const OrderBookSide& side, size_t topN);
+
+// Notional resting within bps basis points of mid on one side
+double notionalWithinBps(const OrderBookSide& side, double midPrice, double bps);
+
+// (bid qty - ask qty) / (bid qty + ask qty) over the best topN levels, in [-1, 1]
+double imbalance(const OrderBookSnapshot& book, size_t topN);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// One [price, size, ...] entry of a depth message. The text views point into
+// the message buffer and are only valid while that buffer is alive.
+struct BookLevel {
+    double price;
+    double quantity;
+    std::string_view priceText;
+    std::string_view quantityText;
+};
+
+// Depth push decoded into a venue-neutral form (the venue parsers fill it,
+// see exchange.h). Reuse one instance per thread: the level vectors keep
+// their capacity, so steady-state parsing never allocates.
+struct BookMessage {
+    std::string_view channel;
+    std::string_view instId;
+    std::string_view action;   // "snapshot", "update", or empty for full-book pushes
+    std::vector<BookLevel> bids;
+    std::vector<BookLevel> asks;
+    int64_t timestampMs = 0;
+    int64_t seqId = -1;        // last update id covered by this message
+    int64_t prevSeqId = -1;    // seqId of the message this one follows
+    int64_t firstSeqId = -1;   // first update id covered (Binance), else -1
+    int32_t checksum = 0;
+    bool hasChecksum = false;
+
+    void reset() {
+        channel = {};
+        instId = {};
+        action = {};
+        bids.clear();
+        asks.clear();
+        timestampMs = 0;
+        seqId = -1;
+        prevSeqId = -1;
+        firstSeqId = -1;
+        checksum = 0;
+        hasChecksum = false;
+    }
+
+    bool isSnapshot() const { return action.empty() || action == "snapshot"; }
+};
+
+enum class BookParseStatus {
+    Book,       // a depth push; out is filled
+    NotBook,    // valid JSON without book data (event acks, errors, other channels)
+    Malformed
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "orderbook.h"
+
+// Identifies one book: venue name ("OKX") and the venue's instrument id
+struct BookKey {
+    std::string exchange;
+    std::string symbol;
+
+    bool operator<(const BookKey& other) const {
+        return exchange != other.exchange ? exchange < other.exchange : symbol < other.symbol;
+    }
+    bool operator==(const BookKey& other) const { return exchange == other.exchange && symbol == other.symbol; }
+};
+
+// Owns one Orderbook per (exchange, symbol). Register every instrument
+// before any feed starts: adding is not thread-safe, but the books
+// themselves never move, so references handed out stay valid for the
+// registry's lifetime and can be read from any thread.
+class BookRegistry {
+public:
+    // Depth settings applied to every book (see Orderbook)
+    explicit BookRegistry(size_t maxDepth = 400, size_t publishDepth = 400);
+
+    // Returns the book for key, creating it on first use
+    Orderbook& add(const BookKey& key, const InstrumentSpec& spec = InstrumentSpec());
+
+    // nullptr if key was never added
+    Orderbook* find(const BookKey& key) const;
+
+    // Books in registration order
+    size_t size() const { return entries.size(); }
+    const BookKey& keyAt(size_t i) const { return entries[i].key; }
+    Orderbook& bookAt(size_t i) const { return *entries[i].book; }
+
+private:
+    struct Entry {
+        BookKey key;
+        std::unique_ptr<Orderbook> book;
+    };
+
+    size_t maxDepth;
+    size_t publishDepth;
+    std::vector<Entry> entries;
+    std::map<BookKey, size_t> index;
+};
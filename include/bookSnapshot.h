@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "instrument.h"
+
+struct OrderLevel {
+    double price;
+    double quantity;
+};
+
+// One side of the book as a struct of arrays, sorted descending for bids and
+// ascending for asks. Prices and quantities are separate contiguous arrays so
+// aggregate kernels (see bookKernels.h) can stream them with SIMD loads.
+// ticks/lots hold the same levels on the snapshot's instrument grid; they are
+// filled by the publisher and by indexSnapshot, and empty after push_back.
+struct OrderBookSide {
+    std::vector<double> prices;
+    std::vector<double> quantities;
+    std::vector<int64_t> ticks;
+    std::vector<int64_t> lots;
+
+    OrderBookSide() = default;
+    OrderBookSide(std::initializer_list<OrderLevel> levels) {
+        for (const auto& level : levels) push_back(level);
+    }
+
+    size_t size() const { return prices.size(); }
+    bool empty() const { return prices.empty(); }
+    OrderLevel operator[](size_t i) const { return {prices[i], quantities[i]}; }
+    OrderLevel front() const { return {prices.front(), quantities.front()}; }
+
+    // True when ticks/lots describe every level
+    bool onGrid() const { return ticks.size() == prices.size() && lots.size() == prices.size(); }
+
+    void clear() {
+        prices.clear();
+        quantities.clear();
+        ticks.clear();
+        lots.clear();
+    }
+    // Doubles only; publishers writing the grid side size ticks/lots too
+    void resize(size_t n) {
+        prices.resize(n);
+        quantities.resize(n);
+    }
+    void reserve(size_t n) {
+        prices.reserve(n);
+        quantities.reserve(n);
+        ticks.reserve(n);
+        lots.reserve(n);
+    }
+    void push_back(const OrderLevel& level) {
+        prices.push_back(level.price);
+        quantities.push_back(level.quantity);
+    }
+};
+
+// Prefix sums over one side: entry i covers levels 0..i inclusive.
+// Lets a fill of any size be found with one binary search.
+struct DepthIndex {
+    std::vector<double> cumQuantity;
+    std::vector<double> cumNotional;  // sum of price * quantity
+    std::vector<int64_t> cumLots;     // exact running size; empty for off-grid sides
+
+    double totalQuantity() const { return cumQuantity.empty() ? 0.0 : cumQuantity.back(); }
+    double totalNotional() const { return cumNotional.empty() ? 0.0 : cumNotional.back(); }
+    int64_t totalLots() const { return cumLots.empty() ? 0 : cumLots.back(); }
+
+    void reserve(size_t n) {
+        cumQuantity.reserve(n);
+        cumNotional.reserve(n);
+        cumLots.reserve(n);
+    }
+};
+
+// Immutable view of the book handed to readers. version increases with every
+// update, so consumers can cache results against it; readers of published
+// snapshots can see gaps (see BookObserver).
+struct OrderBookSnapshot {
+    OrderBookSide bids;
+    OrderBookSide asks;
+    DepthIndex bidDepth;  // kept in step with bids by the publisher
+    DepthIndex askDepth;
+    std::chrono::steady_clock::time_point timestamp;
+    uint64_t version = 0;
+    InstrumentSpec spec;  // grid of the sides' ticks/lots
+
+    // Pre-sizes every array for depth levels per side, so refilling a
+    // recycled snapshot up to that depth never touches the heap
+    void reserve(size_t depth) {
+        bids.reserve(depth);
+        asks.reserve(depth);
+        bidDepth.reserve(depth);
+        askDepth.reserve(depth);
+    }
+};
+
+// Best levels only; small enough to publish through a SeqLock on every update
+struct TopOfBook {
+    double bidPrice = 0.0;
+    double bidQuantity = 0.0;
+    double askPrice = 0.0;
+    double askQuantity = 0.0;
+    int64_t timestampNs = 0;  // steady_clock time since epoch
+    uint64_t version = 0;
+    int64_t seqId = -1;       // venue sequence of the message behind this update
+};
+
+// Rebuilds a DepthIndex from scratch; cumLots only if the side is on grid
+void buildDepthIndex(const OrderBookSide& side, DepthIndex& out);
+
+// Puts both sides of a hand-built snapshot on snapshot.spec's grid (nearest
+// tick/lot) and rebuilds their depth indexes
+void indexSnapshot(OrderBookSnapshot& snapshot);
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string_view>
+#include "bookMessage.h"
+
+// Bybit v5 "orderbook.{depth}.{symbol}" pushes. "snapshot" and "delta"
+// become actions "snapshot" and "update"; seqId is the update id u, which
+// increases by one per message, so prevSeqId = u - 1. Op acks and pongs come
+// back as NotBook.
+BookParseStatus parseBybitBookMessage(std::string_view message, BookMessage& out);
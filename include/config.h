@@ -3,12 +3,16 @@
 
 #include <string>
 
+// Annualizes volatilities; crypto trades every day of the year
+constexpr double kSecondsPerYear = 365.0 * 24.0 * 3600.0;
+
 struct TradeConfig {
     std::string exchange = "OKX";
     std::string symbol = "BTC-USDT-SWAP";
-    std::string orderType = "market";  // Only market supported for now
+    std::string orderType = "market";  // market, limit, post-only or ioc (see MatchingEngine)
     double quantityUSD = 100.0;        // Amount to simulate
-    double volatility = 0.0;           // Placeholder; will be used later
+    double volatility = 0.6;           // Annualized, of the mid (see MonteCarloConfig)
+    bool realizedVolatility = false;   // Use the feed's estimate instead (see FeatureEngine)
     double feeTier = 0.001;            // Exchange-specific fee (taker for now)
 };
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "bookSnapshot.h"
+
+enum class CurveSides { Buy, Sell, Both };
+
+// Execution cost of one order size on one side
+struct CostPoint {
+    double quantity;          // requested base quantity
+    double executedQuantity;  // less than quantity if the visible book runs out
+    double averagePrice;
+    double slippage;          // average price vs mid, as a fraction
+    double fees;
+    double marketImpact;      // share of visible side liquidity consumed
+    double netCost;           // slippage cost vs mid plus fees, in quote currency
+};
+
+struct CostCurve {
+    uint64_t version = 0;  // snapshot version the curve was computed against
+    std::vector<CostPoint> buy;   // same order as the requested quantities
+    std::vector<CostPoint> sell;
+};
+
+// Evaluates every quantity in one merged walk per side: the queries are
+// visited in size order while a single cursor advances through the levels,
+// so the cost is O(depth + queries log queries) rather than O(queries * depth).
+void computeCostCurve(const OrderBookSnapshot& book, const std::vector<double>& quantities,
+                      CurveSides sides, int feeTier, CostCurve& out);
+
+// Memoizes the last curve until the book version or the query changes.
+// Unversioned (hand-built, version 0) snapshots are always recomputed.
+class CostCurveCache {
+public:
+    const CostCurve& get(const OrderBookSnapshot& book, const std::vector<double>& quantities,
+                         CurveSides sides, int feeTier);
+
+    void invalidate() { valid = false; }
+
+private:
+    CostCurve curve;
+    std::vector<double> lastQuantities;
+    CurveSides lastSides = CurveSides::Both;
+    int lastFeeTier = 0;
+    bool valid = false;
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Standard CRC-32 (IEEE 802.3, reflected 0xEDB88320) as used by OKX order
+// book checksums. Pass the previous return value as crc to hash incrementally.
+uint32_t crc32(const char* data, size_t length, uint32_t crc = 0);
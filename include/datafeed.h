@@ -1,4 +1,13 @@
 #pragma once
 #include "tradeSim.h"  // for OrderBookSnapshot
+#include "snapshotPublisher.h"
 
-OrderBookSnapshot getCurrentOrderBookSnapshot();
\ No newline at end of file
+class Orderbook;
+
+// Routes getCurrentOrderBookSnapshot() to a live or replayed book; nullptr
+// goes back to the built-in dummy levels. The book must outlive the attachment.
+void attachOrderbook(const Orderbook* book);
+
+// Move-only handle to a pooled snapshot; the slot is recycled once released.
+// Falls back to dummy levels until an attached book has published.
+SnapshotHandle getCurrentOrderBookSnapshot();
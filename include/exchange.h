@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "binanceParser.h"
+#include "bookMessage.h"
+#include "bybitParser.h"
+#include "instrument.h"
+#include "okxParser.h"
+
+class PriceLadder;
+
+// Maker/taker rates as fractions of notional (0.001 = 0.1%)
+struct FeeTier {
+    double maker;
+    double taker;
+};
+
+// Tick/lot grid of one symbol
+struct InstrumentGrid {
+    std::string_view symbol;
+    double tickSize;
+    double lotSize;
+};
+
+// How a delta relates to the last message applied to the book
+enum class SequenceCheck {
+    InOrder,
+    Stale,  // already contained in the book (e.g. older than the snapshot); drop it
+    Gap     // updates were missed; the book must resync
+};
+
+// CRTP base of the exchange policies. A policy supplies
+//   kName, kDefaultUrl, kDefaultSymbol   for logs and defaults
+//   kFeeTiers[]                          fee schedule, entry tier first
+//   kInstruments[]                       grids of the symbols we know
+//   decode(payload, out)                 depth push -> BookMessage
+//   subscribeMessage(symbol, subscribe)  (un)subscribe request for one book
+//   controlError(payload)                error text of a non-book message, or empty
+// and may replace sequence() and kHasChecksum/checksum(). Orderbook and the
+// websocket client are instantiated per policy, so venue differences are
+// settled at compile time rather than by string compares or virtual calls,
+// and adding a venue means adding a policy.
+template <class Venue>
+struct ExchangeAdapter {
+    static constexpr bool kHasChecksum = false;
+
+    // Tier 1 is the entry tier; tiers past either end of the table clamp
+    static constexpr FeeTier feeTier(int tier) {
+        constexpr int count = static_cast<int>(std::size(Venue::kFeeTiers));
+        return Venue::kFeeTiers[std::clamp(tier, 1, count) - 1];
+    }
+
+    static constexpr double feeRate(int tier, bool isMaker) {
+        return isMaker ? feeTier(tier).maker : feeTier(tier).taker;
+    }
+
+    // Grid of a known symbol; others get the default spec, whose grid an
+    // Orderbook derives from the feed (see InstrumentSpec::isDerived)
+    static InstrumentSpec instrument(std::string_view symbol) {
+        for (const InstrumentGrid& grid : Venue::kInstruments)
+            if (grid.symbol == symbol) return InstrumentSpec(grid.tickSize, grid.lotSize);
+        return InstrumentSpec();
+    }
+
+    // Deltas chain exactly: each names the seqId of the one before it
+    static SequenceCheck sequence(int64_t lastSeqId, const BookMessage& message) {
+        return message.prevSeqId == lastSeqId ? SequenceCheck::InOrder : SequenceCheck::Gap;
+    }
+};
+
+// OKX v5 "books": snapshot then deltas chained by prevSeqId, each carrying a
+// CRC32 of the top 25 levels
+struct Okx : ExchangeAdapter<Okx> {
+    static constexpr std::string_view kName = "OKX";
+    static constexpr std::string_view kDefaultUrl = "wss://ws.okx.com:8443/ws/v5/public";
+    static constexpr std::string_view kDefaultSymbol = "BTC-USDT";
+    // Regular spot schedule: Lv1, then VIP1..VIP5
+    static constexpr FeeTier kFeeTiers[] = {
+        {0.00080, 0.00100}, {0.00045, 0.00050}, {0.00040, 0.00045},
+        {0.00030, 0.00040}, {0.00020, 0.00035}, {0.00000, 0.00030},
+    };
+    static constexpr InstrumentGrid kInstruments[] = {
+        {"BTC-USDT", 0.1, 1e-8},
+        {"BTC-USDT-SWAP", 0.1, 0.01},  // sizes in contracts
+    };
+    static constexpr bool kHasChecksum = true;
+
+    static BookParseStatus decode(std::string_view payload, BookMessage& out) {
+        return parseOkxBookMessage(payload, out);
+    }
+    static std::string subscribeMessage(std::string_view symbol, bool subscribe);
+    static std::string controlError(std::string_view payload);
+
+    // CRC32 of the top 25 levels in "bidPx:bidSz:askPx:askSz:..." order, over
+    // the venue's own text
+    static int32_t checksum(const PriceLadder& bids, const PriceLadder& asks);
+};
+
+// Binance spot. Subscribes to the 20-level partial book stream, whose pushes
+// are full snapshots; diff events ("depthUpdate") are decoded too, for a
+// REST snapshot followed by the diff stream.
+struct Binance : ExchangeAdapter<Binance> {
+    static constexpr std::string_view kName = "Binance";
+    static constexpr std::string_view kDefaultUrl = "wss://stream.binance.com:9443/ws";
+    static constexpr std::string_view kDefaultSymbol = "BTCUSDT";
+    // Regular spot schedule: VIP0..VIP9
+    static constexpr FeeTier kFeeTiers[] = {
+        {0.001000, 0.001000}, {0.000900, 0.001000}, {0.000800, 0.001000}, {0.000420, 0.000600},
+        {0.000420, 0.000540}, {0.000360, 0.000480}, {0.000300, 0.000420}, {0.000240, 0.000360},
+        {0.000180, 0.000300}, {0.000120, 0.000240},
+    };
+    static constexpr InstrumentGrid kInstruments[] = {
+        {"BTCUSDT", 0.01, 0.00001},
+        {"ETHUSDT", 0.01, 0.0001},
+    };
+
+    static BookParseStatus decode(std::string_view payload, BookMessage& out) {
+        return parseBinanceDepthMessage(payload, out);
+    }
+    static std::string subscribeMessage(std::string_view symbol, bool subscribe);
+    static std::string controlError(std::string_view payload);
+
+    // Diff events cover update ids [U, u]. The first one applied after a
+    // snapshot straddles its lastUpdateId; later ones start right after the
+    // last (spot) or name it in pu (futures, decoded into prevSeqId).
+    static SequenceCheck sequence(int64_t lastSeqId, const BookMessage& message) {
+        if (message.seqId <= lastSeqId) return SequenceCheck::Stale;
+        return message.firstSeqId <= lastSeqId + 1 ? SequenceCheck::InOrder : SequenceCheck::Gap;
+    }
+};
+
+// Bybit v5 spot "orderbook.50": snapshot then deltas with consecutive update ids
+struct Bybit : ExchangeAdapter<Bybit> {
+    static constexpr std::string_view kName = "Bybit";
+    static constexpr std::string_view kDefaultUrl = "wss://stream.bybit.com/v5/public/spot";
+    static constexpr std::string_view kDefaultSymbol = "BTCUSDT";
+    // Spot schedule: non-VIP, then VIP1..VIP5
+    static constexpr FeeTier kFeeTiers[] = {
+        {0.001000, 0.001000}, {0.000675, 0.000800}, {0.000650, 0.000775},
+        {0.000625, 0.000750}, {0.000500, 0.000600}, {0.000400, 0.000500},
+    };
+    static constexpr InstrumentGrid kInstruments[] = {
+        {"BTCUSDT", 0.01, 0.000001},
+        {"ETHUSDT", 0.01, 0.00001},
+    };
+
+    static BookParseStatus decode(std::string_view payload, BookMessage& out) {
+        return parseBybitBookMessage(payload, out);
+    }
+    static std::string subscribeMessage(std::string_view symbol, bool subscribe);
+    static std::string controlError(std::string_view payload);
+};
+
+// Runtime venue selection, for configs and command lines
+enum class ExchangeId { Okx, Binance, Bybit };
+
+// Case-insensitive "okx", "binance" or "bybit"; false for anything else
+bool parseExchangeId(std::string_view name, ExchangeId& out);
+
+// Calls fn with the policy of id (as a value, use decltype to get the type).
+// The one place a runtime venue choice becomes a type; everything fn
+// instantiates runs without further dispatch.
+template <class Fn>
+decltype(auto) withExchange(ExchangeId id, Fn&& fn) {
+    switch (id) {
+    case ExchangeId::Binance:
+        return fn(Binance{});
+    case ExchangeId::Bybit:
+        return fn(Bybit{});
+    case ExchangeId::Okx:
+        break;
+    }
+    return fn(Okx{});
+}
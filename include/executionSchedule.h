@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bookSnapshot.h"
+#include "exchange.h"
+#include "models/impact.h"
+#include "orderbook.h"
+#include "threadPool.h"
+#include "tradeSim.h"
+
+// Sequence of book states to run execution schedules against: the top
+// levels of each published book, by column, with prefix sums so a child
+// order is priced by binary search. Also keeps a proxy for traded volume,
+// since the feed carries books only: quantity that left the touch between
+// consecutive books (a best level that shrank, or one the market moved
+// through). Records from the feed thread as an observer, or from a replay;
+// not thread-safe while recording, read-only (and shareable) after.
+class BookPath : public BookObserver {
+public:
+    // States beyond capacity are dropped (counted in dropped()). With a
+    // window, recording stops at the first state more than windowSeconds
+    // after the first one (that state is kept, so a child at the window's
+    // end still has a book); 0 records until capacity.
+    explicit BookPath(size_t levels = 25, size_t capacity = 1 << 16, double windowSeconds = 0.0);
+
+    void onPublish(const OrderBookSnapshot& snapshot) override;
+
+    // Appends a book at an explicit time, on any clock the caller's
+    // ParentOrder::startNs uses (onPublish uses the snapshot's steady clock)
+    void append(const OrderBookSnapshot& snapshot, int64_t timestampNs);
+
+    void clear();
+
+    // Allocates every column for states up front, so recording from the feed
+    // thread does not reallocate
+    void reserve(size_t states);
+
+    // The window has passed; later books are ignored
+    bool complete() const { return windowClosed; }
+
+    size_t size() const { return times.size(); }
+    size_t levels() const { return depth; }
+    uint64_t dropped() const { return droppedStates; }
+    int64_t timestampAt(size_t i) const { return times[i]; }
+    double midAt(size_t i) const { return mids[i]; }
+    double activityAt(size_t i) const { return activity[i]; }  // volume proxy since state i - 1
+    double activityThrough(size_t i) const { return cumulativeActivity[i]; }  // states 0..i
+
+    // Last state at or before timestampNs; size() if there is none
+    size_t stateAt(int64_t timestampNs) const;
+
+    // Volume proxy per slice of [startNs, startNs + duration), normalized to
+    // sum to 1 (uniform if the path shows none); a VWAP profile
+    std::vector<double> activityProfile(int64_t startNs, double durationSeconds, size_t slices) const;
+
+    // Base quantity and notional for quantities [from, from + quantity) of
+    // one side's cumulative depth in state i: a fill after `from` has
+    // already been taken
+    FillEstimate fillBetween(size_t i, Side side, double from, double quantity) const;
+
+private:
+    double notionalThrough(size_t i, bool asks, double quantity) const;
+
+    size_t depth;
+    size_t capacity;
+    int64_t windowNs;  // 0 = none
+    bool windowClosed = false;
+    uint64_t droppedStates = 0;
+
+    std::vector<int64_t> times;
+    std::vector<double> mids;
+    std::vector<double> activity;
+    std::vector<double> cumulativeActivity;  // through each state, for POV windows
+    // depth entries per state and side: prices, then prefix sums
+    std::vector<double> bidPrices, bidCumQuantity, bidCumNotional;
+    std::vector<double> askPrices, askCumQuantity, askCumNotional;
+    std::vector<uint32_t> bidCounts, askCounts;
+
+    // Previous touch, for the volume proxy
+    double lastBid = 0.0, lastBidQuantity = 0.0;
+    double lastAsk = 0.0, lastAskQuantity = 0.0;
+};
+
+enum class SchedulePolicy {
+    Twap,    // equal children at equal intervals
+    Vwap,    // children in proportion to volumeProfile
+    Pov,     // participation x the volume proxy since the last child
+    Custom,  // follows trajectory (e.g. MarketImpactModel::trajectory)
+};
+
+struct ScheduleSpec {
+    SchedulePolicy policy = SchedulePolicy::Twap;
+    double durationSeconds = 60.0;
+    size_t slices = 12;                 // children for Twap and Vwap
+    std::vector<double> volumeProfile;  // Vwap: weight per slice; empty = uniform
+    double participation = 0.1;         // Pov: share of the volume proxy
+    double povIntervalSeconds = 1.0;    // Pov: time between children
+    bool finishAtEnd = true;            // Pov: sweep what is left at the end
+    ExecutionTrajectory trajectory;     // Custom: holdings at t = 0, interval, ...; scaled to the order
+};
+
+struct ParentOrder {
+    Side side = Side::Buy;
+    double quantity = 0.0;             // base asset
+    int64_t startNs = 0;               // arrival, on the path's clock
+    FeeTier fees = Okx::kFeeTiers[0];  // children pay taker
+    // Our own fills deplete the book; the gap refills exponentially with this
+    // time constant (ImpactCalibration::resilienceSeconds)
+    double resilienceSeconds = 10.0;
+};
+
+// Implementation shortfall against the mid at arrival, in quote currency;
+// positive is a cost
+struct ScheduleCost {
+    double arrivalPrice = 0.0;
+    double executedQuantity = 0.0;
+    double unfilledQuantity = 0.0;  // the book (or the path) ran out first
+    double averagePrice = 0.0;
+    double slippageCost = 0.0;      // (average - arrival) * executed, signed by side
+    double fees = 0.0;
+    double totalCost = 0.0;
+    double costBps = 0.0;           // totalCost per arrival notional executed
+    size_t childOrders = 0;
+};
+
+// Runs parent orders through schedules of child market orders against a
+// BookPath. Each child sweeps the state current at its time, starting past
+// the depth our earlier children took and that has not refilled yet, so
+// slicing faster than the book recovers costs more. Schedules are evaluated
+// in parallel; each result depends only on its inputs, not on the thread
+// count.
+class ScheduleSimulator {
+public:
+    // threads counts the caller; 0 = one per hardware thread
+    explicit ScheduleSimulator(size_t threads = 0);
+
+    // Cost of one schedule; thread-safe
+    static ScheduleCost simulate(const BookPath& path, const ParentOrder& order, const ScheduleSpec& schedule);
+
+    // Costs of every candidate, in order. Not thread-safe (one pool).
+    std::vector<ScheduleCost> evaluate(const BookPath& path, const ParentOrder& order,
+                                       const std::vector<ScheduleSpec>& candidates);
+
+    // Index of the lowest total cost among candidates that filled in full;
+    // candidates.size() if none did
+    static size_t cheapest(const std::vector<ScheduleCost>& costs);
+
+    size_t threadCount() const { return pool.size(); }
+
+private:
+    ThreadPool pool;
+};
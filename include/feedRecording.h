@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include "mappedFile.h"
+
+// On-disk session log: a FeedFileHeader followed by records, each a
+// FeedRecordHeader plus the raw websocket payload, padded to 8 bytes.
+// Integers are little-endian (the byte order of every platform we build on).
+// Raw payloads are kept instead of decoded deltas so replay exercises the
+// same parse path as live data.
+
+struct FeedFileHeader {
+    static constexpr char kMagic[8] = {'T', 'S', 'F', 'E', 'E', 'D', '0', '1'};
+    static constexpr uint32_t kVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t wallClockStartNs;  // system_clock at open, for reference only
+    int64_t steadyStartNs;     // latencyNow() at open
+};
+
+struct FeedRecordHeader {
+    int64_t receiveNs;  // latencyNow() when the payload arrived
+    uint32_t length;    // payload bytes (excluding padding)
+    uint32_t reserved;
+};
+
+// Appends payloads to a session log. Writes go through a large stdio buffer,
+// so the feed thread pays a memcpy per message and a write() per megabyte.
+// Single writer. The first failed write (e.g. a full disk) is latched: the
+// recorder stops writing, isOpen() turns false and writeFailed() stays set
+// until the next open(), so a truncated log is never mistaken for a whole one.
+class FeedRecorder {
+public:
+    FeedRecorder() = default;
+    ~FeedRecorder() { close(); }
+    FeedRecorder(const FeedRecorder&) = delete;
+    FeedRecorder& operator=(const FeedRecorder&) = delete;
+
+    // Creates (truncates) path and writes the file header
+    bool open(const std::string& path);
+    // Also flushes the buffer, which may latch a failure
+    void close();
+    bool isOpen() const { return file != nullptr && !failed; }
+    bool writeFailed() const { return failed; }
+
+    void append(std::string_view payload, int64_t receiveNs);
+
+    // Records fully handed to stdio before any failure
+    uint64_t recordCount() const { return records; }
+
+private:
+    void fail();
+
+    FILE* file = nullptr;
+    uint64_t records = 0;
+    bool failed = false;
+};
+
+struct FeedRecord {
+    int64_t receiveNs;
+    std::string_view payload;  // points into the mapped file
+};
+
+// Sequential reader over a memory-mapped session log. A truncated final
+// record (e.g. from a crash mid-write) is treated as end of file.
+class FeedReader {
+public:
+    bool open(const std::string& path);
+    bool isOpen() const { return valid; }
+    const FeedFileHeader& header() const { return fileHeader; }
+
+    bool next(FeedRecord& out);
+    void rewind();
+
+    // Bytes consumed so far, for progress reporting
+    size_t position() const { return offset; }
+    size_t size() const { return file.size(); }
+
+private:
+    MappedFile file;
+    FeedFileHeader fileHeader{};
+    size_t offset = 0;
+    bool valid = false;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Fault injection rates, each a per-message, per-client probability in [0, 1]
+struct FeedFaults {
+    double drop = 0.0;        // message silently not delivered
+    double gap = 0.0;         // prevSeqId no longer chains to the previous message
+    double corrupt = 0.0;     // checksum field off by one
+    double disconnect = 0.0;  // connection closed instead of delivering
+};
+
+struct FeedServerConfig {
+    std::string host = "127.0.0.1";
+    int port = 8765;
+    size_t symbols = 1;         // BTC-USDT, ETH-USDT, ... (see FeedServer::symbolName)
+    size_t depth = 400;         // levels per side in synthetic books
+    int levelsPerUpdate = 4;    // changed levels per side in each synthetic delta
+    double rate = 1000.0;       // updates per second per symbol; 0 = as fast as clients read
+    std::string replayPath;     // stream this session log (see FeedRecorder) instead
+    FeedFaults faults;
+    uint32_t seed = 1;
+};
+
+struct FeedServerStats {
+    uint64_t messages = 0;      // delivered, summed over clients
+    uint64_t bytes = 0;
+    uint64_t dropped = 0;
+    uint64_t gaps = 0;
+    uint64_t corrupted = 0;
+    uint64_t disconnects = 0;
+    size_t clients = 0;         // currently connected
+};
+
+// Local stand-in for the OKX public websocket, for load-testing the feed
+// path offline. Answers subscribe/unsubscribe to the "books" channel the
+// way OKX does and then streams a snapshot followed by deltas: either
+// synthetic books (random walk around a fixed mid, valid seqId chain and
+// checksums) or a recorded session, at a fixed rate or as fast as the
+// slowest client drains its socket. Faults can be injected per client to
+// exercise resync and reconnect handling.
+class FeedServer {
+public:
+    explicit FeedServer(const FeedServerConfig& config);
+    ~FeedServer();
+    FeedServer(const FeedServer&) = delete;
+    FeedServer& operator=(const FeedServer&) = delete;
+
+    // Binds the port and starts streaming; false (and logged) on failure
+    bool start();
+    void stop();
+
+    // Takes effect from the next message
+    void setFaults(const FeedFaults& faults);
+
+    FeedServerStats stats() const;
+
+    // Steady-clock time (latencyNow) at which the synthetic update with this
+    // seqId was handed to the socket, or 0 if it is too old to be remembered.
+    // With client and server in one process this gives wire-to-book latency.
+    int64_t sendTimeNs(size_t symbol, int64_t seqId) const;
+
+    // Instrument id of synthetic symbol i
+    static std::string symbolName(size_t i);
+
+private:
+    class Impl;
+    Impl* impl;
+};
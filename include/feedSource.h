@@ -0,0 +1,18 @@
+#pragma once
+
+// A producer of book updates for an Orderbook: the live websocket or a
+// recorded session being replayed. Sources deliver on their own thread and
+// apply straight to the book; consumers read it through snapshots.
+class FeedSource {
+public:
+    virtual ~FeedSource() = default;
+
+    // Begins delivering updates in the background
+    virtual void start() = 0;
+
+    // Stops delivery; blocks until the source's thread has exited
+    virtual void stop() = 0;
+
+    // True once a finite source (a replay) has delivered everything
+    virtual bool finished() const { return false; }
+};
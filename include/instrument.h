@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Per-symbol price/size grid. Prices are held as int64 ticks and sizes as
+// int64 lots, so book updates match levels exactly instead of comparing
+// doubles parsed from strings. Doubles are produced only when publishing.
+class InstrumentSpec {
+public:
+    // The default spec is for symbols with no listed grid: an Orderbook
+    // derives it from the decimals in the venue's text (see isDerived). Until
+    // then 1e-8 stands in; it is not exact for every symbol.
+    InstrumentSpec() : InstrumentSpec(1e-8, 1e-8) { derived = true; }
+    InstrumentSpec(double tickSize, double lotSize);
+
+    // Derived grid of 10^-priceDecimals by 10^-sizeDecimals (each capped at
+    // kMaxDecimals)
+    static InstrumentSpec fromDecimals(int priceDecimals, int sizeDecimals);
+
+    // Finest grid supported; text with more decimals is always off grid
+    static constexpr int kMaxDecimals = 12;
+
+    // Digits after the point in a plain decimal, ignoring trailing zeros
+    // ("0.10" -> 1); at most kMaxDecimals + 1
+    static int decimalsOf(std::string_view text);
+
+    double tickSize() const { return tick.size; }
+    double lotSize() const { return lot.size; }
+    int priceDecimals() const { return tick.decimals; }
+    int sizeDecimals() const { return lot.decimals; }
+
+    // True for grids a book should derive from the feed rather than trust
+    bool isDerived() const { return derived; }
+
+    // Exact decimal parse ("60000.1" -> 600001 at a 0.1 tick). Fails if the
+    // text is not a plain decimal or does not land on the grid.
+    bool parseTicks(std::string_view text, int64_t& ticks) const { return tick.parse(text, ticks); }
+    bool parseLots(std::string_view text, int64_t& lots) const { return lot.parse(text, lots); }
+
+    // Nearest grid point; for callers that only have a double
+    int64_t toTicks(double price) const { return tick.toUnits(price); }
+    int64_t toLots(double quantity) const { return lot.toUnits(quantity); }
+
+    // Correctly rounded, so fromTicks(parseTicks(s)) equals the double parsed from s
+    double fromTicks(int64_t ticks) const { return tick.toDouble(ticks); }
+    double fromLots(int64_t lots) const { return lot.toDouble(lots); }
+
+    // Same for n values at once, through the dispatched kernel (bookKernels.h)
+    void fromTicks(const int64_t* ticks, size_t n, double* out) const { tick.toDoubles(ticks, n, out); }
+    void fromLots(const int64_t* lots, size_t n, double* out) const { lot.toDoubles(lots, n, out); }
+
+private:
+    // step == stepUnits / 10^decimals exactly
+    struct Grid {
+        double size;
+        int decimals;
+        int64_t stepUnits;
+        double scale;  // 10^decimals
+
+        explicit Grid(double stepSize);
+        bool parse(std::string_view text, int64_t& out) const;
+        // Nearest unit, halves away from zero; inline, since every delta
+        // level goes through it
+        int64_t toUnits(double value) const {
+            double units = value * scale / static_cast<double>(stepUnits);
+            return static_cast<int64_t>(units < 0.0 ? units - 0.5 : units + 0.5);
+        }
+        // Both operands are exact integers, so the division rounds once,
+        // exactly like parsing the decimal string would
+        double toDouble(int64_t units) const { return static_cast<double>(units * stepUnits) / scale; }
+        void toDoubles(const int64_t* units, size_t n, double* out) const;
+    };
+
+    Grid tick;
+    Grid lot;
+    bool derived = false;
+};
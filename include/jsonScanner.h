@@ -0,0 +1,155 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "bookMessage.h"
+
+// Minimal forward-only JSON cursor shared by the venue depth parsers. It only
+// understands what depth pushes contain; anything else is skipped
+// structurally without decoding.
+class JsonScanner {
+public:
+    explicit JsonScanner(std::string_view text) : p(text.data()), end(text.data() + text.size()) {}
+
+    void skipWhitespace() {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (p < end && *p == c) {
+            ++p;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c) {
+        skipWhitespace();
+        return p < end && *p == c;
+    }
+
+    // Returns the raw contents between quotes; book fields never contain escapes
+    bool readString(std::string_view& out) {
+        if (!consume('"')) return false;
+        const char* start = p;
+        while (p < end && *p != '"') {
+            if (*p == '\\') ++p;
+            ++p;
+        }
+        if (p >= end) return false;
+        out = std::string_view(start, static_cast<size_t>(p - start));
+        ++p;
+        return true;
+    }
+
+    // Accepts both bare numbers and quoted ones (OKX sends "ts" as a string)
+    bool readInt(int64_t& out) {
+        skipWhitespace();
+        if (p < end && *p == '"') {
+            std::string_view text;
+            if (!readString(text)) return false;
+            return toInt(text, out);
+        }
+        const char* start = p;
+        while (p < end && (*p == '-' || (*p >= '0' && *p <= '9'))) ++p;
+        return toInt(std::string_view(start, static_cast<size_t>(p - start)), out);
+    }
+
+    static bool toInt(std::string_view text, int64_t& out) {
+        auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+        return res.ec == std::errc() && res.ptr == text.data() + text.size();
+    }
+
+    static bool toDouble(std::string_view text, double& out) {
+        auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+        return res.ec == std::errc() && res.ptr == text.data() + text.size();
+    }
+
+    bool skipValue() {
+        skipWhitespace();
+        if (p >= end) return false;
+        if (*p == '"') {
+            std::string_view ignored;
+            return readString(ignored);
+        }
+        if (*p == '{' || *p == '[') {
+            int depth = 0;
+            while (p < end) {
+                char c = *p;
+                if (c == '"') {
+                    std::string_view ignored;
+                    if (!readString(ignored)) return false;
+                    continue;
+                }
+                ++p;
+                if (c == '{' || c == '[') ++depth;
+                else if (c == '}' || c == ']') {
+                    if (--depth == 0) return true;
+                }
+            }
+            return false;
+        }
+        // number, true, false, null
+        while (p < end && *p != ',' && *p != '}' && *p != ']') ++p;
+        return true;
+    }
+
+    // Iterates "key": value pairs; the callback must consume the value
+    template <typename Fn>
+    bool forEachMember(Fn&& onMember) {
+        if (!consume('{')) return false;
+        if (consume('}')) return true;
+        do {
+            std::string_view key;
+            if (!readString(key) || !consume(':')) return false;
+            if (!onMember(key)) return false;
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // Iterates array elements; the callback must consume each element
+    template <typename Fn>
+    bool forEachElement(Fn&& onElement) {
+        if (!consume('[')) return false;
+        if (consume(']')) return true;
+        do {
+            if (!onElement()) return false;
+        } while (consume(','));
+        return consume(']');
+    }
+
+private:
+    const char* p;
+    const char* end;
+};
+
+// [["price", "size", ...], ...]; fields past the size are skipped
+inline bool readLevels(JsonScanner& s, std::vector<BookLevel>& out) {
+    return s.forEachElement([&] {
+        BookLevel level{};
+        int field = 0;
+        bool ok = s.forEachElement([&] {
+            if (field >= 2) {
+                ++field;
+                return s.skipValue();
+            }
+            std::string_view text;
+            if (!s.readString(text)) return false;
+            if (field == 0) {
+                level.priceText = text;
+                if (!JsonScanner::toDouble(text, level.price)) return false;
+            } else {
+                level.quantityText = text;
+                if (!JsonScanner::toDouble(text, level.quantity)) return false;
+            }
+            ++field;
+            return true;
+        });
+        if (!ok || field < 2) return false;
+        out.push_back(level);
+        return true;
+    });
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Steady-clock nanoseconds; the time base for every latency stamp
+inline int64_t latencyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Log-linear (HDR-style) histogram of nanosecond durations. Each power of two
+// is split into 32 sub-buckets, so any recorded value is reported to within
+// ~3% over the full 64-bit range in a fixed 15 KB. record() is wait-free and
+// safe from any number of threads; readers see a slightly stale but usable
+// picture while writers are active.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    void record(int64_t ns);
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return maxValue.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    // Smallest value v such that at least q (0..1] of recorded samples are <= v,
+    // up to bucket resolution. 0 if nothing has been recorded.
+    uint64_t percentile(double q) const;
+
+    void reset();
+
+    // Adds other's samples to this one
+    void merge(const LatencyHistogram& other);
+
+private:
+    static size_t bucketOf(uint64_t value);
+    static uint64_t highestInBucket(size_t bucket);
+
+    std::atomic<uint64_t> buckets[kBucketCount] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> maxValue{0};
+};
+
+// Hot-path stages, each measured between two stamps
+enum class LatencyStage {
+    Parse,            // websocket receive -> message parsed
+    Apply,            // parsed -> levels applied and checksum verified
+    Publish,          // applied -> snapshot visible to readers
+    FeedTotal,        // websocket receive -> snapshot visible to readers
+    Simulate,         // trade submitted -> simulation result ready
+    PublishToResult,  // snapshot published -> simulation result ready
+    Count
+};
+
+const char* latencyStageName(LatencyStage stage);
+
+// Stamps carried with one feed message; zero means "not reached"
+struct LatencyTrace {
+    int64_t receiveNs = 0;
+    int64_t parsedNs = 0;
+    int64_t appliedNs = 0;
+    int64_t publishedNs = 0;
+};
+
+struct LatencySummary {
+    uint64_t count = 0;
+    uint64_t p50Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t p999Ns = 0;
+    uint64_t maxNs = 0;
+    double meanNs = 0.0;
+};
+
+// Histograms, one per stage. latencyStats() is the process-wide set;
+// writers on other cores (e.g. ShardedFeed's shards) keep their own and
+// merge them in when read, so they do not contend on its cache lines.
+class LatencyStats {
+public:
+    void record(LatencyStage stage, int64_t ns) { histograms[static_cast<size_t>(stage)].record(ns); }
+
+    // Records every feed stage the trace got through
+    void record(const LatencyTrace& trace);
+
+    LatencySummary summary(LatencyStage stage) const;
+    const LatencyHistogram& histogram(LatencyStage stage) const { return histograms[static_cast<size_t>(stage)]; }
+    void reset();
+    void merge(const LatencyStats& other);
+
+private:
+    LatencyHistogram histograms[static_cast<size_t>(LatencyStage::Count)];
+};
+
+LatencyStats& latencyStats();
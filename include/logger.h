@@ -1,3 +1,195 @@
 #pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
+
+// Asynchronous logger. Callers only capture a fixed-size binary record
+// (timestamp, format string pointer, raw arguments) into a lock-free ring
+// owned by their thread; a background writer thread does all formatting and
+// I/O. Logging from the feed path therefore costs a few stores, never a
+// syscall or a lock.
+//
+// Usage: LOG_WARN("Orderbook", "gap: expected {}, got {}", expected, actual);
+// Format and tag must be string literals (only their pointers are stored).
+// Each {} is replaced by the next argument.
+
+enum class LogLevel : uint8_t { Debug, Info, Warn, Error, Off };
+
+// What a producer does when its ring is full
+enum class LogOverflowPolicy : uint8_t {
+    Drop,  // discard the record and count it (default; never stalls the caller)
+    Block  // yield until the writer frees a slot (backpressure, lossless)
+};
+
+// Levels below this are compiled out entirely
+#ifndef TRADESIM_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define TRADESIM_LOG_MIN_LEVEL 1  // Info
+#else
+#define TRADESIM_LOG_MIN_LEVEL 0  // Debug
+#endif
+#endif
+
+struct LogArg {
+    enum class Type : uint8_t { Int, UInt, Double, Bool, Text };
+    Type type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        bool b;
+        struct {
+            uint16_t offset;
+            uint16_t length;
+        } text;
+    };
+};
+
+// One log line in binary form. String arguments are copied into the
+// record's text area (and truncated if they do not fit).
+struct LogRecord {
+    static constexpr size_t kMaxArgs = 8;
+    static constexpr size_t kTextCapacity = 192;
+
+    int64_t timestampNs;  // system_clock time since epoch
+    const char* tag;
+    const char* format;
+    LogLevel level;
+    uint8_t argCount;
+    uint16_t textUsed;
+    LogArg args[kMaxArgs];
+    char text[kTextCapacity];
+
+    void push(std::string_view value) {
+        if (argCount == kMaxArgs) return;
+        size_t n = std::min(value.size(), kTextCapacity - textUsed);
+        LogArg& arg = args[argCount++];
+        arg.type = LogArg::Type::Text;
+        arg.text.offset = textUsed;
+        arg.text.length = static_cast<uint16_t>(n);
+        if (n) std::memcpy(text + textUsed, value.data(), n);
+        textUsed = static_cast<uint16_t>(textUsed + n);
+    }
+    void push(const char* value) { push(std::string_view(value ? value : "(null)")); }
+    void push(const std::string& value) { push(std::string_view(value)); }
+    void push(char value) { push(std::string_view(&value, 1)); }
+    void push(bool value) {
+        if (argCount == kMaxArgs) return;
+        args[argCount].type = LogArg::Type::Bool;
+        args[argCount++].b = value;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value>::type push(T value) {
+        if (argCount == kMaxArgs) return;
+        LogArg& arg = args[argCount++];
+        if (std::is_floating_point<T>::value) {
+            arg.type = LogArg::Type::Double;
+            arg.d = static_cast<double>(value);
+        } else if (std::is_signed<T>::value) {
+            arg.type = LogArg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else {
+            arg.type = LogArg::Type::UInt;
+            arg.u = static_cast<uint64_t>(value);
+        }
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type push(T value) {
+        push(static_cast<typename std::underlying_type<T>::type>(value));
+    }
+};
+
+class Logger {
+public:
+    // Process-wide logger; the writer thread starts on first use
+    static Logger& instance();
+
+    bool enabled(LogLevel level) const {
+        return static_cast<uint8_t>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+    void setLevel(LogLevel level) { minLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(minLevel.load(std::memory_order_relaxed)); }
+
+    void setOverflowPolicy(LogOverflowPolicy policy) { overflow.store(policy, std::memory_order_relaxed); }
+
+    // Redirects output (default stderr). Records already queued may go to
+    // either stream. Returns false if the file cannot be opened.
+    bool openFile(const std::string& path);
+
+    // Blocks until everything logged before the call has been written
+    void flush();
+
+    // Records discarded so far under LogOverflowPolicy::Drop
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    template <typename... Args>
+    void write(LogLevel level, const char* tag, const char* format, const Args&... args) {
+        LogRecord* record = claim();
+        if (!record) return;
+        record->level = level;
+        record->tag = tag;
+        record->format = format;
+        record->argCount = 0;
+        record->textUsed = 0;
+        int expand[] = {0, (record->push(args), 0)...};
+        (void)expand;
+        commit();
+    }
+
+    ~Logger();
+
+    struct Ring;  // per-thread record queue, defined in logger.cpp
+
+private:
+    class Writer;
+
+    Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Next free slot in the calling thread's ring (stamped with the time), or
+    // nullptr if the record was dropped
+    LogRecord* claim();
+    void commit();
+
+    std::atomic<uint8_t> minLevel{static_cast<uint8_t>(LogLevel::Info)};
+    std::atomic<LogOverflowPolicy> overflow{LogOverflowPolicy::Drop};
+    std::atomic<uint64_t> dropped{0};
+    Writer* writer;
+};
+
+// Compatibility shim for the old synchronous call; logs at Info level
 void log(const std::string& msg);
+
+#define TRADESIM_LOG(level, tag, ...)                                          \
+    do {                                                                       \
+        Logger& tradesimLogger = Logger::instance();                           \
+        if (tradesimLogger.enabled(level)) tradesimLogger.write(level, tag, __VA_ARGS__); \
+    } while (0)
+
+#if TRADESIM_LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(tag, ...) TRADESIM_LOG(LogLevel::Debug, tag, __VA_ARGS__)
+#else
+#define LOG_DEBUG(tag, ...) do {} while (0)
+#endif
+#if TRADESIM_LOG_MIN_LEVEL <= 1
+#define LOG_INFO(tag, ...) TRADESIM_LOG(LogLevel::Info, tag, __VA_ARGS__)
+#else
+#define LOG_INFO(tag, ...) do {} while (0)
+#endif
+#if TRADESIM_LOG_MIN_LEVEL <= 2
+#define LOG_WARN(tag, ...) TRADESIM_LOG(LogLevel::Warn, tag, __VA_ARGS__)
+#else
+#define LOG_WARN(tag, ...) do {} while (0)
+#endif
+#if TRADESIM_LOG_MIN_LEVEL <= 3
+#define LOG_ERROR(tag, ...) TRADESIM_LOG(LogLevel::Error, tag, __VA_ARGS__)
+#else
+#define LOG_ERROR(tag, ...) do {} while (0)
+#endif
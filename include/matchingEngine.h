@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "exchange.h"
+#include "instrument.h"
+#include "orderbook.h"
+#include "tradeSim.h"
+
+enum class OrderType { Market, Limit, PostOnly, ImmediateOrCancel };
+
+// TradeConfig::orderType text: "market", "limit", "post-only" or "ioc"
+bool parseOrderType(std::string_view text, OrderType& out);
+
+struct MatchingConfig {
+    InstrumentSpec spec;                 // must be the book's grid
+    FeeTier fees = Okx::kFeeTiers[0];
+    size_t depth = 400;                  // levels per side kept for sweeps and queue sizes
+    // Share of each size decrease at a resting order's price taken from ahead
+    // of it (trades and cancels ahead); the rest is cancels behind it.
+    // 1 = every decrease moves the order up, 0 = only crossing fills it.
+    double frontShare = 0.5;
+    size_t reserveOrders = 1 << 16;      // pool nodes allocated up front
+};
+
+struct SimOrder {
+    Side side = Side::Buy;
+    OrderType type = OrderType::Limit;
+    double price = 0.0;     // limit; ignored for Market
+    double quantity = 0.0;  // base asset
+    uint64_t tag = 0;       // caller's, echoed on fills
+};
+
+using OrderId = uint64_t;  // 0 = no order
+
+struct SimFill {
+    OrderId order;    // resting order; 0 for taker fills (match them on tag)
+    uint64_t tag;
+    Side side;
+    bool maker;
+    bool complete;    // last fill of the order
+    double price;     // average over the levels swept, for taker fills
+    double quantity;
+    double fee;
+    int64_t timestampNs;   // book time of the fill
+    int64_t sinceSubmitNs;
+};
+
+struct MatchingStats {
+    uint64_t submitted = 0;
+    uint64_t rejected = 0;   // post-only that would cross, or no quantity on the grid
+    uint64_t canceled = 0;   // by cancel(), and IOC/market remainders
+    uint64_t completed = 0;  // filled in full
+    double makerQuantity = 0.0;
+    double takerQuantity = 0.0;
+    double makerNotional = 0.0;
+    double takerNotional = 0.0;
+    double fees = 0.0;
+    uint64_t restedFills = 0;        // orders that rested and then filled in full
+    double totalTimeToFillNs = 0.0;  // over those
+    int64_t maxTimeToFillNs = 0;
+
+    // Maker share of filled quantity, as in TradeResult::makerTakerRatio
+    double makerTakerRatio() const {
+        double total = makerQuantity + takerQuantity;
+        return total > 0.0 ? makerQuantity / total : 0.0;
+    }
+    double meanTimeToFillSeconds() const { return restedFills ? totalTimeToFillNs / restedFills / 1e9 : 0.0; }
+};
+
+// Simulated matching of limit, post-only, IOC and market orders against a
+// real book stream. Simulated orders never enter the real book: a taker
+// order sweeps the latest book up to its limit, and a resting order keeps an
+// estimate of the visible quantity ahead of it at its price.
+//
+// Queue model, per book update at a resting order's price:
+// - growth joins behind it;
+// - a decrease moves it up by frontShare of the decrease, never past the
+//   level's remaining size;
+// - at the touch, the part of a decrease beyond the quantity ahead trades
+//   against the order (maker fill);
+// - a book that crosses its price (e.g. best ask at or below a resting bid)
+//   fills the rest at its price as maker.
+// Each simulated order is matched independently of the others.
+//
+// Orders are pooled intrusive nodes, levels are FIFO queues found through a
+// hash of their tick, and each order records its queue position as a mark
+// against a per-level count of quantity consumed, so submit, cancel and fill
+// are O(1) and an update costs O(levels with resting orders).
+//
+// Not thread-safe: submit and cancel from the feed thread (e.g. another
+// observer, or a replay loop), like onPublish.
+class MatchingEngine : public BookObserver {
+public:
+    explicit MatchingEngine(const MatchingConfig& config = MatchingConfig());
+
+    void onPublish(const OrderBookSnapshot& snapshot) override;
+
+    // Matches against the latest book. Returns the id of the order left
+    // resting, or 0 if nothing rests (filled, rejected, or an IOC/market
+    // remainder canceled). Fills go to the fill buffer.
+    OrderId submit(const SimOrder& order);
+
+    // False if the order is not resting (filled, canceled, or unknown)
+    bool cancel(OrderId id);
+
+    bool isResting(OrderId id) const { return node(id) != nullptr; }
+    double remaining(OrderId id) const;   // base quantity; 0 if not resting
+    double queueAhead(OrderId id) const;  // estimated base quantity ahead; 0 if not resting
+
+    size_t restingOrders() const { return resting; }
+    size_t activeLevels() const { return active.size(); }
+    const MatchingStats& stats() const { return totals; }
+
+    // Moves the fills since the last call into out (replacing its contents).
+    // Fills accumulate until drained.
+    void drainFills(std::vector<SimFill>& out);
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct OrderNode {
+        uint32_t next = kNone;
+        uint32_t prev = kNone;
+        uint32_t level = kNone;  // kNone while free
+        uint32_t generation = 1;
+        double mark = 0.0;       // level consumption at which the order reaches the front
+        int64_t lots = 0;        // remaining
+        int64_t submitNs = 0;
+        uint64_t tag = 0;
+    };
+
+    struct Level {
+        int64_t ticks = 0;
+        Side side = Side::Buy;
+        int64_t visibleLots = 0;  // real book's size at this price
+        double consumed = 0.0;    // lots taken from the front so far
+        uint32_t head = kNone;
+        uint32_t tail = kNone;
+        uint32_t activeSlot = 0;  // position in active
+        bool armed = true;        // false while the book still shows what the orders swept
+    };
+
+    const OrderNode* node(OrderId id) const;
+    int64_t visibleLots(Side side, int64_t ticks) const;  // -1 if deeper than the kept book
+    int64_t sweep(Side side, int64_t limitTicks, bool limited, int64_t lots, uint64_t tag);
+    uint32_t levelFor(Side side, int64_t ticks);
+    void updateLevel(uint32_t index, int64_t lots, bool atTouch);
+    void fillResting(uint32_t order, int64_t lots);
+    void unlink(uint32_t order);
+    void releaseLevel(uint32_t index);
+    void record(OrderId id, uint64_t tag, Side side, bool maker, bool complete, double price, double quantity,
+                int64_t sinceSubmitNs);
+
+    MatchingConfig config;
+
+    // Latest book, top config.depth levels
+    OrderBookSide bids;
+    OrderBookSide asks;
+    int64_t bookNs = 0;
+
+    std::vector<OrderNode> nodes;
+    std::vector<uint32_t> freeNodes;
+    std::vector<Level> levels;
+    std::vector<uint32_t> freeLevels;
+    std::vector<uint32_t> active;  // levels with resting orders
+    std::unordered_map<int64_t, uint32_t> bidLevels;  // by tick
+    std::unordered_map<int64_t, uint32_t> askLevels;
+    size_t resting = 0;
+
+    std::vector<SimFill> fills;
+    MatchingStats totals;
+};
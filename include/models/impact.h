@@ -1,5 +1,104 @@
 #pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct OrderBookSnapshot;
+
+// Almgren-Chriss linear impact model, in quote currency and base units.
+// Trading n units over an interval tau costs epsilon + eta * n / tau per unit
+// (temporary) and moves the price by gamma * n for good (permanent).
+struct ImpactParameters {
+    double sigma = 0.0;         // volatility of the price, quote per sqrt(second)
+    double epsilon = 0.0;       // fixed cost per unit, e.g. half the spread
+    double eta = 0.0;           // temporary impact, quote per (unit per second)
+    double gamma = 0.0;         // permanent impact, quote per unit
+    double riskAversion = 1e-6; // lambda, per quote currency; 0 = minimize expected cost only
+};
+
+// Inputs to calibrateImpact beyond the book itself
+struct ImpactCalibration {
+    double annualVolatility = 0.6;
+    double riskAversion = 1e-6;
+    double resilienceSeconds = 10.0;  // time for the visible book to refill
+    double permanentFraction = 0.1;   // share of the book's price concession that persists
+};
+
+// Sigma from the mid and an annual volatility, epsilon from the spread, and
+// eta/gamma from the slope of the visible book (price move per unit of
+// depth, both sides averaged)
+ImpactParameters calibrateImpact(const OrderBookSnapshot& book, const ImpactCalibration& calibration = {});
+
+struct ImpactEstimate {
+    double expectedCost = 0.0;  // E[shortfall]: spread + temporary + permanent
+    double variance = 0.0;      // Var[shortfall] from the price moving while holding
+    double spreadCost = 0.0;
+    double temporaryCost = 0.0;
+    double permanentCost = 0.0;
+    double urgency = 0.0;       // kappa~ * T; 0 = straight-line schedule
+};
+
+// Units still to trade at t = 0, tau, ..., N * tau (holdings[0] = quantity,
+// holdings[N] = 0); trade j sells holdings[j-1] - holdings[j]
+struct ExecutionTrajectory {
+    std::vector<double> holdings;
+    double interval = 0.0;  // tau, seconds
+};
+
+// Optimal Almgren-Chriss schedules over a fixed number of intervals.
+//
+// With linear impact the normalized schedule x_j / X depends on one number,
+// the urgency u = sqrt(lambda * sigma^2 / eta~) * T, and cost and variance
+// scale exactly with X and X^2. The constructor tabulates the schedule and
+// its two sums over a log-spaced grid of u once; a query then calibrates u,
+// interpolates between two grid rows (cubic Hermite in log u) and scales by
+// size. A query is O(1) and a handful of transcendentals, cheap enough to
+// run per tick.
 class MarketImpactModel {
 public:
-    double compute(double qty, double duration);
+    explicit MarketImpactModel(const ImpactParameters& parameters = ImpactParameters(), size_t intervals = 32);
+
+    // Expected cost of the optimal schedule for qty over duration seconds,
+    // under the stored parameters
+    double compute(double qty, double duration) const;
+
+    ImpactEstimate estimate(const ImpactParameters& p, double qty, double duration) const;
+    ExecutionTrajectory trajectory(const ImpactParameters& p, double qty, double duration) const;
+
+    // The same from the closed form, without the grid; for checks
+    ImpactEstimate exactEstimate(const ImpactParameters& p, double qty, double duration) const;
+    ExecutionTrajectory exactTrajectory(const ImpactParameters& p, double qty, double duration) const;
+
+    void setParameters(const ImpactParameters& p) { params = p; }
+    const ImpactParameters& parameters() const { return params; }
+    size_t intervals() const { return steps; }
+
+private:
+    // Sums over the normalized schedule at one urgency, as logs with their
+    // derivatives in log(urgency) for cubic Hermite interpolation
+    struct Row {
+        double tradeSquares;    // sum of (n_j / X)^2
+        double holdingSquares;  // sum of (x_j / X)^2 for j = 1..N
+        double logTrade, logHolding;
+        double logTradeSlope, logHoldingSlope;
+    };
+
+    struct Query {
+        double tau;
+        double etaTilde;
+        double urgency;
+    };
+
+    Query prepare(const ImpactParameters& p, double duration) const;
+    void locate(double urgency, size_t& row, double& weight) const;
+    void normalizedSchedule(double urgency, double* holdings) const;
+    void scheduleSums(const double* holdings, double& tradeSquares, double& holdingSquares) const;
+    ImpactEstimate finish(const ImpactParameters& p, double qty, const Query& q, double tradeSquares,
+                          double holdingSquares) const;
+
+    ImpactParameters params;
+    size_t steps;
+    std::vector<Row> rows;                // one per grid urgency
+    std::vector<double> schedules;        // (steps + 1) holdings per grid urgency
+    std::vector<double> scheduleSlopes;   // their derivatives in log(urgency)
 };
@@ -1,5 +1,64 @@
 #pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "seqlock.h"
+
+// FTRL-Proximal settings (McMahan et al. 2013): per-coordinate learning rate
+// alpha / (beta + sqrt(sum of squared gradients)), plus L1/L2 shrinkage
+struct FtrlConfig {
+    double alpha = 0.05;
+    double beta = 1.0;
+    double l1 = 0.0;
+    double l2 = 1e-3;
+    double lossHalfLife = 2000.0;  // examples, for the running log loss
+};
+
+// Weights as readers see them, one consistent set per publication
+struct LogisticWeights {
+    static constexpr size_t kFeatures = 4;
+
+    double bias = 0.0;
+    double w[kFeatures] = {};
+    double logLoss = 0.0;   // running average over recent examples
+    uint64_t examples = 0;  // updates applied so far
+};
+
+using FeatureVector = std::array<double, LogisticWeights::kFeatures>;
+
+// Feature columns for batch scoring: columns[k][i] is feature k of row i
+using FeatureColumns = std::array<const double*, LogisticWeights::kFeatures>;
+
+// Online logistic regression over a small fixed feature vector. One thread
+// trains with update(); after every step the weights are republished
+// through a SeqLock, so any number of readers predict concurrently without
+// locks and without ever stalling the trainer.
 class LogisticRegression {
 public:
-    double predictProbability(double feature);
+    explicit LogisticRegression(const FtrlConfig& config = FtrlConfig());
+
+    // Reader side
+    double predictProbability(const FeatureVector& x) const;
+    LogisticWeights weights() const { return published.load(); }
+
+    // Scores n rows against one load of the weights. The linear part runs
+    // over whole columns, so it vectorizes; out may not alias the columns.
+    void predictBatch(const FeatureColumns& columns, size_t n, double* out) const;
+
+    // Writer side: one FTRL step on (x, label), then publishes. Returns the
+    // probability predicted before the step.
+    double update(const FeatureVector& x, bool label);
+
+    static double sigmoid(double z);
+
+private:
+    static constexpr size_t kCoordinates = LogisticWeights::kFeatures + 1;  // bias first
+
+    FtrlConfig config;
+    double lossDecay;
+    double z[kCoordinates] = {};
+    double n[kCoordinates] = {};
+    LogisticWeights current;  // writer's copy
+    SeqLock<LogisticWeights> published;
 };
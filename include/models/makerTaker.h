@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "models/logistics.h"
+#include "orderbook.h"
+#include "tradeSim.h"
+
+struct MakerTakerConfig {
+    size_t depthLevels = 5;         // levels per side for imbalance and depth
+    size_t horizonUpdates = 50;     // a passive order unfilled after this many updates would have crossed
+    double featureHalfLife = 1000;  // updates, for standardization and the volatility estimate
+    FtrlConfig ftrl;
+};
+
+// Predicts the maker share of an order worked passively at the touch: the
+// probability that a bid (ask) resting at the best price fills before the
+// market moves away from it or horizonUpdates pass, after which the order
+// would have to cross and pay taker.
+//
+// Trains itself from the book stream as an Orderbook observer. Each update
+// opens one example per side at the current best price; later updates label
+// it filled once the touch trades through the price (the best bid drops below
+// a resting bid, or the ask comes down to it), missed once the touch moves
+// away, or missed at the horizon. Features are spread (bps), top-level
+// imbalance towards the order's side, log depth and an EWMA of mid returns,
+// each standardized by its running mean and spread.
+//
+// onPublish runs on the feed thread and never allocates; predictions read
+// the latest features and weights through SeqLocks from any thread.
+class MakerTakerModel : public BookObserver {
+public:
+    explicit MakerTakerModel(const MakerTakerConfig& config = MakerTakerConfig());
+
+    void onPublish(const OrderBookSnapshot& snapshot) override;
+
+    // Reader side; 0.5 until trained
+    double predict(Side side) const { return regression.predictProbability(features(side)); }
+
+    // Standardized features of the latest book, oriented to side
+    FeatureVector features(Side side) const;
+
+    const LogisticRegression& model() const { return regression; }
+    uint64_t filledCount() const { return filled.load(std::memory_order_relaxed); }
+    uint64_t missedCount() const { return missed.load(std::memory_order_relaxed); }
+
+private:
+    struct Pending {
+        FeatureVector x;
+        double price;
+        bool open;
+    };
+
+    // Running mean/variance of one raw feature
+    struct Standardizer {
+        double mean = 0.0;
+        double variance = 0.0;
+        bool seeded = false;
+
+        double apply(double value, double decay);
+    };
+
+    void label(Pending& example, bool wasFilled);
+
+    MakerTakerConfig config;
+    double decay;
+    LogisticRegression regression;
+
+    // Writer-owned state
+    std::vector<Pending> bids;  // ring of horizonUpdates examples per side
+    std::vector<Pending> asks;
+    uint64_t updates = 0;
+    double lastMid = 0.0;
+    double squaredReturn = 0.0;  // EWMA of squared log mid returns
+    Standardizer standardizers[LogisticWeights::kFeatures];
+
+    SeqLock<FeatureVector> latest;  // oriented to the bid side
+    std::atomic<uint64_t> filled{0};
+    std::atomic<uint64_t> missed{0};
+};
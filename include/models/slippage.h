@@ -1,5 +1,121 @@
 #pragma once
-class SlippageModel {
+
+#include <cstddef>
+#include <cstdint>
+#include "orderbook.h"
+#include "seqlock.h"
+#include "tradeSim.h"
+
+struct SlippageConfig {
+    double minDepthFraction = 1e-3;      // size ladder, log-spaced, as fractions of the visible side
+    double maxDepthFraction = 0.9;
+    double learningRate = 0.05;          // bps per step, before per-coordinate scaling
+    double gradientHalfLife = 20000.0;   // samples; older gradients fade so the model tracks regimes
+    double volatilityHalfLife = 1000.0;  // updates, for the mid-return EWMA
+};
+
+// Slippage of one market order vs mid, in bps, at the model's quantiles
+struct SlippageBand {
+    double low = 0.0;     // 10th percentile
+    double median = 0.0;
+    double high = 0.0;    // 90th percentile
+    bool beyondDepth = false;  // larger than the visible side; extrapolated
+};
+
+// One prediction against the full book walk of simulateMarketOrder
+struct SlippageCheck {
+    SlippageBand predicted;
+    double actualBps = 0.0;
+    bool filled = false;  // the visible book covered the order
+};
+
+// Running agreement of predictions with actual fills
+class SlippageValidation {
+public:
+    void add(const SlippageCheck& check);
+
+    uint64_t count() const { return checks; }
+    double meanAbsErrorBps() const { return checks ? absError / checks : 0.0; }
+    double belowLow() const { return checks ? underLow / checks : 0.0; }        // ideally 0.1
+    double belowMedian() const { return checks ? underMedian / checks : 0.0; }  // ideally 0.5
+    double belowHigh() const { return checks ? underHigh / checks : 0.0; }      // ideally 0.9
+
+private:
+    uint64_t checks = 0;
+    double underLow = 0.0, underMedian = 0.0, underHigh = 0.0;  // ties count half
+    double absError = 0.0;
+};
+
+// Slippage quantiles as a function of order size and market state, learned
+// from the book stream. On every update it walks a ladder of kSizes order
+// sizes on both sides through the snapshot's prefix sums and takes one
+// quantile-regression step (pinball loss, per-coordinate adaptive rates) per
+// fill and quantile.
+//
+// Size is the fraction u of the visible side's notional. Each ladder size
+// keeps its own linear model a + b * volatility of the slippage above the
+// half spread, so a prediction is
+//   half spread + model at u   (bps)
+// with the model interpolated linearly in u between the two ladder sizes
+// around it (the ladder is log-spaced, so finding them is one log), scaled
+// down to zero below the smallest and continued along its last slope (never
+// downwards) past the largest, including beyond the visible depth. O(1).
+//
+// Trains as an Orderbook observer (feed thread, no allocation); weights and
+// the latest market state are published through SeqLocks for readers.
+class SlippageModel : public BookObserver {
 public:
-    double estimate(double usdQty);
+    static constexpr double kQuantiles[3] = {0.1, 0.5, 0.9};
+    static constexpr size_t kSizes = 8;
+    static constexpr size_t kFeatures = 2;  // intercept, volatility
+
+    explicit SlippageModel(const SlippageConfig& config = SlippageConfig());
+
+    void onPublish(const OrderBookSnapshot& snapshot) override;
+
+    // Reader side, against the latest book or a given one
+    SlippageBand quantiles(double usdQty, Side side) const;
+    SlippageBand quantiles(const OrderBookSnapshot& book, double usdQty, Side side) const;
+
+    // Median slippage cost of a usdQty buy, in quote currency
+    double estimate(double usdQty) const;
+
+    // Validation mode: predicts for book and compares with simulateMarketOrder
+    // on the same book. Reader side; records the simulation's latency stages
+    // like any other simulateMarketOrder call.
+    SlippageCheck validate(const OrderBookSnapshot& book, Side side, double usdQty) const;
+
+    uint64_t sampleCount() const { return published.load().samples; }
+
+private:
+    struct Weights {
+        double w[3][kSizes][kFeatures] = {};
+        uint64_t samples = 0;
+    };
+
+    struct MarketState {
+        double mid = 0.0;
+        double halfSpreadBps = 0.0;
+        double volatilityBps = 0.0;
+        double depthUsd[2] = {};  // buy side (asks), sell side (bids)
+    };
+
+    SlippageBand predict(const Weights& weights, const MarketState& state, double usdQty, Side side) const;
+    MarketState stateOf(const OrderBookSnapshot& book, double volatilityBps) const;
+    void train(size_t size, double volatilityBps, double residualBps);
+
+    SlippageConfig config;
+    double gradientDecay;
+    double volatilityDecay;
+    double logLadderRatio;     // log ratio of consecutive ladder sizes
+    double ladder[kSizes];     // ladder sizes as fractions of the visible side
+
+    // Writer-owned state
+    Weights current;
+    double gradientSquares[3][kSizes][kFeatures] = {};
+    double lastMid = 0.0;
+    double squaredReturn = 0.0;
+
+    SeqLock<Weights> published;
+    SeqLock<MarketState> latest;
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bookSnapshot.h"
+#include "exchange.h"
+#include "threadPool.h"
+#include "tradeSim.h"
+
+struct MonteCarloConfig {
+    size_t paths = 100000;
+    double volatility = 0.6;       // annualized volatility of the mid (TradeConfig::volatility)
+    double horizonSeconds = 1.0;   // decision to fill; the mid drifts over it
+    double depthVolatility = 0.3;  // lognormal sd of the visible depth, as one factor per path
+    double confidence = 0.95;      // VaR/CVaR level
+    uint64_t seed = 42;
+};
+
+// Distribution of one cost component over all paths, in quote currency.
+// Costs are losses, so VaR is the upper quantile and CVaR the mean beyond it.
+struct CostDistribution {
+    double mean = 0.0;
+    double stdDev = 0.0;
+    double var = 0.0;
+    double cvar = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+};
+
+struct MonteCarloResult {
+    uint64_t version = 0;       // snapshot the paths were drawn from
+    size_t paths = 0;
+    size_t unfilledPaths = 0;   // the scaled book ran out before the full size
+    double midPrice = 0.0;      // decision price the slippage is measured against
+    CostDistribution slippage;  // (average price - mid) * quantity, signed so positive is a cost
+    CostDistribution fees;
+    CostDistribution totalCost; // slippage + fees
+    double elapsedUs = 0.0;
+};
+
+// Execution-cost distribution of a market order that fills horizonSeconds
+// after the decision. Each path draws
+//   - a GBM move of the whole book: prices scale by exp(r), r ~ N(-s^2/2, s^2)
+//     with s = volatility * sqrt(horizon / year);
+//   - a depth factor L ~ lognormal(depthVolatility) applied to every level.
+// Filling q on a book scaled by L is filling q / L on the snapshot and
+// scaling back, so each path is one binary search on the snapshot's prefix
+// sums rather than a level walk.
+//
+// Randomness comes from Philox counters keyed by (seed, path), and the
+// statistics are taken over paths in path order, so a result depends on the
+// inputs only, not on the thread count or scheduling.
+class MonteCarloEngine {
+public:
+    // threads counts the caller; 0 = one per hardware thread
+    explicit MonteCarloEngine(size_t threads = 0);
+
+    // Not thread-safe: per-path buffers are reused between runs
+    MonteCarloResult run(const OrderBookSnapshot& book, Side side, double quantity, const FeeTier& fees,
+                         const MonteCarloConfig& config = MonteCarloConfig());
+
+    size_t threadCount() const { return pool.size(); }
+
+private:
+    ThreadPool pool;
+    DepthIndex scratchDepth;  // for snapshots built without prefix sums
+    std::vector<double> slippage;
+    std::vector<double> fees;
+    std::vector<double> total;
+    std::vector<uint8_t> unfilled;
+};
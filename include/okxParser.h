@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string_view>
+#include "bookMessage.h"
+
+// Single-pass in-place scan of an OKX depth push (books, books5, bbo-tbt).
+// Numbers are converted with std::from_chars, so parsing is
+// locale-independent and allocation-free once out's vectors are warm.
+// Control messages come back as NotBook and should be handled with a full
+// JSON parser.
+BookParseStatus parseOkxBookMessage(std::string_view message, BookMessage& out);
@@ -1,18 +1,77 @@
 #pragma once
 
-#include <map>
 #include <string>
-#include <mutex>
+#include <string_view>
+#include <atomic>
 #include <vector>
 #include <utility>
 #include <chrono>
+#include <cstdint>
+#include "priceLadder.h"
+#include "bookMessage.h"
+#include "exchange.h"
+#include "seqlock.h"
+#include "snapshotPublisher.h"
+#include "latency.h"
 
+// Outcome of applying one feed message to the book
+enum class BookUpdateResult {
+    Applied,         // snapshot or delta applied and verified
+    Ignored,         // not a book message, or a delta while awaiting a snapshot
+    ResyncRequired   // sequence gap, checksum mismatch or level off the grid; book was reset
+};
+
+// Writer-side hook: called on the feed thread after every book update, with
+// the snapshot readers now see. If readers pin every snapshot slot, the
+// update is not published (see Orderbook::unpublishedCount); observers still
+// get it, in a writer-private snapshot with a version of its own. Readers of
+// published snapshots then see a gap in the versions. Must not block; it
+// delays the feed.
+class BookObserver {
+public:
+    virtual ~BookObserver() = default;
+    virtual void onPublish(const OrderBookSnapshot& snapshot) = 0;
+};
+
+// Live L2 book with a single writer (the feed thread) and lock-free readers.
+// The writer mutates private ladders, then publishes the top of book through
+// a SeqLock and the full book as an immutable OrderBookSnapshot. Readers never
+// touch the ladders, so they neither block the writer nor wait on it.
 class Orderbook {
 public:
-    Orderbook() = default;
+    // maxDepth fixes the per-side ladder capacity; OKX "books" streams 400 levels.
+    // publishDepth caps how many levels per side go into published snapshots.
+    // spec sets the tick/lot grid levels are matched on (see InstrumentSpec).
+    // A derived spec (the default) is refined from the decimals of the venue's
+    // text: every snapshot takes the finest precision seen so far, and a delta
+    // finer than the grid raises it and asks for a resync.
+    explicit Orderbook(size_t maxDepth = 400, size_t publishDepth = 400,
+                       const InstrumentSpec& spec = InstrumentSpec());
+
+    // Applies an OKX L2 depth message. "snapshot" messages replace the book,
+    // "update" messages are deltas where a zero size deletes the level. Deltas
+    // must chain via prevSeqId and the top 25 levels must match the checksum.
+    // Writer side: call from the feed thread only.
+    // If trace is given, the parsed/applied/published stamps are filled in.
+    BookUpdateResult updateFromJson(const std::string& jsonString, LatencyTrace* trace = nullptr);
 
-    // Updates the entire snapshot from a raw JSON string (OKX L2 depth format)
-    void updateFromJson(const std::string& jsonString);
+    // Same for any venue's depth payload, decoded by Venue (see exchange.h)
+    template <class Venue>
+    BookUpdateResult update(std::string_view payload, LatencyTrace* trace = nullptr);
+
+    // Applies a message already decoded by Venue::decode. Delta ordering and
+    // checksums follow the venue's rules; the plain overload is OKX's.
+    template <class Venue>
+    BookUpdateResult apply(const BookMessage& message, LatencyTrace* trace = nullptr);
+    BookUpdateResult apply(const BookMessage& message, LatencyTrace* trace = nullptr) {
+        return apply<Okx>(message, trace);
+    }
+
+    // Resets the book; deltas are ignored until the next snapshot. Writer side.
+    void invalidate();
+
+    // True once a snapshot has been applied and no gap/mismatch seen since
+    bool isSynced() const { return synced.load(std::memory_order_acquire); }
 
     // Returns best bid (highest buy price)
     double getBestBid() const;
@@ -20,6 +79,20 @@ public:
     // Returns best ask (lowest sell price)
     double getBestAsk() const;
 
+    // Consistent best bid/ask pair, read wait-free from the SeqLock
+    TopOfBook getTopOfBook() const { return topOfBook.load(); }
+
+    // Pins the latest published snapshot; it stays valid while the handle lives
+    SnapshotHandle snapshot() const { return publisher.acquire(); }
+
+    // Version of the latest published snapshot (0 before the first one).
+    // Increasing, with gaps for updates only observers saw.
+    uint64_t getVersion() const { return publisher.version(); }
+
+    // Updates readers never saw as a snapshot because every slot was pinned;
+    // they reached observers all the same
+    uint64_t unpublishedCount() const { return unpublished.load(std::memory_order_relaxed); }
+
     // Simulates a market buy (consumes from asks)
     double simulateMarketBuy(double usdAmount);
 
@@ -30,12 +103,56 @@ public:
     std::vector<std::pair<double, double>> getBidLevels(size_t depth = 10) const;
     std::vector<std::pair<double, double>> getAskLevels(size_t depth = 10) const;
 
+    // Same, refilling a caller-owned buffer so repeated polling reuses its
+    // capacity instead of allocating. Returns the number of levels written.
+    size_t getBidLevels(std::vector<std::pair<double, double>>& out, size_t depth = 10) const;
+    size_t getAskLevels(std::vector<std::pair<double, double>>& out, size_t depth = 10) const;
+
     // Returns the time of last update
     std::chrono::steady_clock::time_point getLastUpdateTime() const;
 
+    // Adds a writer-side observer; observers run in the order added. Add them
+    // before the feed starts; each must outlive the book's updates.
+    void addObserver(BookObserver* o) { observers.push_back(o); }
+
 private:
-    std::map<double, double, std::greater<>> bids;  // price -> quantity
-    std::map<double, double> asks;
-    mutable std::mutex mtx;
-    std::chrono::steady_clock::time_point lastUpdateTime;
+    // Copies the ladders into a free snapshot slot and updates the top of book
+    void publish();
+
+    // Applies the levels of a message that passed the sequence check. False
+    // if a level's text is off the instrument grid; the book is then partly
+    // updated and must be invalidated.
+    bool applyLevels(const BookMessage& message, bool isSnapshot);
+
+    // Raises the derived grid's decimals to cover every level's text
+    void learnGrid(const BookMessage& message);
+
+    // Marks the book synced at seqId and publishes it
+    BookUpdateResult commit(int64_t seqId, LatencyTrace* trace);
+
+    // Writer-owned state
+    PriceLadder bids;  // best (highest) first
+    PriceLadder asks;  // best (lowest) first
+    size_t publishDepth;
+    int64_t lastSeqId = -1;
+    uint64_t updateCount = 0;
+    bool deriveGrid;
+    int priceDecimals;  // finest seen so far, when deriving the grid
+    int sizeDecimals;
+    std::vector<BookObserver*> observers;
+    OrderBookSnapshot observerBook;  // for observers when no slot is free
+
+    // Reader-visible state
+    std::atomic<bool> synced{false};
+    std::atomic<uint64_t> unpublished{0};
+    SeqLock<TopOfBook> topOfBook;
+    SnapshotPublisher publisher;
 };
+
+// Defined in orderbook.cpp for each venue policy
+extern template BookUpdateResult Orderbook::update<Okx>(std::string_view, LatencyTrace*);
+extern template BookUpdateResult Orderbook::update<Binance>(std::string_view, LatencyTrace*);
+extern template BookUpdateResult Orderbook::update<Bybit>(std::string_view, LatencyTrace*);
+extern template BookUpdateResult Orderbook::apply<Okx>(const BookMessage&, LatencyTrace*);
+extern template BookUpdateResult Orderbook::apply<Binance>(const BookMessage&, LatencyTrace*);
+extern template BookUpdateResult Orderbook::apply<Bybit>(const BookMessage&, LatencyTrace*);
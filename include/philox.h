@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3"). The output is a pure function of (key,
+// counter), so the k-th draw of path p can be computed on any thread in any
+// order: simulations stay reproducible whatever the thread count.
+class Philox4x32 {
+public:
+    struct Block {
+        uint32_t v[4];
+    };
+
+    explicit Philox4x32(uint64_t seed) : key0(static_cast<uint32_t>(seed)), key1(static_cast<uint32_t>(seed >> 32)) {}
+
+    // 128 random bits for counter (stream, index)
+    Block operator()(uint64_t stream, uint64_t index) const {
+        Block c{{static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), static_cast<uint32_t>(stream),
+                 static_cast<uint32_t>(stream >> 32)}};
+        uint32_t k0 = key0, k1 = key1;
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(kMul0) * c.v[0];
+            uint64_t p1 = static_cast<uint64_t>(kMul1) * c.v[2];
+            c = Block{{static_cast<uint32_t>(p1 >> 32) ^ c.v[1] ^ k0, static_cast<uint32_t>(p1),
+                       static_cast<uint32_t>(p0 >> 32) ^ c.v[3] ^ k1, static_cast<uint32_t>(p0)}};
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+        return c;
+    }
+
+    // Two independent standard normals from one block (Box-Muller on two
+    // 53-bit uniforms in (0, 1])
+    void normals(uint64_t stream, uint64_t index, double& z0, double& z1) const {
+        Block b = (*this)(stream, index);
+        double u0 = toUnit(b.v[0], b.v[1]);
+        double u1 = toUnit(b.v[2], b.v[3]);
+        double radius = std::sqrt(-2.0 * std::log(u0));
+        double angle = 6.283185307179586 * u1;
+        z0 = radius * std::cos(angle);
+        z1 = radius * std::sin(angle);
+    }
+
+private:
+    static constexpr uint32_t kMul0 = 0xD2511F53;
+    static constexpr uint32_t kMul1 = 0xCD9E8D57;
+    static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+    static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+    // (0, 1]: never 0, so log() above is finite
+    static double toUnit(uint32_t hi, uint32_t lo) {
+        uint64_t bits = (static_cast<uint64_t>(hi) << 21) | (lo >> 11);
+        return (static_cast<double>(bits) + 1.0) * (1.0 / 9007199254740992.0);
+    }
+
+    uint32_t key0;
+    uint32_t key1;
+};
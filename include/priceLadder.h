@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "bookSnapshot.h"
+#include "instrument.h"
+
+enum class LadderSide { Bid, Ask };
+
+// Exchange-formatted price/size strings, kept so checksums can be computed
+// over the exact text the venue sent (e.g. "0.10" and "0.1" hash differently)
+struct LevelText {
+    static constexpr size_t kMaxLength = 23;
+
+    char price[kMaxLength];
+    char quantity[kMaxLength];
+    uint8_t priceLength = 0;
+    uint8_t quantityLength = 0;
+
+    std::string_view priceView() const { return {price, priceLength}; }
+    std::string_view quantityView() const { return {quantity, quantityLength}; }
+    void assign(std::string_view priceText, std::string_view quantityText);
+};
+
+// Fixed-capacity price ladder stored as a sorted struct-of-arrays.
+// Levels are keyed and sized in integer ticks/lots on the instrument's grid;
+// doubles are only produced when the book is published (copyTop), so the
+// conversion runs over contiguous integers.
+//
+// Storage runs best-to-worst inside a buffer with free room on both ends, so
+// any top-N read is a contiguous run from the front. Updates cluster near the
+// top, so inserts and deletes usually shift only the few levels above them,
+// and evicting the worst level is just an index bump.
+// Level indexes in the public API always count from the best (0 = top).
+class PriceLadder {
+public:
+    PriceLadder(LadderSide side, size_t capacity, const InstrumentSpec& spec = InstrumentSpec());
+
+    // Sets the size at a price level; a size <= 0 removes the level.
+    // When the ladder is full, a level better than the worst one evicts it and
+    // a level worse than the worst one is dropped (returns false).
+    // The optional text is the venue's original formatting of the level.
+    bool set(int64_t ticks, int64_t lots,
+             std::string_view priceText = {}, std::string_view quantityText = {});
+
+    // Same, rounding the doubles to the nearest tick/lot
+    bool set(double price, double quantity,
+             std::string_view priceText = {}, std::string_view quantityText = {}) {
+        return set(spec.toTicks(price), spec.toLots(quantity), priceText, quantityText);
+    }
+
+    // Removes a level. Returns false if the price was not present.
+    bool erase(int64_t ticks);
+    bool erase(double price) { return erase(spec.toTicks(price)); }
+
+    void clear();
+
+    size_t size() const { return end - begin; }
+    size_t capacity() const { return levelCapacity; }
+    bool empty() const { return end == begin; }
+    LadderSide side() const { return ladderSide; }
+    const InstrumentSpec& instrument() const { return spec; }
+    // Switches the grid; only while empty, since stored levels are on the old one
+    void setInstrument(const InstrumentSpec& instrument) { spec = instrument; }
+
+    double bestPrice() const { return empty() ? 0.0 : spec.fromTicks(priceTicks[begin]); }
+    double bestQuantity() const { return empty() ? 0.0 : spec.fromLots(sizeLots[begin]); }
+
+    double priceAt(size_t i) const { return spec.fromTicks(priceTicks[begin + i]); }
+    double quantityAt(size_t i) const { return spec.fromLots(sizeLots[begin + i]); }
+    int64_t ticksAt(size_t i) const { return priceTicks[begin + i]; }
+    int64_t lotsAt(size_t i) const { return sizeLots[begin + i]; }
+    const LevelText& textAt(size_t i) const { return textPool[textIds[begin + i]]; }
+
+    // Resizes out to the best n levels (n <= size()) and writes them
+    // best-first, as ticks/lots and as doubles
+    void copyTop(size_t n, OrderBookSide& out) const;
+
+private:
+    // Storage index of the first level that is not better than ticks
+    size_t lowerBound(int64_t ticks) const;
+    bool isBetter(int64_t a, int64_t b) const { return ladderSide == LadderSide::Bid ? a > b : a < b; }
+
+    // Moves storage [from, from + n) to start at to, across every per-level array
+    void moveLevels(size_t from, size_t to, size_t n);
+    // Slides the live range back to the middle of the buffer
+    void recenter();
+
+    LadderSide ladderSide;
+    InstrumentSpec spec;
+    size_t levelCapacity;
+
+    // Per-level storage, best first; live levels are [begin, end)
+    std::vector<int64_t> priceTicks;  // ordering key
+    std::vector<int64_t> sizeLots;
+    std::vector<uint32_t> textIds;   // index into textPool
+    size_t begin = 0;
+    size_t end = 0;
+
+    // Text is cold (checksums only), so levels carry a small handle instead of
+    // dragging 48 bytes through every shift
+    std::vector<LevelText> textPool;
+    std::vector<uint32_t> freeTextIds;
+};
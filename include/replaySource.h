@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "feedRecording.h"
+#include "feedSource.h"
+#include "okxParser.h"
+#include "orderbook.h"
+
+enum class ReplayPacing {
+    AsFastAsPossible,  // back to back; for backtests and regression runs
+    Original           // reproduce the recorded inter-arrival gaps (scaled by speed)
+};
+
+// Feeds a recorded session (see FeedRecorder) into an Orderbook. Payloads
+// are parsed straight out of the memory-mapped file, so replay costs the
+// same parse/apply work as live data with no I/O or copies in between.
+// Either drive it with step() on the calling thread (deterministic; the
+// caller can inspect the book after every message) or start() it like the
+// live client, but not both at once.
+class ReplaySource : public FeedSource {
+public:
+    ReplaySource(const std::string& path, Orderbook& book,
+                 ReplayPacing pacing = ReplayPacing::AsFastAsPossible, double speed = 1.0);
+    ~ReplaySource() override { stop(); }
+
+    // False if the file is missing or not a session log
+    bool isOpen() const { return reader.isOpen(); }
+
+    // Applies the next recorded message. Returns false at end of file.
+    // Pacing is not applied here; the caller owns the clock.
+    bool step(BookUpdateResult* result = nullptr);
+
+    void start() override;
+    void stop() override;
+    bool finished() const override { return done.load(std::memory_order_acquire); }
+
+    uint64_t messageCount() const { return messages.load(std::memory_order_relaxed); }
+    uint64_t resyncCount() const { return resyncs.load(std::memory_order_relaxed); }
+
+private:
+    BookUpdateResult applyRecord(const FeedRecord& record);
+    void run();
+
+    FeedReader reader;
+    Orderbook& orderbook;
+    ReplayPacing pacing;
+    double speed;
+    BookMessage bookMessage;  // reused across messages
+
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> resyncs{0};
+    std::atomic<bool> running{false};
+    std::atomic<bool> done{false};
+    std::thread worker;
+};
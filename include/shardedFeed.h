@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "bookRegistry.h"
+#include "feedSource.h"
+#include "latency.h"
+
+struct ShardedFeedConfig {
+    std::string url = "wss://ws.okx.com:8443/ws/v5/public";  // empty: no sockets, feed via submit()
+    size_t shards = 2;               // worker threads doing decode + book maintenance
+    size_t symbolsPerConnection = 50;
+    std::vector<int> shardCpus;      // CPU to pin each shard's worker to; empty = unpinned
+    size_t queueCapacity = 4096;     // messages per (connection, shard) queue; power of two
+    bool busyPoll = false;           // idle workers yield instead of sleeping (pinned cores)
+};
+
+// Streams every OKX book of the registry over a few batched websocket
+// connections and spreads decoding and book maintenance over worker
+// threads. Routing, subscriptions and decoding are OKX's (the Okx policy,
+// see exchange.h); books of other venues are skipped with a warning and
+// stream through BasicWebSocketClient<Venue> instead.
+//
+// Each symbol is owned by one shard, so its book keeps a single writer; a
+// hot symbol only competes with the symbols of its own shard, and a worker
+// drains its connections in bounded batches so one busy connection cannot
+// starve another.
+//
+// Connection threads only stamp, route (by scanning for instId) and copy
+// the payload into a lock-free single-producer queue per (connection,
+// shard); the copy reuses the slot's buffer, so the hand-off does not
+// allocate in steady state. A full queue makes the connection wait.
+class ShardedFeed : public FeedSource {
+public:
+    // Books are taken from registry now; add them all beforehand
+    ShardedFeed(BookRegistry& registry, const ShardedFeedConfig& config = ShardedFeedConfig());
+    ~ShardedFeed() override;
+    ShardedFeed(const ShardedFeed&) = delete;
+    ShardedFeed& operator=(const ShardedFeed&) = delete;
+
+    // Moves a symbol to a given shard (e.g. to isolate a hot one); before start()
+    bool assignShard(const std::string& symbol, size_t shard);
+
+    void start() override;
+    void stop() override;
+
+    size_t shardCount() const { return shards.size(); }
+    size_t connectionCount() const { return connections.size(); }
+    size_t symbolCount() const { return routes.size(); }
+
+    // Routes a raw payload as if it had arrived on connection. For replays
+    // and benchmarks; each connection index must be fed by one thread only.
+    void submit(size_t connection, std::string_view payload, int64_t receiveNs);
+
+    uint64_t messageCount() const;  // payloads applied or rejected by the books
+    uint64_t resyncCount() const { return resyncs.load(std::memory_order_relaxed); }
+
+    // Adds the shards' feed-stage latencies to out (e.g. latencyStats()).
+    // Each shard records into its own histograms, never the process-wide ones.
+    void mergeLatency(LatencyStats& out) const;
+
+private:
+    struct Route {
+        std::string symbol;
+        Orderbook* book;
+        size_t shard;
+        size_t connection;
+    };
+    struct Ring;
+    struct Shard;
+    struct Connection;
+
+    // Index into routes, or SIZE_MAX if the symbol is not streamed
+    size_t findRoute(std::string_view symbol) const;
+    Ring& ring(size_t connection, size_t shard) const;
+    void enqueue(size_t connection, size_t route, std::string_view payload, int64_t receiveNs);
+    void handleEvent(std::string_view payload);
+    void connect(Connection& connection);
+    void subscribe(Connection& connection, const char* op, const std::vector<size_t>& symbols);
+    void resubscribe(size_t route);
+    void runShard(size_t shard);
+    void process(Shard& shard, size_t route, const std::string& payload, int64_t receiveNs);
+
+    ShardedFeedConfig config;
+    std::vector<Route> routes;  // sorted by symbol
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<std::unique_ptr<Ring>> rings;  // connection-major
+
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> resyncs{0};
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "bookSnapshot.h"
+#include "sharedMemory.h"
+
+// One book published into shared memory for other processes on the same
+// host (see SharedBookPublisher for the writer). The region is a fixed
+// description block, then a seqlock-protected state line holding the
+// sequence, version, timestamp, level counts and top of book, then the level
+// arrays as (price, quantity) pairs. Every shared word is a lock-free
+// std::atomic, so a reader racing the writer reads well-defined (if
+// discarded) values, exactly as SeqLock does in-process.
+//
+// Readers link only tradesim_shm (this header, sharedMemory.h and their
+// sources); nothing here needs the rest of the simulator.
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared books need lock-free 64-bit atomics");
+
+// Fixed description, written once before the first publication
+struct SharedBookHeader {
+    static constexpr char kMagic[8] = {'T', 'S', 'S', 'H', 'B', 'K', '0', '1'};
+    static constexpr uint32_t kVersion = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t levels;  // capacity per side
+    char exchange[16];  // NUL-terminated
+    char symbol[48];
+    double tickSize;
+    double lotSize;
+    std::atomic<uint64_t> closed;  // set when the publisher shuts down
+    char reserved[24];
+};
+
+// Seqlock-protected state; one cache line, so top of book is one line read
+struct alignas(64) SharedBookState {
+    std::atomic<uint64_t> sequence;     // odd while the writer is mid-update
+    std::atomic<uint64_t> bookVersion;  // OrderBookSnapshot::version
+    std::atomic<uint64_t> timestampNs;  // writer's steady clock
+    std::atomic<uint64_t> counts;       // bid levels | ask levels << 32
+    std::atomic<uint64_t> top[4];       // bid price, bid quantity, ask price, ask quantity
+};
+
+namespace sharedBookLayout {
+constexpr size_t kStateOffset = 128;
+constexpr size_t kLevelsOffset = kStateOffset + sizeof(SharedBookState);
+
+// Bytes of a region holding levels per side
+constexpr size_t regionSize(size_t levels) {
+    return kLevelsOffset + 2 * 2 * levels * sizeof(uint64_t);
+}
+} // namespace sharedBookLayout
+
+static_assert(sizeof(SharedBookHeader) <= sharedBookLayout::kStateOffset, "header overlaps the state line");
+static_assert(sizeof(SharedBookState) == 64, "state must fill exactly one cache line");
+
+// Region name for a venue's book, e.g. "/tradesim.OKX.BTC-USDT". Characters
+// outside [A-Za-z0-9._-] become '_'.
+std::string sharedBookName(const std::string& exchange, const std::string& symbol);
+
+struct SharedTopOfBook {
+    uint64_t version = 0;
+    int64_t timestampNs = 0;  // publisher's steady clock, comparable across processes on one host
+    double bidPrice = 0.0;    // 0 with no bids
+    double bidQuantity = 0.0;
+    double askPrice = 0.0;    // 0 with no asks
+    double askQuantity = 0.0;
+};
+
+struct SharedDepth {
+    uint64_t version = 0;
+    int64_t timestampNs = 0;
+    OrderBookSide bids;
+    OrderBookSide asks;
+};
+
+// Read-only view of a published book. Reads copy out a consistent book
+// without any system call or lock: they retry only if they overlap a
+// publication. Books published between two reads are not queued; a reader
+// always sees the latest one.
+class SharedBookReader {
+public:
+    // Maps the region; false if it does not exist or is not a shared book
+    bool open(const std::string& name);
+    bool open(const std::string& exchange, const std::string& symbol) {
+        return open(sharedBookName(exchange, symbol));
+    }
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    size_t levels() const { return header->levels; }
+    const char* exchange() const { return header->exchange; }
+    const char* symbol() const { return header->symbol; }
+    double tickSize() const { return header->tickSize; }
+    double lotSize() const { return header->lotSize; }
+
+    // True once the publisher has shut down; the last book stays readable
+    bool writerClosed() const { return header->closed.load(std::memory_order_acquire) != 0; }
+
+    // Changes with every publication (0 before the first); poll it to wait
+    // for a new book without copying one
+    uint64_t sequence() const { return state->sequence.load(std::memory_order_acquire); }
+
+    // Latest top of book. False before the first publication, or if the
+    // writer died mid-update.
+    bool top(SharedTopOfBook& out) const;
+
+    // Latest book, up to maxLevels per side. out's vectors keep their
+    // capacity, so steady-state reads do not allocate.
+    bool read(SharedDepth& out, size_t maxLevels = SIZE_MAX) const;
+
+private:
+    SharedMemory region;
+    const SharedBookHeader* header = nullptr;
+    const SharedBookState* state = nullptr;
+    const std::atomic<uint64_t>* words = nullptr;  // bid pairs, then ask pairs
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "instrument.h"
+#include "orderbook.h"
+#include "sharedBook.h"
+
+// Publishes every book of an Orderbook into a shared-memory region named
+// sharedBookName(exchange, symbol), for SharedBookReader in other processes.
+// Runs on the feed thread as an observer: a publication is a seqlock write of
+// the top levels, with no system call, allocation or wait on readers.
+// The region is removed when the publisher is destroyed; readers that still
+// have it mapped keep the last book and see writerClosed().
+class SharedBookPublisher : public BookObserver {
+public:
+    SharedBookPublisher(const std::string& exchange, const std::string& symbol,
+                        const InstrumentSpec& spec = InstrumentSpec(), size_t levels = 50);
+    ~SharedBookPublisher() override;
+    SharedBookPublisher(const SharedBookPublisher&) = delete;
+    SharedBookPublisher& operator=(const SharedBookPublisher&) = delete;
+
+    // False if the region could not be created; publications are then dropped
+    bool isOpen() const { return region.isOpen(); }
+    const std::string& name() const { return regionName; }
+    size_t levels() const { return capacity; }
+
+    void onPublish(const OrderBookSnapshot& snapshot) override;
+
+private:
+    std::string regionName;
+    size_t capacity;
+    SharedMemory region;
+    SharedBookHeader* header = nullptr;
+    SharedBookState* state = nullptr;
+    std::atomic<uint64_t>* words = nullptr;
+};
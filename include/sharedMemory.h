@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Named shared-memory region: POSIX shm_open on Unix, a named file mapping
+// on Windows. One process creates it read-write; others open it read-only.
+// Move-only.
+class SharedMemory {
+public:
+    SharedMemory() = default;
+    ~SharedMemory() { close(); }
+    SharedMemory(SharedMemory&& other) noexcept;
+    SharedMemory& operator=(SharedMemory&& other) noexcept;
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    // Creates (or replaces) the region, zero-filled, and maps it read-write.
+    // The name is removed again by close(); mappings already open elsewhere
+    // stay valid. name is "/tradesim..." style; see sharedBookName().
+    bool create(const std::string& name, size_t size);
+
+    // Maps an existing region read-only; false if there is none
+    bool open(const std::string& name);
+
+    void close();
+
+    bool isOpen() const { return bytes != nullptr; }
+    char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    char* bytes = nullptr;
+    size_t length = 0;
+    bool owner = false;  // created it, so removes the name on close
+    std::string regionName;
+#ifdef _WIN32
+    void* mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "bookSnapshot.h"
+
+class SnapshotPublisher;
+
+// Read-side reference to a published snapshot. While a handle is alive the
+// writer will not reuse its slot, so the snapshot stays immutable. Move-only.
+class SnapshotHandle {
+public:
+    SnapshotHandle() = default;
+    SnapshotHandle(SnapshotHandle&& other) noexcept;
+    SnapshotHandle& operator=(SnapshotHandle&& other) noexcept;
+    SnapshotHandle(const SnapshotHandle&) = delete;
+    SnapshotHandle& operator=(const SnapshotHandle&) = delete;
+    ~SnapshotHandle() { release(); }
+
+    explicit operator bool() const { return snapshot != nullptr; }
+    const OrderBookSnapshot& operator*() const { return *snapshot; }
+    const OrderBookSnapshot* operator->() const { return snapshot; }
+    const OrderBookSnapshot* get() const { return snapshot; }
+
+    void release();
+
+private:
+    friend class SnapshotPublisher;
+    SnapshotHandle(const OrderBookSnapshot* snap, std::atomic<uint32_t>* count)
+        : snapshot(snap), readers(count) {}
+
+    const OrderBookSnapshot* snapshot = nullptr;
+    std::atomic<uint32_t>* readers = nullptr;
+};
+
+// RCU-style publication of immutable snapshots from one writer thread to any
+// number of readers. The writer fills a slot no reader holds and swaps it in
+// with a single atomic store; readers pin the current slot with a per-slot
+// reference count. Neither side ever blocks on the other.
+//
+// The slots double as a snapshot pool: a slot goes back into rotation once
+// its last handle is released, and keeps its array capacity when it does, so
+// steady-state publishing performs no allocations.
+class SnapshotPublisher {
+public:
+    // reserveDepth pre-sizes each slot for that many levels per side
+    explicit SnapshotPublisher(size_t slotCount = 8, size_t reserveDepth = 0);
+
+    // Writer side. Returns a free slot to fill, or nullptr if readers still
+    // hold every other slot (the caller skips this publication rather than wait).
+    OrderBookSnapshot* beginWrite();
+
+    // Publishes the slot returned by the last beginWrite() and stamps its version
+    void publish();
+
+    // Writer side. Consumes the next version without publishing, for a
+    // snapshot handed out some other way; published versions skip it.
+    uint64_t reserveVersion() { return ++issuedVersion; }
+
+    // Reader side. Empty handle until the first publish().
+    SnapshotHandle acquire() const;
+
+    // Version of the latest published snapshot. Versions increase but can
+    // have gaps, where reserveVersion() took one.
+    uint64_t version() const { return publishedVersion.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        OrderBookSnapshot snapshot;
+        std::atomic<uint32_t> readers{0};
+    };
+
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    std::unique_ptr<Slot[]> slots;
+    size_t slotCount;
+    size_t writeSlot = kNone;
+    size_t nextProbe = 0;
+    std::atomic<size_t> current{kNone};
+    uint64_t issuedVersion = 0;  // writer-only
+    std::atomic<uint64_t> publishedVersion{0};
+};
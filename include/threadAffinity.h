@@ -0,0 +1,5 @@
+#pragma once
+
+// Pins the calling thread to one logical CPU (0-based). Returns false if the
+// platform does not support it (macOS) or the CPU does not exist.
+bool pinCurrentThread(int cpu);
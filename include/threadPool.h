@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork-join loops. parallelFor hands out
+// task indices through an atomic counter, the calling thread takes part,
+// and it returns once every task has run. One loop at a time: callers on
+// different threads are serialized.
+class ThreadPool {
+public:
+    // threads counts the caller; 0 = one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads that run tasks, including the caller of parallelFor
+    size_t size() const { return workers.size() + 1; }
+
+    // Calls task(i) for every i in [0, count)
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void runWorker();
+    void drain();
+
+    std::vector<std::thread> workers;
+    std::mutex loopMutex;  // one parallelFor at a time
+
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* current = nullptr;
+    size_t taskCount = 0;
+    std::atomic<size_t> nextTask{0};
+    size_t busy = 0;         // workers inside the current loop
+    uint64_t generation = 0; // bumped per loop so workers join each one once
+    bool stopping = false;
+};
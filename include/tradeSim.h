@@ -1,33 +1,42 @@
 #pragma once
 #include <vector>
 #include <chrono>
+#include "bookSnapshot.h"
+#include "exchange.h"
 
-struct OrderLevel {
-    double price;
-    double quantity;
+enum class Side { Buy, Sell };
+
+struct TradeResult {
+    double executedQuantity;    // How much was filled
+    double averagePrice;        // Weighted avg execution price
+    double totalCost;           // total cost including fees (for buys)
+    double totalProceeds;       // total proceeds net of fees (for sells)
+    double slippage;            // execution price vs mid price
+    double feesPaid;            // total fees
+    double marketImpact;        // liquidity consumed ratio
+    double makerTakerRatio;     // 0 = all taker (for market orders)
+    double internalLatency;     // microseconds from snapshot publication to result
 };
 
-using OrderBookSide = std::vector<OrderLevel>;
+// Taker/maker fee for a fill of tradeValue (tier 1 = 0.1% taker)
+double calculateFees(double tradeValue, int feeTier, bool isMaker);
 
-struct OrderBookSnapshot {
-    OrderBookSide bids;
-    OrderBookSide asks;
-    std::chrono::steady_clock::time_point timestamp;
+// Base quantity and notional filled by sweeping one side
+struct FillEstimate {
+    double quantity;
+    double notional;
 };
 
-enum class Side { Buy, Sell };
+// Fills quantity against levels using their prefix sums: O(log n)
+FillEstimate fillFromDepth(const OrderBookSide& levels, const DepthIndex& depth, double quantity);
 
-struct TradeResult {
-    double executedQuantity;
-    double averagePrice;
-    double totalCost;
-    double totalProceeds;
-    double slippage;
-    double feesPaid;
-    double marketImpact;
-    double makerTakerRatio;
-    double internalLatency;
+// Same in whole lots, for indexed sides on the grid of spec. The notional
+// stays a double: tick * lot products overflow int64 on fine grids.
+struct LotFill {
+    int64_t lots;
+    double notional;
 };
+LotFill fillLots(const OrderBookSide& levels, const DepthIndex& depth, const InstrumentSpec& spec, int64_t lots);
 
 TradeResult simulateMarketOrder(
     const OrderBookSnapshot& book,
@@ -36,3 +45,12 @@ TradeResult simulateMarketOrder(
     int feeTier,
     std::chrono::steady_clock::time_point tradeTimestamp
 );
+
+// Same, charging a venue's rates, e.g. Okx::feeTier(tier) (see exchange.h)
+TradeResult simulateMarketOrder(
+    const OrderBookSnapshot& book,
+    Side side,
+    double quantity,
+    const FeeTier& fees,
+    std::chrono::steady_clock::time_point tradeTimestamp
+);
@@ -4,30 +4,60 @@
 #include <string>
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "orderbook.h"
+#include "bookMessage.h"
+#include "exchange.h"
+#include "feedSource.h"
+#include "feedRecording.h"
 
-class WebSocketClient {
+// Streams one venue's depth channel for a single instrument into a book.
+// Venue is an exchange policy (see exchange.h); the client is defined in
+// webSocketClient.cpp for Okx, Binance and Bybit.
+template <class Venue>
+class BasicWebSocketClient : public FeedSource {
 public:
-    WebSocketClient(const std::string& url, Orderbook& ob);
-    ~WebSocketClient();
+    BasicWebSocketClient(const std::string& url, Orderbook& ob,
+                         const std::string& instId = std::string(Venue::kDefaultSymbol));
+    ~BasicWebSocketClient() override;
 
-    void start();
-    void stop();
+    void start() override;
+    void stop() override;
+
+    // Appends every received payload to recorder (which must outlive the
+    // client). Set before start(); nullptr disables recording.
+    void setRecorder(FeedRecorder* r) { recorder = r; }
+
+    // Times the book lost sync (gap, checksum mismatch, malformed message)
+    uint64_t resyncCount() const { return resyncs.load(std::memory_order_relaxed); }
 
 private:
     void connect();
-    void subscribeToOrderbook();
 
     std::string endpointUrl;
+    std::string instrument;
     Orderbook& orderbook;
     ix::WebSocket webSocket_;
     std::atomic<bool> running;
+    BookMessage bookMessage;  // reused by the message callback to avoid allocations
+    FeedRecorder* recorder = nullptr;
+    std::atomic<uint64_t> resyncs{0};
 
     void runLoop();  // <- This is the reconnection loop
     void subscribeToOrderbook();
+    void resubscribeToOrderbook();  // forces a fresh snapshot after a gap
     void handleMessage(const std::string& message);
+    void handleControlMessage(const std::string& message);
 
     std::thread workerThread;
     std::mutex mtx;
     std::condition_variable cv;
 };
+
+extern template class BasicWebSocketClient<Okx>;
+extern template class BasicWebSocketClient<Binance>;
+extern template class BasicWebSocketClient<Bybit>;
+
+// The OKX "books" client used by the GUI and the benchmarks
+using WebSocketClient = BasicWebSocketClient<Okx>;
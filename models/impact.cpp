@@ -1,5 +1,243 @@
 #include "models/impact.h"
+#include "bookSnapshot.h"
+#include "config.h"
+#include <algorithm>
+#include <cmath>
 
-double MarketImpactModel::compute(double qty, double duration) {
-    return 0.01 * qty / duration; // Simplified model
+namespace {
+
+// Urgency grid: row 0 is u = 0 (straight line), then kGridRows - 1 rows
+// log-spaced over [kMinUrgency, kMaxUrgency]. Past the top the schedule is
+// one trade in the first interval to within 1e-5 of the size; queries there
+// are rare and fall back to the closed form.
+constexpr size_t kGridRows = 513;
+constexpr double kMinUrgency = 1e-3;
+constexpr double kMaxUrgency = 1e4;
+const double kLogMinUrgency = std::log(kMinUrgency);
+const double kLogStep = (std::log(kMaxUrgency) - kLogMinUrgency) / (kGridRows - 2);
+constexpr double kSlopeStep = 1e-4;  // in log u, for the tabulated derivatives
+
+// Cubic Hermite basis at t in [0, 1] over one grid step
+struct Hermite {
+    double h00, h10, h01, h11;
+
+    explicit Hermite(double t) {
+        double t2 = t * t, t3 = t2 * t;
+        h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+        h10 = (t3 - 2.0 * t2 + t) * kLogStep;
+        h01 = -2.0 * t3 + 3.0 * t2;
+        h11 = (t3 - t2) * kLogStep;
+    }
+
+    double operator()(double f0, double slope0, double f1, double slope1) const {
+        return h00 * f0 + h10 * slope0 + h01 * f1 + h11 * slope1;
+    }
+};
+
+// Price move per unit of depth over one side: from the best level to the
+// last, per unit resting in front of the last
+double bookSlope(const OrderBookSide& side, const DepthIndex& depth) {
+    size_t n = side.size();
+    if (n < 2) return 0.0;
+    double ahead = depth.cumQuantity.size() == n ? depth.cumQuantity[n - 2] : 0.0;
+    if (depth.cumQuantity.size() != n)
+        for (size_t i = 0; i + 1 < n; ++i) ahead += side.quantities[i];
+    return ahead > 0.0 ? std::fabs(side.prices[n - 1] - side.prices[0]) / ahead : 0.0;
+}
+
+} // namespace
+
+ImpactParameters calibrateImpact(const OrderBookSnapshot& book, const ImpactCalibration& calibration) {
+    ImpactParameters p;
+    p.riskAversion = calibration.riskAversion;
+    if (book.bids.empty() || book.asks.empty()) return p;
+
+    double bid = book.bids.front().price;
+    double ask = book.asks.front().price;
+    p.sigma = (bid + ask) / 2.0 * calibration.annualVolatility / std::sqrt(kSecondsPerYear);
+    p.epsilon = std::max(0.0, ask - bid) / 2.0;
+
+    double bidSlope = bookSlope(book.bids, book.bidDepth);
+    double askSlope = bookSlope(book.asks, book.askDepth);
+    int sides = (bidSlope > 0.0) + (askSlope > 0.0);
+    double slope = sides ? (bidSlope + askSlope) / sides : 0.0;
+    p.eta = slope * calibration.resilienceSeconds;
+    p.gamma = slope * calibration.permanentFraction;
+    return p;
+}
+
+MarketImpactModel::MarketImpactModel(const ImpactParameters& parameters, size_t intervals)
+    : params(parameters), steps(std::max<size_t>(1, intervals)) {
+    const size_t width = steps + 1;
+    rows.resize(kGridRows);
+    schedules.resize(kGridRows * width);
+    scheduleSlopes.assign(kGridRows * width, 0.0);
+    std::vector<double> below(width), above(width);
+    for (size_t r = 0; r < kGridRows; ++r) {
+        double* x = &schedules[r * width];
+        Row& row = rows[r];
+        if (r == 0) {
+            normalizedSchedule(0.0, x);
+            scheduleSums(x, row.tradeSquares, row.holdingSquares);
+            row.logTrade = row.logHolding = row.logTradeSlope = row.logHoldingSlope = 0.0;  // unused
+            continue;
+        }
+        double logUrgency = kLogMinUrgency + (r - 1) * kLogStep;
+        normalizedSchedule(std::exp(logUrgency), x);
+        scheduleSums(x, row.tradeSquares, row.holdingSquares);
+        row.logTrade = std::log(row.tradeSquares);
+        row.logHolding = std::log(row.holdingSquares);
+
+        // Central differences in log u, well inside one grid step
+        normalizedSchedule(std::exp(logUrgency - kSlopeStep), below.data());
+        normalizedSchedule(std::exp(logUrgency + kSlopeStep), above.data());
+        double tradeBelow, holdingBelow, tradeAbove, holdingAbove;
+        scheduleSums(below.data(), tradeBelow, holdingBelow);
+        scheduleSums(above.data(), tradeAbove, holdingAbove);
+        row.logTradeSlope = (std::log(tradeAbove) - std::log(tradeBelow)) / (2.0 * kSlopeStep);
+        row.logHoldingSlope = (std::log(holdingAbove) - std::log(holdingBelow)) / (2.0 * kSlopeStep);
+        double* slope = &scheduleSlopes[r * width];
+        for (size_t j = 0; j < width; ++j) slope[j] = (above[j] - below[j]) / (2.0 * kSlopeStep);
+    }
+}
+
+// x_j / X = sinh(kappa (T - t_j)) / sinh(kappa T) with the discrete kappa of
+// cosh(kappa tau) = 1 + (kappa~ tau)^2 / 2, i.e. sinh(kappa tau / 2) =
+// kappa~ tau / 2. Written with exponentials so large urgencies do not
+// overflow.
+void MarketImpactModel::normalizedSchedule(double urgency, double* holdings) const {
+    const double n = static_cast<double>(steps);
+    double kappaTau = 2.0 * std::asinh(0.5 * urgency / n);
+    double whole = kappaTau * n;
+    if (whole <= 0.0) {
+        for (size_t j = 0; j <= steps; ++j) holdings[j] = 1.0 - j / n;
+        return;
+    }
+    double denominator = -std::expm1(-2.0 * whole);
+    for (size_t j = 0; j <= steps; ++j) {
+        double remaining = kappaTau * (n - j);
+        holdings[j] = std::exp(remaining - whole) * -std::expm1(-2.0 * remaining) / denominator;
+    }
+}
+
+void MarketImpactModel::scheduleSums(const double* holdings, double& tradeSquares, double& holdingSquares) const {
+    tradeSquares = 0.0;
+    holdingSquares = 0.0;
+    for (size_t j = 1; j <= steps; ++j) {
+        double trade = holdings[j - 1] - holdings[j];
+        tradeSquares += trade * trade;
+        holdingSquares += holdings[j] * holdings[j];
+    }
+}
+
+MarketImpactModel::Query MarketImpactModel::prepare(const ImpactParameters& p, double duration) const {
+    Query q;
+    q.tau = duration / steps;
+    // eta~ = eta - gamma tau / 2 must stay positive for the problem to be
+    // convex; slow schedules on a thin book can push it under, so keep at
+    // least half of eta
+    q.etaTilde = std::max(p.eta - 0.5 * p.gamma * q.tau, 0.5 * p.eta);
+    if (q.etaTilde > 0.0)
+        q.urgency = std::sqrt(p.riskAversion * p.sigma * p.sigma / q.etaTilde) * duration;
+    else
+        q.urgency = p.riskAversion > 0.0 && p.sigma > 0.0 ? kMaxUrgency : 0.0;  // free to trade at once
+    return q;
+}
+
+// Row r and the position in [0, 1] towards row r + 1. Below the grid the
+// position is linear in u (between u = 0 and the first row), inside it
+// linear in log u. Callers handle urgencies past the grid.
+void MarketImpactModel::locate(double urgency, size_t& row, double& weight) const {
+    if (urgency < kMinUrgency) {
+        row = 0;
+        weight = std::max(0.0, urgency / kMinUrgency);
+    } else {
+        double t = (std::log(urgency) - kLogMinUrgency) / kLogStep;
+        size_t i = std::min(static_cast<size_t>(t), kGridRows - 3);
+        row = i + 1;
+        weight = std::min(1.0, t - i);
+    }
+}
+
+ImpactEstimate MarketImpactModel::finish(const ImpactParameters& p, double qty, const Query& q,
+                                         double tradeSquares, double holdingSquares) const {
+    ImpactEstimate e;
+    e.spreadCost = p.epsilon * qty;
+    e.permanentCost = 0.5 * p.gamma * qty * qty;
+    e.temporaryCost = q.etaTilde / q.tau * qty * qty * tradeSquares;
+    e.expectedCost = e.spreadCost + e.permanentCost + e.temporaryCost;
+    e.variance = p.sigma * p.sigma * q.tau * qty * qty * holdingSquares;
+    e.urgency = q.urgency;
+    return e;
+}
+
+double MarketImpactModel::compute(double qty, double duration) const {
+    return estimate(params, qty, duration).expectedCost;
+}
+
+ImpactEstimate MarketImpactModel::estimate(const ImpactParameters& p, double qty, double duration) const {
+    qty = std::fabs(qty);
+    if (qty == 0.0 || duration <= 0.0) return ImpactEstimate();
+    Query q = prepare(p, duration);
+    if (q.urgency >= kMaxUrgency) return exactEstimate(p, qty, duration);
+    size_t r;
+    double t;
+    locate(q.urgency, r, t);
+    const Row& a = rows[r];
+    const Row& b = rows[r + 1];
+    if (r == 0)
+        return finish(p, qty, q, a.tradeSquares + t * (b.tradeSquares - a.tradeSquares),
+                      a.holdingSquares + t * (b.holdingSquares - a.holdingSquares));
+    Hermite h(t);
+    return finish(p, qty, q, std::exp(h(a.logTrade, a.logTradeSlope, b.logTrade, b.logTradeSlope)),
+                  std::exp(h(a.logHolding, a.logHoldingSlope, b.logHolding, b.logHoldingSlope)));
+}
+
+ExecutionTrajectory MarketImpactModel::trajectory(const ImpactParameters& p, double qty, double duration) const {
+    ExecutionTrajectory out;
+    qty = std::fabs(qty);
+    if (duration <= 0.0) return out;
+    Query q = prepare(p, duration);
+    if (q.urgency >= kMaxUrgency) return exactTrajectory(p, qty, duration);
+    size_t r;
+    double t;
+    locate(q.urgency, r, t);
+    const size_t width = steps + 1;
+    const double* a = &schedules[r * width];
+    const double* b = a + width;
+    const double* slopeA = &scheduleSlopes[r * width];
+    const double* slopeB = slopeA + width;
+    out.interval = q.tau;
+    out.holdings.resize(width);
+    if (r == 0) {
+        for (size_t j = 0; j < width; ++j) out.holdings[j] = qty * (a[j] + t * (b[j] - a[j]));
+    } else {
+        Hermite h(t);
+        for (size_t j = 0; j < width; ++j) out.holdings[j] = qty * h(a[j], slopeA[j], b[j], slopeB[j]);
+    }
+    return out;
+}
+
+ImpactEstimate MarketImpactModel::exactEstimate(const ImpactParameters& p, double qty, double duration) const {
+    qty = std::fabs(qty);
+    if (qty == 0.0 || duration <= 0.0) return ImpactEstimate();
+    Query q = prepare(p, duration);
+    std::vector<double> x(steps + 1);
+    normalizedSchedule(q.urgency, x.data());
+    double tradeSquares, holdingSquares;
+    scheduleSums(x.data(), tradeSquares, holdingSquares);
+    return finish(p, qty, q, tradeSquares, holdingSquares);
+}
+
+ExecutionTrajectory MarketImpactModel::exactTrajectory(const ImpactParameters& p, double qty,
+                                                       double duration) const {
+    ExecutionTrajectory out;
+    qty = std::fabs(qty);
+    if (duration <= 0.0) return out;
+    Query q = prepare(p, duration);
+    out.interval = q.tau;
+    out.holdings.resize(steps + 1);
+    normalizedSchedule(q.urgency, out.holdings.data());
+    for (double& x : out.holdings) x *= qty;
+    return out;
 }
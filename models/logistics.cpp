@@ -1,6 +1,79 @@
-#include "models/logistic.h"
+#include "models/logistics.h"
+#include <algorithm>
 #include <cmath>
 
-double LogisticRegression::predictProbability(double feature) {
-    return 1.0 / (1.0 + std::exp(-feature)); // Sigmoid
+namespace {
+
+constexpr size_t kBatchBlock = 256;  // rows per pass over the columns
+
+double logit(const LogisticWeights& weights, const FeatureVector& x) {
+    double z = weights.bias;
+    for (size_t k = 0; k < LogisticWeights::kFeatures; ++k) z += weights.w[k] * x[k];
+    return z;
+}
+
+} // namespace
+
+LogisticRegression::LogisticRegression(const FtrlConfig& config)
+    : config(config), lossDecay(std::exp2(-1.0 / std::max(1.0, config.lossHalfLife))) {
+    published.store(current);
+}
+
+double LogisticRegression::sigmoid(double z) {
+    // Split by sign so exp never overflows
+    if (z >= 0.0) return 1.0 / (1.0 + std::exp(-z));
+    double e = std::exp(z);
+    return e / (1.0 + e);
+}
+
+double LogisticRegression::predictProbability(const FeatureVector& x) const {
+    return sigmoid(logit(published.load(), x));
+}
+
+void LogisticRegression::predictBatch(const FeatureColumns& columns, size_t n, double* out) const {
+    const LogisticWeights weights = published.load();
+    for (size_t start = 0; start < n; start += kBatchBlock) {
+        size_t count = std::min(kBatchBlock, n - start);
+        double* z = out + start;
+        for (size_t i = 0; i < count; ++i) z[i] = weights.bias;
+        for (size_t k = 0; k < LogisticWeights::kFeatures; ++k) {
+            const double* column = columns[k] + start;
+            const double w = weights.w[k];
+            for (size_t i = 0; i < count; ++i) z[i] += w * column[i];
+        }
+        for (size_t i = 0; i < count; ++i) z[i] = sigmoid(z[i]);
+    }
+}
+
+double LogisticRegression::update(const FeatureVector& x, bool label) {
+    const double p = sigmoid(logit(current, x));
+    const double y = label ? 1.0 : 0.0;
+    const double error = p - y;
+
+    for (size_t i = 0; i < kCoordinates; ++i) {
+        double xi = i == 0 ? 1.0 : x[i - 1];
+        double g = error * xi;
+        double weight = i == 0 ? current.bias : current.w[i - 1];
+        double sigma = (std::sqrt(n[i] + g * g) - std::sqrt(n[i])) / config.alpha;
+        z[i] += g - sigma * weight;
+        n[i] += g * g;
+
+        // Closed-form proximal step; the bias is not shrunk towards zero
+        double l1 = i == 0 ? 0.0 : config.l1;
+        double l2 = i == 0 ? 0.0 : config.l2;
+        double next = 0.0;
+        if (std::fabs(z[i]) > l1) {
+            double sign = z[i] < 0.0 ? -1.0 : 1.0;
+            next = -(z[i] - sign * l1) / ((config.beta + std::sqrt(n[i])) / config.alpha + l2);
+        }
+        if (i == 0) current.bias = next;
+        else current.w[i - 1] = next;
+    }
+
+    double clipped = std::min(std::max(label ? p : 1.0 - p, 1e-15), 1.0);
+    double loss = -std::log(clipped);
+    current.logLoss = current.examples == 0 ? loss : lossDecay * current.logLoss + (1.0 - lossDecay) * loss;
+    ++current.examples;
+    published.store(current);
+    return p;
 }
@@ -0,0 +1,92 @@
+#include "models/makerTaker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+enum Feature { SpreadBps, Imbalance, LogDepth, VolatilityBps };
+
+constexpr double kMaxScore = 5.0;  // standardized features are clipped to +-5 sd
+
+} // namespace
+
+double MakerTakerModel::Standardizer::apply(double value, double decay) {
+    if (!seeded) {
+        mean = value;
+        seeded = true;
+        return 0.0;
+    }
+    // Scored against the statistics before this value
+    double score = variance > 0.0 ? (value - mean) / std::sqrt(variance) : 0.0;
+    double delta = value - mean;
+    mean += (1.0 - decay) * delta;
+    variance = decay * (variance + (1.0 - decay) * delta * delta);
+    return std::min(std::max(score, -kMaxScore), kMaxScore);
+}
+
+MakerTakerModel::MakerTakerModel(const MakerTakerConfig& config)
+    : config(config), decay(std::exp2(-1.0 / std::max(1.0, config.featureHalfLife))), regression(config.ftrl),
+      bids(std::max<size_t>(1, config.horizonUpdates), Pending{{}, 0.0, false}),
+      asks(std::max<size_t>(1, config.horizonUpdates), Pending{{}, 0.0, false}) {}
+
+FeatureVector MakerTakerModel::features(Side side) const {
+    FeatureVector x = latest.load();
+    if (side == Side::Sell) x[Imbalance] = -x[Imbalance];
+    return x;
+}
+
+void MakerTakerModel::label(Pending& example, bool wasFilled) {
+    regression.update(example.x, wasFilled);
+    example.open = false;
+    (wasFilled ? filled : missed).fetch_add(1, std::memory_order_relaxed);
+}
+
+void MakerTakerModel::onPublish(const OrderBookSnapshot& snapshot) {
+    if (snapshot.bids.empty() || snapshot.asks.empty()) return;
+    const double bestBid = snapshot.bids.front().price;
+    const double bestAsk = snapshot.asks.front().price;
+    const double mid = (bestBid + bestAsk) / 2.0;
+
+    // Settle open examples against the new touch
+    for (Pending& bid : bids) {
+        if (!bid.open) continue;
+        if (bestBid < bid.price || bestAsk <= bid.price) label(bid, true);
+        else if (bestBid > bid.price) label(bid, false);
+    }
+    for (Pending& ask : asks) {
+        if (!ask.open) continue;
+        if (bestAsk > ask.price || bestBid >= ask.price) label(ask, true);
+        else if (bestAsk < ask.price) label(ask, false);
+    }
+
+    // Raw features
+    size_t levels = std::min({config.depthLevels, snapshot.bids.size(), snapshot.asks.size()});
+    double bidDepth = 0.0, askDepth = 0.0;
+    for (size_t i = 0; i < levels; ++i) {
+        bidDepth += snapshot.bids.quantities[i];
+        askDepth += snapshot.asks.quantities[i];
+    }
+    if (lastMid > 0.0) {
+        double r = std::log(mid / lastMid);
+        squaredReturn = decay * squaredReturn + (1.0 - decay) * r * r;
+    }
+    lastMid = mid;
+
+    double raw[LogisticWeights::kFeatures];
+    raw[SpreadBps] = (bestAsk - bestBid) / mid * 1e4;
+    raw[Imbalance] = bidDepth + askDepth > 0.0 ? (bidDepth - askDepth) / (bidDepth + askDepth) : 0.0;
+    raw[LogDepth] = std::log1p(bidDepth + askDepth);
+    raw[VolatilityBps] = std::sqrt(squaredReturn) * 1e4;
+    FeatureVector x;
+    for (size_t k = 0; k < LogisticWeights::kFeatures; ++k) x[k] = standardizers[k].apply(raw[k], decay);
+    latest.store(x);
+
+    // The slot being reused opened horizonUpdates ago; still open means missed
+    size_t slot = updates++ % bids.size();
+    if (bids[slot].open) label(bids[slot], false);
+    if (asks[slot].open) label(asks[slot], false);
+    bids[slot] = Pending{x, bestBid, true};
+    FeatureVector sell = x;
+    sell[Imbalance] = -sell[Imbalance];
+    asks[slot] = Pending{sell, bestAsk, true};
+}
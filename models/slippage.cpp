@@ -1,5 +1,163 @@
 #include "models/slippage.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
-double SlippageModel::estimate(double usdQty) {
-    return usdQty * 0.0005; // Placeholder: 5bps
+namespace {
+
+// Fills inside the top level all cost exactly the half spread, which is also
+// where the low band sits for small orders; such ties count half
+double below(double actualBps, double predictedBps) {
+    const double tie = 1e-9;
+    if (std::fabs(actualBps - predictedBps) <= tie) return 0.5;
+    return actualBps < predictedBps ? 1.0 : 0.0;
+}
+
+} // namespace
+
+void SlippageValidation::add(const SlippageCheck& check) {
+    if (!check.filled) return;
+    ++checks;
+    underLow += below(check.actualBps, check.predicted.low);
+    underMedian += below(check.actualBps, check.predicted.median);
+    underHigh += below(check.actualBps, check.predicted.high);
+    absError += std::fabs(check.actualBps - check.predicted.median);
+}
+
+SlippageModel::SlippageModel(const SlippageConfig& config)
+    : config(config), gradientDecay(std::exp2(-1.0 / std::max(1.0, config.gradientHalfLife))),
+      volatilityDecay(std::exp2(-1.0 / std::max(1.0, config.volatilityHalfLife))),
+      logLadderRatio(std::log(config.maxDepthFraction / config.minDepthFraction) / (kSizes - 1)) {
+    for (size_t i = 0; i < kSizes; ++i) ladder[i] = config.minDepthFraction * std::exp(logLadderRatio * i);
+    published.store(current);
+}
+
+SlippageBand SlippageModel::predict(const Weights& weights, const MarketState& state, double usdQty,
+                                    Side side) const {
+    SlippageBand band;
+    double depth = state.depthUsd[side == Side::Buy ? 0 : 1];
+    if (depth <= 0.0 || usdQty <= 0.0) return band;
+    double fraction = usdQty / depth;
+    double position = std::log(fraction / ladder[0]) / logLadderRatio;
+
+    double q[3];
+    for (int i = 0; i < 3; ++i) {
+        auto at = [&](size_t size) {
+            return weights.w[i][size][0] + weights.w[i][size][1] * state.volatilityBps;
+        };
+        double above;
+        if (position <= 0.0) {
+            above = at(0) * fraction / ladder[0];
+        } else if (position >= kSizes - 1) {
+            double last = at(kSizes - 1);
+            double slope = (last - at(kSizes - 2)) / (ladder[kSizes - 1] - ladder[kSizes - 2]);
+            above = last + std::max(slope, 0.0) * (fraction - ladder[kSizes - 1]);
+        } else {
+            size_t j = static_cast<size_t>(position);
+            double t = (fraction - ladder[j]) / (ladder[j + 1] - ladder[j]);
+            above = (1.0 - t) * at(j) + t * at(j + 1);
+        }
+        q[i] = state.halfSpreadBps + std::max(above, 0.0);  // no fill beats the touch
+    }
+    // Independently fitted quantiles can cross early in training
+    std::sort(q, q + 3);
+    band.low = q[0];
+    band.median = q[1];
+    band.high = q[2];
+    band.beyondDepth = fraction > 1.0;
+    return band;
+}
+
+SlippageModel::MarketState SlippageModel::stateOf(const OrderBookSnapshot& book, double volatilityBps) const {
+    MarketState s;
+    if (book.bids.empty() || book.asks.empty()) return s;
+    double bid = book.bids.front().price;
+    double ask = book.asks.front().price;
+    s.mid = (bid + ask) / 2.0;
+    s.halfSpreadBps = (ask - bid) / 2.0 / s.mid * 1e4;
+    s.volatilityBps = volatilityBps;
+    auto notional = [](const OrderBookSide& side, const DepthIndex& depth) {
+        if (depth.cumNotional.size() == side.size()) return depth.totalNotional();
+        double sum = 0.0;
+        for (size_t i = 0; i < side.size(); ++i) sum += side.prices[i] * side.quantities[i];
+        return sum;
+    };
+    s.depthUsd[0] = notional(book.asks, book.askDepth);
+    s.depthUsd[1] = notional(book.bids, book.bidDepth);
+    return s;
+}
+
+void SlippageModel::train(size_t size, double volatilityBps, double residualBps) {
+    const double x[kFeatures] = {1.0, volatilityBps};
+    for (int i = 0; i < 3; ++i) {
+        double* w = current.w[i][size];
+        double prediction = w[0] * x[0] + w[1] * x[1];
+        // Pinball loss gradient with respect to the prediction
+        double slope = residualBps < prediction ? 1.0 - kQuantiles[i] : -kQuantiles[i];
+        for (size_t k = 0; k < kFeatures; ++k) {
+            double g = slope * x[k];
+            double& squares = gradientSquares[i][size][k];
+            squares = gradientDecay * squares + g * g;
+            w[k] -= config.learningRate * g / (std::sqrt(squares) + 1e-12);
+        }
+    }
+    ++current.samples;
+}
+
+void SlippageModel::onPublish(const OrderBookSnapshot& snapshot) {
+    if (snapshot.bids.empty() || snapshot.asks.empty()) return;
+    double mid = (snapshot.bids.front().price + snapshot.asks.front().price) / 2.0;
+    if (lastMid > 0.0) {
+        double r = std::log(mid / lastMid);
+        squaredReturn = volatilityDecay * squaredReturn + (1.0 - volatilityDecay) * r * r;
+    }
+    lastMid = mid;
+
+    MarketState state = stateOf(snapshot, std::sqrt(squaredReturn) * 1e4);
+    latest.store(state);
+
+    const OrderBookSide* sides[2] = {&snapshot.asks, &snapshot.bids};
+    const DepthIndex* depths[2] = {&snapshot.askDepth, &snapshot.bidDepth};
+    for (int s = 0; s < 2; ++s) {
+        const OrderBookSide& levels = *sides[s];
+        const DepthIndex& depth = *depths[s];
+        if (state.depthUsd[s] <= 0.0 || depth.cumNotional.size() != levels.size()) continue;
+        // Ladder sizes grow, so the crossing level only moves deeper
+        size_t level = 0;
+        for (size_t i = 0; i < kSizes; ++i) {
+            double notional = ladder[i] * state.depthUsd[s];
+            while (level + 1 < levels.size() && depth.cumNotional[level] < notional) ++level;
+            double spentBefore = level ? depth.cumNotional[level - 1] : 0.0;
+            double filledBefore = level ? depth.cumQuantity[level - 1] : 0.0;
+            double quantity = filledBefore + (notional - spentBefore) / levels.prices[level];
+            double average = notional / quantity;
+            double slippageBps = (s == 0 ? average - mid : mid - average) / mid * 1e4;
+            train(i, state.volatilityBps, slippageBps - state.halfSpreadBps);
+        }
+    }
+    published.store(current);
+}
+
+SlippageBand SlippageModel::quantiles(double usdQty, Side side) const {
+    return predict(published.load(), latest.load(), usdQty, side);
+}
+
+SlippageBand SlippageModel::quantiles(const OrderBookSnapshot& book, double usdQty, Side side) const {
+    return predict(published.load(), stateOf(book, latest.load().volatilityBps), usdQty, side);
+}
+
+double SlippageModel::estimate(double usdQty) const {
+    return usdQty * quantiles(usdQty, Side::Buy).median / 1e4;
+}
+
+SlippageCheck SlippageModel::validate(const OrderBookSnapshot& book, Side side, double usdQty) const {
+    SlippageCheck check;
+    MarketState state = stateOf(book, latest.load().volatilityBps);
+    if (state.mid <= 0.0) return check;
+    check.predicted = predict(published.load(), state, usdQty, side);
+    TradeResult actual = simulateMarketOrder(book, side, usdQty / state.mid, FeeTier{0.0, 0.0},
+                                             std::chrono::steady_clock::now());
+    check.actualBps = actual.slippage * 1e4;
+    check.filled = actual.executedQuantity >= usdQty / state.mid * (1.0 - 1e-12);
+    return check;
 }
@@ -0,0 +1,58 @@
+#include "binanceParser.h"
+#include "jsonScanner.h"
+
+namespace {
+
+struct DepthKind {
+    bool isDiff = false;      // "e":"depthUpdate"
+    bool isSnapshot = false;  // carries lastUpdateId
+    bool hasPrev = false;     // futures diffs chain through "pu"
+};
+
+// Diff events and snapshots only differ in their keys. A combined-stream
+// envelope recurses into its "data" member.
+bool parseDepth(JsonScanner& s, BookMessage& out, DepthKind& kind) {
+    return s.forEachMember([&](std::string_view key) {
+        if (key == "b" || key == "bids") return readLevels(s, out.bids);
+        if (key == "a" || key == "asks") return readLevels(s, out.asks);
+        if (key == "e") {
+            if (!s.readString(out.channel)) return false;
+            kind.isDiff = out.channel == "depthUpdate";
+            return true;
+        }
+        if (key == "s") return s.readString(out.instId);
+        if (key == "E") return s.readInt(out.timestampMs);
+        if (key == "U") return s.readInt(out.firstSeqId);
+        if (key == "u") return s.readInt(out.seqId);
+        if (key == "pu") {
+            kind.hasPrev = true;
+            return s.readInt(out.prevSeqId);
+        }
+        if (key == "lastUpdateId") {
+            kind.isSnapshot = true;
+            return s.readInt(out.seqId);
+        }
+        if (key == "data" && s.peek('{')) return parseDepth(s, out, kind);
+        return s.skipValue();
+    });
+}
+
+} // namespace
+
+BookParseStatus parseBinanceDepthMessage(std::string_view message, BookMessage& out) {
+    out.reset();
+    JsonScanner s(message);
+    DepthKind kind;
+    if (!parseDepth(s, out, kind)) return BookParseStatus::Malformed;
+
+    if (kind.isDiff) {
+        out.action = "update";
+        if (!kind.hasPrev) out.prevSeqId = out.firstSeqId - 1;
+        return BookParseStatus::Book;
+    }
+    if (kind.isSnapshot) {
+        out.action = "snapshot";
+        return BookParseStatus::Book;
+    }
+    return BookParseStatus::NotBook;
+}
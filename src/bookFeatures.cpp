@@ -0,0 +1,115 @@
+#include "bookFeatures.h"
+#include "bookKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+constexpr uint64_t kMinReturns = 100;  // before the realized estimate replaces the configured one
+
+// Notional within bps of mid: levels are sorted away from mid, so the band
+// is a prefix and its notional is one lookup in the running totals
+double depthWithin(const OrderBookSide& side, const DepthIndex& depth, double mid, double bps, bool bids) {
+    size_t n = side.size();
+    if (depth.cumNotional.size() != n) return notionalWithinBps(side, mid, bps);  // hand-built, no prefix sums
+    // Same bounds as notionalWithinBps
+    double band = mid * bps / 10000.0;
+    double limit = bids ? mid - band : mid + band;
+    const double* prices = side.prices.data();
+    size_t k = bids ? std::upper_bound(prices, prices + n, limit, std::greater<double>()) - prices
+                    : std::upper_bound(prices, prices + n, limit) - prices;
+    return k ? depth.cumNotional[k - 1] : 0.0;
+}
+
+// Flow one side added at a level between books (Cont, Kukanov & Stoikov):
+// a better price brings its whole queue, a worse one removes the old queue
+double levelFlow(double price, double quantity, double previousPrice, double previousQuantity, bool bid) {
+    if (price == previousPrice) return quantity - previousQuantity;
+    bool improved = bid ? price > previousPrice : price < previousPrice;
+    return improved ? quantity : -previousQuantity;
+}
+
+} // namespace
+
+FeatureEngine::FeatureEngine(const FeatureConfig& config)
+    : config(config), flowDecay(std::exp2(-1.0 / std::max(1.0, config.flowHalfLife))),
+      volatilityDecay(std::exp2(-1.0 / std::max(1.0, config.volatilityHalfLife))) {}
+
+void FeatureEngine::onPublish(const OrderBookSnapshot& snapshot) {
+    BookFeatures& f = current;
+    double previousMid = f.mid;
+    int64_t previousNs = f.timestampNs;
+    f.version = snapshot.version;
+    f.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(snapshot.timestamp.time_since_epoch()).count();
+    if (snapshot.bids.empty() || snapshot.asks.empty()) {
+        // Reset or one-sided book: nothing to describe but the volatility so
+        // far, and the next return would span the gap
+        BookFeatures empty;
+        empty.version = f.version;
+        empty.timestampNs = f.timestampNs;
+        empty.volatility = f.volatility;
+        empty.returnVolatilityBps = f.returnVolatilityBps;
+        empty.returns = f.returns;
+        f = empty;
+        previousLevels = 0;
+        published.store(f);
+        return;
+    }
+
+    double bidQuantity = snapshot.bids.quantities[0];
+    double askQuantity = snapshot.asks.quantities[0];
+    f.bestBid = snapshot.bids.prices[0];
+    f.bestAsk = snapshot.asks.prices[0];
+    f.mid = (f.bestBid + f.bestAsk) / 2.0;
+    f.spread = f.bestAsk - f.bestBid;
+    f.spreadBps = f.spread / f.mid * 1e4;
+    f.microprice = bidQuantity + askQuantity > 0.0
+                       ? (f.bestBid * askQuantity + f.bestAsk * bidQuantity) / (bidQuantity + askQuantity)
+                       : f.mid;
+
+    // Order-flow imbalance over the levels both books have
+    size_t levels = std::min({BookFeatures::kFlowLevels, snapshot.bids.size(), snapshot.asks.size()});
+    for (size_t k = 0; k < BookFeatures::kFlowLevels; ++k) {
+        double flow = 0.0;
+        if (k < levels && k < previousLevels) {
+            flow = levelFlow(snapshot.bids.prices[k], snapshot.bids.quantities[k], previousBidPrices[k],
+                             previousBidQuantities[k], true) -
+                   levelFlow(snapshot.asks.prices[k], snapshot.asks.quantities[k], previousAskPrices[k],
+                             previousAskQuantities[k], false);
+        }
+        f.orderFlowImbalance[k] = flowDecay * f.orderFlowImbalance[k] + flow;
+    }
+    for (size_t k = 0; k < levels; ++k) {
+        previousBidPrices[k] = snapshot.bids.prices[k];
+        previousBidQuantities[k] = snapshot.bids.quantities[k];
+        previousAskPrices[k] = snapshot.asks.prices[k];
+        previousAskQuantities[k] = snapshot.asks.quantities[k];
+    }
+    previousLevels = levels;
+
+    for (size_t i = 0; i < FeatureConfig::kDepthBands; ++i) {
+        f.bidDepthWithin[i] = depthWithin(snapshot.bids, snapshot.bidDepth, f.mid, config.depthBandsBps[i], true);
+        f.askDepthWithin[i] = depthWithin(snapshot.asks, snapshot.askDepth, f.mid, config.depthBandsBps[i], false);
+    }
+
+    // Returns and intervals share their weights, so the per-second variance
+    // needs no start-up correction; the per-update figure divides by the weight
+    if (previousMid > 0.0) {
+        double r = std::log(f.mid / previousMid);
+        double seconds = std::max(0.0, (f.timestampNs - previousNs) * 1e-9);
+        squaredReturn = volatilityDecay * squaredReturn + (1.0 - volatilityDecay) * r * r;
+        interval = volatilityDecay * interval + (1.0 - volatilityDecay) * seconds;
+        returnWeight = volatilityDecay * returnWeight + (1.0 - volatilityDecay);
+        ++f.returns;
+        f.returnVolatilityBps = std::sqrt(squaredReturn / returnWeight) * 1e4;
+        f.volatility = interval > 0.0 ? std::sqrt(squaredReturn / interval * kSecondsPerYear) : 0.0;
+    }
+    published.store(f);
+}
+
+double effectiveVolatility(const TradeConfig& config, const BookFeatures& features) {
+    if (config.realizedVolatility && features.returns >= kMinReturns && features.volatility > 0.0)
+        return features.volatility;
+    return config.volatility;
+}
@@ -0,0 +1,428 @@
+#include "bookHistory.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+constexpr size_t kFields = 4;
+constexpr size_t kFixedColumns = 2;  // timestamps, versions
+
+size_t columnCount(size_t levels) {
+    return kFixedColumns + kFields * levels;
+}
+
+size_t columnOf(HistoryField field, size_t level, size_t levels) {
+    return kFixedColumns + static_cast<size_t>(field) * levels + level;
+}
+
+bool isPrice(size_t column, size_t levels) {
+    size_t field = (column - kFixedColumns) / levels;
+    return field == static_cast<size_t>(HistoryField::BidPrice) ||
+           field == static_cast<size_t>(HistoryField::AskPrice);
+}
+
+void putVarint(std::vector<uint8_t>& out, int64_t value) {
+    uint64_t v = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);  // zigzag
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// False if the bytes run out mid-value
+bool getVarint(const uint8_t*& p, const uint8_t* end, int64_t& value) {
+    uint64_t v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            value = static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+BookHistory::BookHistory(const HistoryConfig& config)
+    : config(config), times(std::max<size_t>(1, config.capacity)), versions(times.size()),
+      values(kFields * std::max<size_t>(1, config.levels) * times.size()) {
+    this->config.capacity = times.size();
+    this->config.levels = std::max<size_t>(1, config.levels);
+    this->config.segmentRows = std::max<size_t>(1, config.segmentRows);
+    auto wall = std::chrono::system_clock::now().time_since_epoch();
+    auto steady = std::chrono::steady_clock::now().time_since_epoch();
+    wallOffsetNs = std::chrono::duration_cast<std::chrono::nanoseconds>(wall).count() -
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(steady).count();
+
+    if (!config.directory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(config.directory, error);
+        size_t columns = columnCount(this->config.levels);
+        previous.assign(columns, 0);
+        // Two segments, one filling while the other is written out. Most
+        // changes fit a byte or two; start with room for that.
+        for (std::unique_ptr<Segment>* segment : {&building, &spare}) {
+            *segment = std::make_unique<Segment>();
+            (*segment)->encoded.resize(columns);
+            (*segment)->blockOffsets.resize(columns);
+            for (auto& bytes : (*segment)->encoded) bytes.reserve(this->config.segmentRows * 2);
+        }
+        writer = std::thread(&BookHistory::runWriter, this);
+    }
+}
+
+BookHistory::~BookHistory() {
+    flush();
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueChanged.notify_all();
+        writer.join();
+    }
+}
+
+void BookHistory::onPublish(const OrderBookSnapshot& snapshot) {
+    int64_t steadyNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(snapshot.timestamp.time_since_epoch()).count();
+    append(snapshot, steadyNs + wallOffsetNs);
+}
+
+void BookHistory::append(const OrderBookSnapshot& snapshot, int64_t timestampNs) {
+    size_t slot = appended % config.capacity;
+    times[slot] = timestampNs;
+    versions[slot] = snapshot.version;
+    auto store = [&](const OrderBookSide& side, HistoryField priceField, HistoryField quantityField) {
+        size_t n = std::min(side.size(), config.levels);
+        for (size_t k = 0; k < config.levels; ++k) {
+            columnBase(priceField, k)[slot] = k < n ? side.prices[k] : 0.0;
+            columnBase(quantityField, k)[slot] = k < n ? side.quantities[k] : 0.0;
+        }
+    };
+    store(snapshot.bids, HistoryField::BidPrice, HistoryField::BidQuantity);
+    store(snapshot.asks, HistoryField::AskPrice, HistoryField::AskQuantity);
+    ++appended;
+    if (!config.directory.empty()) encodeRow(slot);
+}
+
+void BookHistory::encodeRow(size_t slot) {
+    Segment& segment = *building;
+    const size_t columns = segment.encoded.size();
+    if (segmentRowCount % kBlockRows == 0) {
+        // Each block starts from absolute values so it decodes on its own
+        for (size_t c = 0; c < columns; ++c) {
+            segment.blockOffsets[c].push_back(segment.encoded[c].size());
+            previous[c] = 0;
+        }
+        segment.blockFirstNs.push_back(times[slot]);
+    }
+    if (segmentRowCount == 0) segmentFirstNs = times[slot];
+    segmentLastNs = times[slot];
+
+    auto put = [&](size_t c, int64_t value) {
+        putVarint(segment.encoded[c], value - previous[c]);
+        previous[c] = value;
+    };
+    put(0, times[slot]);
+    put(1, static_cast<int64_t>(versions[slot]));
+    size_t c = kFixedColumns;
+    for (size_t field = 0; field < kFields; ++field) {
+        bool price = field == static_cast<size_t>(HistoryField::BidPrice) ||
+                     field == static_cast<size_t>(HistoryField::AskPrice);
+        for (size_t k = 0; k < config.levels; ++k, ++c) {
+            double value = columnBase(static_cast<HistoryField>(field), k)[slot];
+            put(c, price ? config.spec.toTicks(value) : config.spec.toLots(value));
+        }
+    }
+    if (++segmentRowCount == config.segmentRows) finishSegment();
+}
+
+void BookHistory::flush() {
+    if (segmentRowCount) finishSegment();
+    if (!writer.joinable()) return;
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueChanged.wait(lock, [&] { return outstanding == 0; });
+}
+
+// Queues the segment being encoded and takes the spare to fill next, waiting
+// for it if the writer has not finished with it yet
+void BookHistory::finishSegment() {
+    HistorySegmentHeader& header = building->header;
+    std::memcpy(header.magic, HistorySegmentHeader::kMagic, sizeof(header.magic));
+    header.version = HistorySegmentHeader::kVersion;
+    header.levels = static_cast<uint32_t>(config.levels);
+    header.rows = segmentRowCount;
+    header.blockRows = static_cast<uint32_t>(kBlockRows);
+    header.tickSize = config.spec.tickSize();
+    header.lotSize = config.spec.lotSize();
+    header.firstNs = segmentFirstNs;
+    header.lastNs = segmentLastNs;
+    header.wallOffsetNs = wallOffsetNs;
+    segmentRowCount = 0;
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queued.push_back(std::move(building));
+    ++outstanding;
+    queueChanged.notify_all();
+    if (!spare) {
+        ++stalls;
+        queueChanged.wait(lock, [&] { return spare != nullptr; });
+    }
+    building = std::move(spare);
+}
+
+void BookHistory::runWriter() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    for (;;) {
+        queueChanged.wait(lock, [&] { return stopping || !queued.empty(); });
+        if (queued.empty()) return;
+        std::unique_ptr<Segment> segment = std::move(queued.front());
+        queued.pop_front();
+        lock.unlock();
+        writeSegment(*segment);
+        lock.lock();
+        spare = std::move(segment);
+        --outstanding;
+        queueChanged.notify_all();
+    }
+}
+
+// Writer thread: writes one segment file and empties the segment for reuse
+void BookHistory::writeSegment(Segment& segment) {
+    const HistorySegmentHeader& header = segment.header;
+    const size_t columns = segment.encoded.size();
+    const size_t blocks = segment.blockFirstNs.size();
+
+    std::vector<uint64_t> starts(columns);
+    uint64_t offset = 0;
+    for (size_t c = 0; c < columns; ++c) {
+        starts[c] = offset;
+        offset += segment.encoded[c].size();
+    }
+
+    // Named by the first row's time, so a directory listing sorts by time
+    char name[64];
+    std::snprintf(name, sizeof(name), "/history-%020" PRId64 ".seg", header.firstNs);
+    std::string path = config.directory + name;
+    FILE* file = std::fopen(path.c_str(), "wb");
+    bool ok = file != nullptr;
+    if (ok) {
+        ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+             std::fwrite(segment.blockFirstNs.data(), sizeof(int64_t), blocks, file) == blocks &&
+             std::fwrite(starts.data(), sizeof(uint64_t), columns, file) == columns;
+        for (size_t c = 0; ok && c < columns; ++c)
+            ok = std::fwrite(segment.blockOffsets[c].data(), sizeof(uint64_t), blocks, file) == blocks;
+        for (size_t c = 0; ok && c < columns; ++c)
+            ok = std::fwrite(segment.encoded[c].data(), 1, segment.encoded[c].size(), file) ==
+                 segment.encoded[c].size();
+        ok = std::fclose(file) == 0 && ok;
+    }
+    if (ok) {
+        segments.fetch_add(1, std::memory_order_release);
+    } else {
+        failed.store(true, std::memory_order_release);
+        LOG_WARN("History", "Cannot write segment {}", path);
+    }
+
+    for (size_t c = 0; c < columns; ++c) {
+        segment.encoded[c].clear();
+        segment.blockOffsets[c].clear();
+    }
+    segment.blockFirstNs.clear();
+}
+
+size_t BookHistory::size() const {
+    return static_cast<size_t>(std::min<uint64_t>(appended, config.capacity));
+}
+
+int64_t BookHistory::oldestNs() const {
+    return appended ? times[(appended - size()) % config.capacity] : 0;
+}
+
+int64_t BookHistory::newestNs() const {
+    return appended ? times[(appended - 1) % config.capacity] : 0;
+}
+
+BookHistory::RowRange BookHistory::rowsBetween(int64_t fromNs, int64_t toNs) const {
+    // Timestamps never decrease, so both ends are binary searches over the ring
+    auto firstAtOrAfter = [this](int64_t ns) {
+        uint64_t lo = appended - size(), hi = appended;
+        while (lo < hi) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if (times[mid % config.capacity] < ns) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    };
+    uint64_t begin = firstAtOrAfter(fromNs);
+    return {begin, std::max(begin, firstAtOrAfter(toNs))};
+}
+
+template <typename T>
+HistorySpan<T> BookHistory::span(const T* base, RowRange rows) const {
+    HistorySpan<T> out;
+    size_t n = static_cast<size_t>(rows.end - rows.begin);
+    if (!n) return out;
+    size_t start = rows.begin % config.capacity;
+    size_t first = std::min(n, config.capacity - start);
+    out.data[0] = base + start;
+    out.count[0] = first;
+    if (first < n) {
+        out.data[1] = base;
+        out.count[1] = n - first;
+    }
+    return out;
+}
+
+HistorySpan<int64_t> BookHistory::timestamps(int64_t fromNs, int64_t toNs) const {
+    return span(times.data(), rowsBetween(fromNs, toNs));
+}
+
+HistorySpan<double> BookHistory::column(HistoryField field, size_t level, int64_t fromNs, int64_t toNs) const {
+    if (level >= config.levels) return {};
+    return span(columnBase(field, level), rowsBetween(fromNs, toNs));
+}
+
+bool BookHistory::bookAt(int64_t timestampNs, OrderBookSnapshot& out) const {
+    if (!appended || timestampNs < oldestNs()) return false;
+    // Last row at or before the time: one before the first row after it
+    uint64_t row = rowsBetween(oldestNs(), timestampNs + 1).end - 1;
+    size_t slot = row % config.capacity;
+
+    out.bids.clear();
+    out.asks.clear();
+    for (size_t k = 0; k < config.levels; ++k) {
+        double bidQty = columnBase(HistoryField::BidQuantity, k)[slot];
+        double askQty = columnBase(HistoryField::AskQuantity, k)[slot];
+        if (bidQty > 0.0) out.bids.push_back({columnBase(HistoryField::BidPrice, k)[slot], bidQty});
+        if (askQty > 0.0) out.asks.push_back({columnBase(HistoryField::AskPrice, k)[slot], askQty});
+    }
+    out.spec = config.spec;
+    indexSnapshot(out);
+    out.version = versions[slot];
+    out.timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(times[slot] - wallOffsetNs));
+    return true;
+}
+
+bool HistorySegment::open(const std::string& path) {
+    valid = false;
+    if (!file.open(path) || file.size() < sizeof(HistorySegmentHeader)) return false;
+    std::memcpy(&head, file.data(), sizeof(head));
+    if (std::memcmp(head.magic, HistorySegmentHeader::kMagic, sizeof(head.magic)) != 0 ||
+        head.version != HistorySegmentHeader::kVersion || head.blockRows == 0 || head.rows == 0)
+        return false;
+
+    blocks = (head.rows + head.blockRows - 1) / head.blockRows;
+    size_t columns = columnCount(head.levels);
+    size_t tables = (blocks + columns + columns * blocks) * sizeof(uint64_t);
+    if (file.size() - sizeof(head) < tables) return false;
+    // The mapping is page-aligned and the header a multiple of 8 bytes, so
+    // the tables can be read in place
+    const char* base = file.data() + sizeof(head);
+    blockFirstNs = reinterpret_cast<const int64_t*>(base);
+    columnStarts = reinterpret_cast<const uint64_t*>(base) + blocks;
+    blockOffsets = columnStarts + columns;
+    payload = reinterpret_cast<const uint8_t*>(base + tables);
+    payloadSize = file.size() - sizeof(head) - tables;
+    spec = InstrumentSpec(head.tickSize, head.lotSize);
+    valid = true;
+    return true;
+}
+
+void HistorySegment::decode(size_t column, size_t first, size_t count, int64_t* out) const {
+    size_t last = std::min(first + count, rows());
+    size_t block = first / head.blockRows;
+    size_t row = block * head.blockRows;
+    const uint8_t* end = payload + payloadSize;
+    const uint8_t* p =
+        payload + std::min<uint64_t>(payloadSize, columnStarts[column] + blockOffsets[column * blocks + block]);
+    int64_t value = 0;
+    for (; row < last; ++row) {
+        if (row % head.blockRows == 0) value = 0;  // blocks restart from absolute values
+        int64_t delta;
+        if (!getVarint(p, end, delta)) break;  // truncated file
+        value += delta;
+        if (row >= first) out[row - first] = value;
+    }
+    for (; row < first + count; ++row)
+        if (row >= first) out[row - first] = 0;
+}
+
+void HistorySegment::decodeTimestamps(size_t first, size_t count, int64_t* out) const {
+    decode(0, first, count, out);
+}
+
+void HistorySegment::decodeColumn(HistoryField field, size_t level, size_t first, size_t count,
+                                  double* out) const {
+    if (level >= levels()) return;
+    size_t column = columnOf(field, level, levels());
+    bool price = isPrice(column, levels());
+    // A block at a time, so every decode starts where the last one stopped
+    int64_t units[BookHistory::kBlockRows];
+    for (size_t done = 0; done < count;) {
+        size_t row = first + done;
+        size_t n = std::min({count - done, head.blockRows - row % head.blockRows, BookHistory::kBlockRows});
+        decode(column, row, n, units);
+        for (size_t i = 0; i < n; ++i) out[done + i] = price ? spec.fromTicks(units[i]) : spec.fromLots(units[i]);
+        done += n;
+    }
+}
+
+bool HistorySegment::bookAt(int64_t timestampNs, OrderBookSnapshot& out) const {
+    if (!valid || timestampNs < firstNs()) return false;
+    size_t block = std::upper_bound(blockFirstNs, blockFirstNs + blocks, timestampNs) - blockFirstNs - 1;
+    size_t first = block * head.blockRows;
+    size_t count = std::min<size_t>(head.blockRows, rows() - first);
+
+    std::vector<int64_t> times(count);
+    decode(0, first, count, times.data());
+    size_t row = first + (std::upper_bound(times.begin(), times.end(), timestampNs) - times.begin()) - 1;
+
+    int64_t version = 0;
+    decode(1, row, 1, &version);
+    out.bids.clear();
+    out.asks.clear();
+    for (size_t k = 0; k < levels(); ++k) {
+        int64_t units[4];
+        for (size_t f = 0; f < kFields; ++f)
+            decode(columnOf(static_cast<HistoryField>(f), k, levels()), row, 1, &units[f]);
+        if (units[1] > 0) out.bids.push_back({spec.fromTicks(units[0]), spec.fromLots(units[1])});
+        if (units[3] > 0) out.asks.push_back({spec.fromTicks(units[2]), spec.fromLots(units[3])});
+    }
+    out.spec = spec;
+    indexSnapshot(out);
+    out.version = static_cast<uint64_t>(version);
+    out.timestamp =
+        std::chrono::steady_clock::time_point(std::chrono::nanoseconds(times[row - first] - head.wallOffsetNs));
+    return true;
+}
+
+bool HistoryArchive::open(const std::string& directory) {
+    segments.clear();
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() != ".seg") continue;
+        auto segment = std::make_unique<HistorySegment>();
+        if (segment->open(entry.path().string())) segments.push_back(std::move(segment));
+    }
+    std::sort(segments.begin(), segments.end(),
+              [](const auto& a, const auto& b) { return a->firstNs() < b->firstNs(); });
+    return !segments.empty();
+}
+
+bool HistoryArchive::bookAt(int64_t timestampNs, OrderBookSnapshot& out) const {
+    // Last segment starting at or before the time
+    auto it = std::upper_bound(segments.begin(), segments.end(), timestampNs,
+                               [](int64_t ns, const auto& segment) { return ns < segment->firstNs(); });
+    if (it == segments.begin()) return false;
+    return (*(it - 1))->bookAt(timestampNs, out);
+}
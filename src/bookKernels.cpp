@@ -0,0 +1,273 @@
+#include "bookKernels.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TRADESIM_HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TRADESIM_TARGET_AVX2
+#else
+#define TRADESIM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// ---- Scalar reference kernels ----
+
+void prefixSumsScalar(const double* prices, const double* quantities, size_t n,
+                      double baseQty, double baseNotional, double* cumQty, double* cumNotional) {
+    double qty = baseQty, notional = baseNotional;
+    for (size_t i = 0; i < n; ++i) {
+        qty += quantities[i];
+        notional += prices[i] * quantities[i];
+        cumQty[i] = qty;
+        cumNotional[i] = notional;
+    }
+}
+
+double fillScalar(const double* prices, const double* quantities, size_t n,
+                  double target, double* filledQty) {
+    double filled = 0.0, notional = 0.0;
+    for (size_t i = 0; i < n && filled < target; ++i) {
+        double take = std::min(target - filled, quantities[i]);
+        filled += take;
+        notional += take * prices[i];
+    }
+    *filledQty = filled;
+    return notional;
+}
+
+double sumQuantityScalar(const double* quantities, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += quantities[i];
+    return sum;
+}
+
+double sumNotionalScalar(const double* prices, const double* quantities, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += prices[i] * quantities[i];
+    return sum;
+}
+
+double notionalInRangeScalar(const double* prices, const double* quantities, size_t n,
+                             double low, double high) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        if (prices[i] >= low && prices[i] <= high) sum += prices[i] * quantities[i];
+    return sum;
+}
+
+void unitsToDoublesScalar(const int64_t* units, size_t n, int64_t step, double scale, double* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = static_cast<double>(units[i] * step) / scale;
+}
+
+const BookKernels kScalarKernels = {
+    "scalar",
+    prefixSumsScalar,
+    fillScalar,
+    sumQuantityScalar,
+    sumNotionalScalar,
+    notionalInRangeScalar,
+    unitsToDoublesScalar,
+};
+
+// ---- AVX2 kernels ----
+
+#ifdef TRADESIM_HAS_AVX2_KERNELS
+
+TRADESIM_TARGET_AVX2 inline double horizontalSum(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+// In-register inclusive scan of four doubles: [a, a+b, a+b+c, a+b+c+d]
+TRADESIM_TARGET_AVX2 inline __m256d scan4(__m256d x) {
+    const __m256d zero = _mm256_setzero_pd();
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+    return x;
+}
+
+TRADESIM_TARGET_AVX2 void prefixSumsAvx2(const double* prices, const double* quantities, size_t n,
+                                         double baseQty, double baseNotional,
+                                         double* cumQty, double* cumNotional) {
+    __m256d carryQty = _mm256_set1_pd(baseQty);
+    __m256d carryNotional = _mm256_set1_pd(baseNotional);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d p = _mm256_loadu_pd(prices + i);
+        __m256d q = _mm256_loadu_pd(quantities + i);
+        __m256d cq = _mm256_add_pd(scan4(q), carryQty);
+        __m256d cn = _mm256_add_pd(scan4(_mm256_mul_pd(p, q)), carryNotional);
+        _mm256_storeu_pd(cumQty + i, cq);
+        _mm256_storeu_pd(cumNotional + i, cn);
+        carryQty = _mm256_permute4x64_pd(cq, _MM_SHUFFLE(3, 3, 3, 3));
+        carryNotional = _mm256_permute4x64_pd(cn, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    double qty = i ? cumQty[i - 1] : baseQty;
+    double notional = i ? cumNotional[i - 1] : baseNotional;
+    prefixSumsScalar(prices + i, quantities + i, n - i, qty, notional, cumQty + i, cumNotional + i);
+}
+
+TRADESIM_TARGET_AVX2 double fillAvx2(const double* prices, const double* quantities, size_t n,
+                                     double target, double* filledQty) {
+    // Consume whole blocks of four while they fit, then finish the boundary block scalar
+    double filled = 0.0, notional = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d q = _mm256_loadu_pd(quantities + i);
+        double blockQty = horizontalSum(q);
+        if (filled + blockQty >= target) break;
+        filled += blockQty;
+        notional += horizontalSum(_mm256_mul_pd(_mm256_loadu_pd(prices + i), q));
+    }
+    double tailQty = 0.0;
+    notional += fillScalar(prices + i, quantities + i, n - i, target - filled, &tailQty);
+    *filledQty = filled + tailQty;
+    return notional;
+}
+
+TRADESIM_TARGET_AVX2 double sumQuantityAvx2(const double* quantities, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(quantities + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(quantities + i + 4));
+    }
+    for (; i + 4 <= n; i += 4) acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(quantities + i));
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + sumQuantityScalar(quantities + i, n - i);
+}
+
+TRADESIM_TARGET_AVX2 double sumNotionalAvx2(const double* prices, const double* quantities, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(prices + i), _mm256_loadu_pd(quantities + i)));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(prices + i + 4), _mm256_loadu_pd(quantities + i + 4)));
+    }
+    for (; i + 4 <= n; i += 4)
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(prices + i), _mm256_loadu_pd(quantities + i)));
+    return horizontalSum(_mm256_add_pd(acc0, acc1)) + sumNotionalScalar(prices + i, quantities + i, n - i);
+}
+
+TRADESIM_TARGET_AVX2 double notionalInRangeAvx2(const double* prices, const double* quantities, size_t n,
+                                                double low, double high) {
+    const __m256d lo = _mm256_set1_pd(low);
+    const __m256d hi = _mm256_set1_pd(high);
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d p = _mm256_loadu_pd(prices + i);
+        __m256d inRange = _mm256_and_pd(_mm256_cmp_pd(p, lo, _CMP_GE_OQ), _mm256_cmp_pd(p, hi, _CMP_LE_OQ));
+        acc = _mm256_add_pd(acc, _mm256_and_pd(inRange, _mm256_mul_pd(p, _mm256_loadu_pd(quantities + i))));
+    }
+    return horizontalSum(acc) + notionalInRangeScalar(prices + i, quantities + i, n - i, low, high);
+}
+
+// AVX2 has no int64 -> double conversion; for 0 <= x < 2^52, x ORed into
+// the mantissa of 2^52 is exactly 2^52 + x. Blocks with a value outside that
+// range (or whose product with step would be) go through the scalar loop, so
+// results match it bit for bit.
+TRADESIM_TARGET_AVX2 void unitsToDoublesAvx2(const int64_t* units, size_t n, int64_t step, double scale,
+                                             double* out) {
+    const __m256i magicBits = _mm256_set1_epi64x(0x4330000000000000);
+    const __m256d magic = _mm256_set1_pd(4503599627370496.0);  // 2^52
+    const __m256i limit = _mm256_set1_epi64x(((int64_t(1) << 52) - 1) / step);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256d stepD = _mm256_set1_pd(static_cast<double>(step));
+    const __m256d scaleD = _mm256_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(units + i));
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(x, limit), _mm256_cmpgt_epi64(zero, x));
+        if (!_mm256_testz_si256(outside, outside)) {
+            unitsToDoublesScalar(units + i, 4, step, scale, out + i);
+            continue;
+        }
+        __m256d d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(x, magicBits)), magic);
+        _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_mul_pd(d, stepD), scaleD));
+    }
+    unitsToDoublesScalar(units + i, n - i, step, scale, out + i);
+}
+
+const BookKernels kAvx2Kernels = {
+    "avx2",
+    prefixSumsAvx2,
+    fillAvx2,
+    sumQuantityAvx2,
+    sumNotionalAvx2,
+    notionalInRangeAvx2,
+    unitsToDoublesAvx2,
+};
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+    if (!osSavesYmm) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // TRADESIM_HAS_AVX2_KERNELS
+
+const BookKernels& selectKernels() {
+    const char* forced = std::getenv("TRADESIM_KERNELS");
+    if (forced && std::strcmp(forced, "scalar") == 0) return kScalarKernels;
+    const BookKernels* avx2 = avx2BookKernels();
+    return avx2 ? *avx2 : kScalarKernels;
+}
+
+} // namespace
+
+const BookKernels& scalarBookKernels() {
+    return kScalarKernels;
+}
+
+const BookKernels* avx2BookKernels() {
+#ifdef TRADESIM_HAS_AVX2_KERNELS
+    static const bool supported = cpuHasAvx2();
+    return supported ? &kAvx2Kernels : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const BookKernels& bookKernels() {
+    static const BookKernels& selected = selectKernels();
+    return selected;
+}
+
+double vwap(const OrderBookSide& side, size_t topN) {
+    size_t n = std::min(topN, side.size());
+    const BookKernels& k = bookKernels();
+    double qty = k.sumQuantity(side.quantities.data(), n);
+    return qty > 0 ? k.sumNotional(side.prices.data(), side.quantities.data(), n) / qty : 0.0;
+}
+
+double notionalWithinBps(const OrderBookSide& side, double midPrice, double bps) {
+    double band = midPrice * bps / 10000.0;
+    return bookKernels().notionalInRange(side.prices.data(), side.quantities.data(), side.size(),
+                                         midPrice - band, midPrice + band);
+}
+
+double imbalance(const OrderBookSnapshot& book, size_t topN) {
+    const BookKernels& k = bookKernels();
+    double bidQty = k.sumQuantity(book.bids.quantities.data(), std::min(topN, book.bids.size()));
+    double askQty = k.sumQuantity(book.asks.quantities.data(), std::min(topN, book.asks.size()));
+    double total = bidQty + askQty;
+    return total > 0 ? (bidQty - askQty) / total : 0.0;
+}
@@ -0,0 +1,17 @@
+#include "bookRegistry.h"
+
+BookRegistry::BookRegistry(size_t maxDepth, size_t publishDepth)
+    : maxDepth(maxDepth), publishDepth(publishDepth) {}
+
+Orderbook& BookRegistry::add(const BookKey& key, const InstrumentSpec& spec) {
+    auto it = index.find(key);
+    if (it != index.end()) return *entries[it->second].book;
+    index.emplace(key, entries.size());
+    entries.push_back({key, std::unique_ptr<Orderbook>(new Orderbook(maxDepth, publishDepth, spec))});
+    return *entries.back().book;
+}
+
+Orderbook* BookRegistry::find(const BookKey& key) const {
+    auto it = index.find(key);
+    return it == index.end() ? nullptr : entries[it->second].book.get();
+}
@@ -0,0 +1,36 @@
+#include "bookSnapshot.h"
+#include "bookKernels.h"
+
+void buildDepthIndex(const OrderBookSide& side, DepthIndex& out) {
+    out.cumQuantity.resize(side.size());
+    out.cumNotional.resize(side.size());
+    bookKernels().prefixSums(side.prices.data(), side.quantities.data(), side.size(), 0.0, 0.0,
+                             out.cumQuantity.data(), out.cumNotional.data());
+    if (!side.onGrid()) {
+        out.cumLots.clear();
+        return;
+    }
+    out.cumLots.resize(side.size());
+    int64_t total = 0;
+    for (size_t i = 0; i < side.size(); ++i) out.cumLots[i] = total += side.lots[i];
+}
+
+namespace {
+
+void putOnGrid(OrderBookSide& side, const InstrumentSpec& spec) {
+    side.ticks.resize(side.size());
+    side.lots.resize(side.size());
+    for (size_t i = 0; i < side.size(); ++i) {
+        side.ticks[i] = spec.toTicks(side.prices[i]);
+        side.lots[i] = spec.toLots(side.quantities[i]);
+    }
+}
+
+} // namespace
+
+void indexSnapshot(OrderBookSnapshot& snapshot) {
+    putOnGrid(snapshot.bids, snapshot.spec);
+    putOnGrid(snapshot.asks, snapshot.spec);
+    buildDepthIndex(snapshot.bids, snapshot.bidDepth);
+    buildDepthIndex(snapshot.asks, snapshot.askDepth);
+}
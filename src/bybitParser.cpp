@@ -0,0 +1,47 @@
+#include "bybitParser.h"
+#include "jsonScanner.h"
+
+namespace {
+
+bool parseBook(JsonScanner& s, BookMessage& out) {
+    return s.forEachMember([&](std::string_view key) {
+        if (key == "b") return readLevels(s, out.bids);
+        if (key == "a") return readLevels(s, out.asks);
+        if (key == "s") return s.readString(out.instId);
+        if (key == "u") return s.readInt(out.seqId);
+        return s.skipValue();
+    });
+}
+
+} // namespace
+
+BookParseStatus parseBybitBookMessage(std::string_view message, BookMessage& out) {
+    out.reset();
+    JsonScanner s(message);
+    std::string_view type;
+    bool hasData = false;
+
+    bool ok = s.forEachMember([&](std::string_view key) {
+        if (key == "topic") return s.readString(out.channel);
+        if (key == "type") return s.readString(type);
+        if (key == "ts") return s.readInt(out.timestampMs);
+        if (key == "data") {
+            if (!s.peek('{')) return s.skipValue();  // not a book
+            hasData = true;
+            return parseBook(s, out);
+        }
+        return s.skipValue();
+    });
+
+    if (!ok) return BookParseStatus::Malformed;
+    if (!hasData || out.channel.substr(0, 10) != "orderbook.") return BookParseStatus::NotBook;
+    if (type == "snapshot") {
+        out.action = "snapshot";
+    } else if (type == "delta") {
+        out.action = "update";
+    } else {
+        return BookParseStatus::Malformed;
+    }
+    out.prevSeqId = out.seqId - 1;
+    return BookParseStatus::Book;
+}
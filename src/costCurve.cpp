@@ -0,0 +1,93 @@
+#include "costCurve.h"
+#include "tradeSim.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+void walkSide(const OrderBookSide& levels, const InstrumentSpec& spec, double midPrice, bool isBuy,
+              int feeTier, const std::vector<double>& quantities, const std::vector<size_t>& order,
+              std::vector<CostPoint>& out) {
+    out.assign(quantities.size(), CostPoint{});
+
+    // The cursor advances in whole lots; sides built without a grid are put
+    // on the snapshot's one first
+    const double* prices = levels.prices.data();
+    std::vector<int64_t> converted;
+    const int64_t* sizes = levels.lots.data();
+    if (!levels.onGrid()) {
+        converted.resize(levels.size());
+        for (size_t i = 0; i < levels.size(); ++i) converted[i] = spec.toLots(levels.quantities[i]);
+        sizes = converted.data();
+    }
+    int64_t totalLots = 0;
+    for (size_t i = 0; i < levels.size(); ++i) totalLots += sizes[i];
+
+    // Running totals over fully consumed levels
+    size_t level = 0;
+    int64_t filledLots = 0;
+    double filledNotional = 0.0;
+
+    for (size_t idx : order) {
+        double qty = quantities[idx];
+        int64_t qtyLots = spec.toLots(qty);
+        while (level < levels.size() && filledLots + sizes[level] < qtyLots) {
+            filledLots += sizes[level];
+            filledNotional += spec.fromLots(sizes[level]) * prices[level];
+            ++level;
+        }
+
+        int64_t executedLots = filledLots;
+        double executedValue = filledNotional;
+        if (level < levels.size() && qtyLots > filledLots) {
+            executedLots = qtyLots;
+            executedValue += spec.fromLots(qtyLots - filledLots) * prices[level];
+        }
+        double executedQty = spec.fromLots(executedLots);
+
+        CostPoint& p = out[idx];
+        p.quantity = qty;
+        p.executedQuantity = executedQty;
+        p.averagePrice = executedQty > 0 ? executedValue / executedQty : 0.0;
+        if (midPrice > 0 && executedQty > 0)
+            p.slippage = isBuy ? (p.averagePrice - midPrice) / midPrice : (midPrice - p.averagePrice) / midPrice;
+        p.fees = calculateFees(executedValue, feeTier, /*isMaker=*/false);
+        p.marketImpact = totalLots > 0 ? static_cast<double>(executedLots) / static_cast<double>(totalLots) : 0.0;
+        p.netCost = p.slippage * midPrice * executedQty + p.fees;
+    }
+}
+
+} // namespace
+
+void computeCostCurve(const OrderBookSnapshot& book, const std::vector<double>& quantities,
+                      CurveSides sides, int feeTier, CostCurve& out) {
+    std::vector<size_t> order(quantities.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    if (!std::is_sorted(quantities.begin(), quantities.end()))
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return quantities[a] < quantities[b]; });
+
+    double bestBid = book.bids.empty() ? 0.0 : book.bids.front().price;
+    double bestAsk = book.asks.empty() ? 0.0 : book.asks.front().price;
+    double midPrice = (bestBid > 0 && bestAsk > 0) ? (bestBid + bestAsk) / 2.0 : 0.0;
+
+    out.version = book.version;
+    if (sides != CurveSides::Sell) walkSide(book.asks, book.spec, midPrice, true, feeTier, quantities, order, out.buy);
+    else out.buy.clear();
+    if (sides != CurveSides::Buy) walkSide(book.bids, book.spec, midPrice, false, feeTier, quantities, order, out.sell);
+    else out.sell.clear();
+}
+
+const CostCurve& CostCurveCache::get(const OrderBookSnapshot& book, const std::vector<double>& quantities,
+                                     CurveSides sides, int feeTier) {
+    // Version 0 marks hand-built snapshots, which cannot be told apart
+    bool hit = valid && book.version != 0 && curve.version == book.version && lastSides == sides &&
+               lastFeeTier == feeTier && lastQuantities == quantities;
+    if (!hit) {
+        computeCostCurve(book, quantities, sides, feeTier, curve);
+        lastQuantities = quantities;
+        lastSides = sides;
+        lastFeeTier = feeTier;
+        valid = true;
+    }
+    return curve;
+}
@@ -1,22 +1,47 @@
 #include "datafeed.h"
+#include "orderbook.h"
+#include <atomic>
 #include <chrono>
 
-// TEMP: dummy data for now — replace with live websocket data
-OrderBookSnapshot getCurrentOrderBookSnapshot() {
-    OrderBookSnapshot snapshot;
+namespace {
 
-    snapshot.bids = {
-        {60000.0, 0.5},
-        {59950.0, 1.0},
-        {59900.0, 2.0}
-    };
+// Dummy book levels, best first
+const OrderLevel kDummyBids[] = {{60000.0, 0.5}, {59950.0, 1.0}, {59900.0, 2.0}};
+const OrderLevel kDummyAsks[] = {{60050.0, 0.3}, {60100.0, 1.5}, {60150.0, 2.5}};
 
-    snapshot.asks = {
-        {60050.0, 0.3},
-        {60100.0, 1.5},
-        {60150.0, 2.5}
-    };
+std::atomic<const Orderbook*> attachedBook{nullptr};
 
-    snapshot.timestamp = std::chrono::steady_clock::now();
-    return snapshot;
+template <size_t N>
+void fillSide(OrderBookSide& side, const OrderLevel (&levels)[N]) {
+    side.resize(N);
+    for (size_t i = 0; i < N; ++i) {
+        side.prices[i] = levels[i].price;
+        side.quantities[i] = levels[i].quantity;
+    }
+}
+
+} // namespace
+
+void attachOrderbook(const Orderbook* book) {
+    attachedBook.store(book, std::memory_order_release);
+}
+
+SnapshotHandle getCurrentOrderBookSnapshot() {
+    if (const Orderbook* book = attachedBook.load(std::memory_order_acquire)) {
+        SnapshotHandle snap = book->snapshot();
+        if (snap && !snap->bids.empty() && !snap->asks.empty()) return snap;
+    }
+
+    // Pooled like the live book: slots are refilled in place and recycled
+    // once the caller drops its handle
+    static SnapshotPublisher publisher(4, 3);
+
+    if (OrderBookSnapshot* snapshot = publisher.beginWrite()) {
+        fillSide(snapshot->bids, kDummyBids);
+        fillSide(snapshot->asks, kDummyAsks);
+        indexSnapshot(*snapshot);
+        snapshot->timestamp = std::chrono::steady_clock::now();
+        publisher.publish();
+    }
+    return publisher.acquire();
 }
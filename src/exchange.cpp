@@ -0,0 +1,102 @@
+#include "exchange.h"
+#include "crc32.h"
+#include "priceLadder.h"
+#include <nlohmann/json.hpp>
+#include <cctype>
+
+using json = nlohmann::json;
+
+// Fee lookups are resolved at compile time
+static_assert(Okx::feeRate(1, false) == 0.001, "OKX entry tier is 0.1% taker");
+static_assert(Binance::feeRate(0, false) == Binance::feeRate(1, false), "tiers below 1 clamp to the entry tier");
+static_assert(Bybit::feeRate(99, true) == Bybit::kFeeTiers[5].maker, "tiers past the table clamp to the last");
+
+namespace {
+
+// OKX checksums cover at most this many levels per side
+constexpr size_t kChecksumDepth = 25;
+
+void appendField(uint32_t& crc, bool& first, std::string_view text) {
+    if (!first) crc = crc32(":", 1, crc);
+    crc = crc32(text.data(), text.size(), crc);
+    first = false;
+}
+
+// Control messages are rare, so the full JSON parser is fine for them
+json parseControl(std::string_view payload) {
+    return json::parse(payload.begin(), payload.end(), nullptr, false);
+}
+
+} // namespace
+
+std::string Okx::subscribeMessage(std::string_view symbol, bool subscribe) {
+    json request = {{"op", subscribe ? "subscribe" : "unsubscribe"},
+                    {"args", {{{"channel", "books"}, {"instId", std::string(symbol)}}}}};
+    return request.dump();
+}
+
+std::string Okx::controlError(std::string_view payload) {
+    json message = parseControl(payload);
+    if (!message.is_object() || message.value("event", "") != "error") return {};
+    return message.value("code", "") + ": " + message.value("msg", "");
+}
+
+int32_t Okx::checksum(const PriceLadder& bids, const PriceLadder& asks) {
+    uint32_t crc = 0;
+    bool first = true;
+    size_t depth = std::max(std::min(bids.size(), kChecksumDepth), std::min(asks.size(), kChecksumDepth));
+    for (size_t i = 0; i < depth; ++i) {
+        if (i < bids.size()) {
+            appendField(crc, first, bids.textAt(i).priceView());
+            appendField(crc, first, bids.textAt(i).quantityView());
+        }
+        if (i < asks.size()) {
+            appendField(crc, first, asks.textAt(i).priceView());
+            appendField(crc, first, asks.textAt(i).quantityView());
+        }
+    }
+    return static_cast<int32_t>(crc);
+}
+
+std::string Binance::subscribeMessage(std::string_view symbol, bool subscribe) {
+    // Stream names use the lowercase symbol
+    std::string stream(symbol);
+    for (char& c : stream) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    stream += "@depth20@100ms";
+    json request = {{"method", subscribe ? "SUBSCRIBE" : "UNSUBSCRIBE"}, {"params", {stream}}, {"id", 1}};
+    return request.dump();
+}
+
+std::string Binance::controlError(std::string_view payload) {
+    json message = parseControl(payload);
+    if (!message.is_object() || !message.contains("error")) return {};
+    const json& error = message["error"];
+    if (!error.is_object()) return error.dump();
+    return std::to_string(error.value("code", 0)) + ": " + error.value("msg", "");
+}
+
+std::string Bybit::subscribeMessage(std::string_view symbol, bool subscribe) {
+    json request = {{"op", subscribe ? "subscribe" : "unsubscribe"},
+                    {"args", {"orderbook.50." + std::string(symbol)}}};
+    return request.dump();
+}
+
+std::string Bybit::controlError(std::string_view payload) {
+    json message = parseControl(payload);
+    if (!message.is_object() || message.value("success", true)) return {};
+    return message.value("ret_msg", std::string("request failed"));
+}
+
+bool parseExchangeId(std::string_view name, ExchangeId& out) {
+    auto equals = [name](std::string_view other) {
+        return name.size() == other.size() &&
+               std::equal(name.begin(), name.end(), other.begin(), [](char a, char b) {
+                   return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+               });
+    };
+    if (equals(Okx::kName)) out = ExchangeId::Okx;
+    else if (equals(Binance::kName)) out = ExchangeId::Binance;
+    else if (equals(Bybit::kName)) out = ExchangeId::Bybit;
+    else return false;
+    return true;
+}
@@ -0,0 +1,264 @@
+#include "executionSchedule.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+constexpr size_t kSchedulesPerTask = 16;
+
+// Appends one side's top levels at a fixed stride, padding with the last
+// prefix sums so a short side reads as "no more depth"
+void appendSide(const OrderBookSide& side, size_t depth, std::vector<double>& prices,
+                std::vector<double>& cumQuantity, std::vector<double>& cumNotional, std::vector<uint32_t>& counts) {
+    size_t n = std::min(depth, side.size());
+    size_t base = prices.size();
+    prices.resize(base + depth);
+    cumQuantity.resize(base + depth);
+    cumNotional.resize(base + depth);
+    double quantity = 0.0, notional = 0.0;
+    for (size_t k = 0; k < n; ++k) {
+        quantity += side.quantities[k];
+        notional += side.prices[k] * side.quantities[k];
+        prices[base + k] = side.prices[k];
+        cumQuantity[base + k] = quantity;
+        cumNotional[base + k] = notional;
+    }
+    for (size_t k = n; k < depth; ++k) {
+        prices[base + k] = n ? side.prices[n - 1] : 0.0;
+        cumQuantity[base + k] = quantity;
+        cumNotional[base + k] = notional;
+    }
+    counts.push_back(static_cast<uint32_t>(n));
+}
+
+} // namespace
+
+BookPath::BookPath(size_t levels, size_t capacity, double windowSeconds)
+    : depth(std::max<size_t>(levels, 1)), capacity(capacity),
+      windowNs(static_cast<int64_t>(std::max(windowSeconds, 0.0) * 1e9)) {}
+
+void BookPath::onPublish(const OrderBookSnapshot& snapshot) {
+    append(snapshot,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(snapshot.timestamp.time_since_epoch()).count());
+}
+
+void BookPath::append(const OrderBookSnapshot& snapshot, int64_t timestampNs) {
+    if (windowClosed) return;
+    if (snapshot.bids.empty() || snapshot.asks.empty()) return;  // no mid to price against
+    if (windowNs > 0 && !times.empty()) {
+        // Past the window once a kept state is, or (when full) this one is
+        bool full = times.size() >= capacity;
+        if (times.back() - times.front() > windowNs || (full && timestampNs - times.front() > windowNs)) {
+            windowClosed = true;
+            return;
+        }
+    }
+    if (times.size() >= capacity) {
+        ++droppedStates;
+        return;
+    }
+    OrderLevel bid = snapshot.bids.front();
+    OrderLevel ask = snapshot.asks.front();
+
+    // Volume proxy: what left the touch since the last book
+    double moved = 0.0;
+    if (!times.empty()) {
+        if (bid.price == lastBid) moved += std::max(0.0, lastBidQuantity - bid.quantity);
+        else if (bid.price < lastBid) moved += lastBidQuantity;
+        if (ask.price == lastAsk) moved += std::max(0.0, lastAskQuantity - ask.quantity);
+        else if (ask.price > lastAsk) moved += lastAskQuantity;
+    }
+    lastBid = bid.price;
+    lastBidQuantity = bid.quantity;
+    lastAsk = ask.price;
+    lastAskQuantity = ask.quantity;
+
+    times.push_back(timestampNs);
+    mids.push_back((bid.price + ask.price) / 2.0);
+    activity.push_back(moved);
+    cumulativeActivity.push_back((cumulativeActivity.empty() ? 0.0 : cumulativeActivity.back()) + moved);
+    appendSide(snapshot.bids, depth, bidPrices, bidCumQuantity, bidCumNotional, bidCounts);
+    appendSide(snapshot.asks, depth, askPrices, askCumQuantity, askCumNotional, askCounts);
+}
+
+void BookPath::clear() {
+    for (auto* column : {&mids, &activity, &cumulativeActivity, &bidPrices, &bidCumQuantity, &bidCumNotional,
+                         &askPrices, &askCumQuantity, &askCumNotional})
+        column->clear();
+    times.clear();
+    bidCounts.clear();
+    askCounts.clear();
+    windowClosed = false;
+    droppedStates = 0;
+}
+
+void BookPath::reserve(size_t states) {
+    states = std::min(states, capacity);
+    for (auto* column : {&mids, &activity, &cumulativeActivity})
+        column->reserve(states);
+    for (auto* column : {&bidPrices, &bidCumQuantity, &bidCumNotional, &askPrices, &askCumQuantity, &askCumNotional})
+        column->reserve(states * depth);
+    times.reserve(states);
+    bidCounts.reserve(states);
+    askCounts.reserve(states);
+}
+
+size_t BookPath::stateAt(int64_t timestampNs) const {
+    auto after = std::upper_bound(times.begin(), times.end(), timestampNs);
+    return after == times.begin() ? times.size() : static_cast<size_t>(after - times.begin()) - 1;
+}
+
+std::vector<double> BookPath::activityProfile(int64_t startNs, double durationSeconds, size_t slices) const {
+    slices = std::max<size_t>(slices, 1);
+    std::vector<double> profile(slices, 0.0);
+    // Proxy of the states before ns
+    auto through = [&](int64_t ns) {
+        size_t i = stateAt(ns - 1);
+        return i == times.size() ? 0.0 : cumulativeActivity[i];
+    };
+    double total = 0.0;
+    double sliceNs = durationSeconds * 1e9 / slices;
+    for (size_t s = 0; s < slices; ++s) {
+        int64_t from = startNs + static_cast<int64_t>(s * sliceNs);
+        int64_t to = startNs + static_cast<int64_t>((s + 1) * sliceNs);
+        profile[s] = through(to) - through(from);
+        total += profile[s];
+    }
+    for (double& weight : profile) weight = total > 0.0 ? weight / total : 1.0 / slices;
+    return profile;
+}
+
+double BookPath::notionalThrough(size_t i, bool asks, double quantity) const {
+    const double* prices = (asks ? askPrices : bidPrices).data() + i * depth;
+    const double* cumQuantity = (asks ? askCumQuantity : bidCumQuantity).data() + i * depth;
+    const double* cumNotional = (asks ? askCumNotional : bidCumNotional).data() + i * depth;
+    size_t n = asks ? askCounts[i] : bidCounts[i];
+    size_t k = std::lower_bound(cumQuantity, cumQuantity + n, quantity) - cumQuantity;
+    if (k == n) return cumNotional[n - 1];
+    // Level k is partly taken
+    return cumNotional[k] - (cumQuantity[k] - quantity) * prices[k];
+}
+
+FillEstimate BookPath::fillBetween(size_t i, Side side, double from, double quantity) const {
+    bool asks = side == Side::Buy;
+    double total = (asks ? askCumQuantity : bidCumQuantity)[i * depth + depth - 1];
+    double begin = std::min(from, total);
+    double end = std::min(from + quantity, total);
+    if (end <= begin) return {0.0, 0.0};
+    return {end - begin, notionalThrough(i, asks, end) - notionalThrough(i, asks, begin)};
+}
+
+ScheduleSimulator::ScheduleSimulator(size_t threads) : pool(threads) {}
+
+ScheduleCost ScheduleSimulator::simulate(const BookPath& path, const ParentOrder& order,
+                                         const ScheduleSpec& schedule) {
+    ScheduleCost cost;
+    size_t arrival = path.stateAt(order.startNs);
+    if (arrival == path.size() || order.quantity <= 0.0) {
+        cost.unfilledQuantity = std::max(order.quantity, 0.0);
+        return cost;
+    }
+    cost.arrivalPrice = path.midAt(arrival);
+
+    const int64_t lastNs = path.timestampAt(path.size() - 1);
+    const double refillNs = order.resilienceSeconds * 1e9;
+    double executed = 0.0, notional = 0.0;
+    double depletion = 0.0;  // depth our children took that has not refilled
+    int64_t previousNs = order.startNs;
+
+    // One child market order of up to quantity at atNs
+    auto child = [&](int64_t atNs, double quantity) {
+        quantity = std::min(quantity, order.quantity - executed);
+        if (quantity <= 0.0 || atNs > lastNs) return;  // nothing to do, or past the path
+        depletion = refillNs > 0.0 ? depletion * std::exp(-(atNs - previousNs) / refillNs) : 0.0;
+        previousNs = atNs;
+        FillEstimate fill = path.fillBetween(path.stateAt(atNs), order.side, depletion, quantity);
+        depletion += fill.quantity;
+        executed += fill.quantity;
+        notional += fill.notional;
+        ++cost.childOrders;
+    };
+    // Children toward cumulative targets, so a child the book could not fill
+    // in full is made up by the next
+    auto toTarget = [&](int64_t atNs, double targetFraction) {
+        child(atNs, order.quantity * targetFraction - executed);
+    };
+
+    const double durationNs = std::max(schedule.durationSeconds, 0.0) * 1e9;
+    switch (schedule.policy) {
+    case SchedulePolicy::Twap: {
+        size_t n = std::max<size_t>(schedule.slices, 1);
+        for (size_t j = 0; j < n; ++j)
+            toTarget(order.startNs + static_cast<int64_t>(j * durationNs / n), static_cast<double>(j + 1) / n);
+        break;
+    }
+    case SchedulePolicy::Vwap: {
+        const std::vector<double>& weights = schedule.volumeProfile;
+        size_t n = weights.empty() ? std::max<size_t>(schedule.slices, 1) : weights.size();
+        double total = 0.0;
+        for (double w : weights) total += std::max(w, 0.0);
+        double cumulative = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            cumulative += total > 0.0 ? std::max(weights[j], 0.0) / total : 1.0 / n;
+            toTarget(order.startNs + static_cast<int64_t>(j * durationNs / n), j + 1 == n ? 1.0 : cumulative);
+        }
+        break;
+    }
+    case SchedulePolicy::Pov: {
+        double stepNs = std::max(schedule.povIntervalSeconds, 1e-6) * 1e9;
+        size_t steps = std::max<size_t>(1, static_cast<size_t>(durationNs / stepNs + 1e-9));
+        size_t state = arrival;
+        for (size_t j = 1; j <= steps; ++j) {
+            int64_t atNs = order.startNs + static_cast<int64_t>(j * stepNs);
+            size_t now = path.stateAt(atNs);  // at or after arrival, so never size()
+            double volume = path.activityThrough(now) - path.activityThrough(state);
+            state = now;
+            child(atNs, schedule.participation * volume);
+        }
+        if (schedule.finishAtEnd) toTarget(order.startNs + static_cast<int64_t>(durationNs), 1.0);
+        break;
+    }
+    case SchedulePolicy::Custom: {
+        const std::vector<double>& holdings = schedule.trajectory.holdings;
+        if (holdings.size() < 2 || holdings[0] <= 0.0) break;
+        size_t n = holdings.size() - 1;
+        double intervalNs = schedule.trajectory.interval > 0.0 ? schedule.trajectory.interval * 1e9 : durationNs / n;
+        for (size_t j = 0; j < n; ++j)
+            toTarget(order.startNs + static_cast<int64_t>(j * intervalNs), 1.0 - holdings[j + 1] / holdings[0]);
+        break;
+    }
+    }
+
+    double unfilled = order.quantity - executed;
+    cost.executedQuantity = executed;
+    cost.unfilledQuantity = unfilled > 1e-12 * order.quantity ? unfilled : 0.0;
+    if (executed <= 0.0) return cost;
+    double sign = order.side == Side::Buy ? 1.0 : -1.0;
+    cost.averagePrice = notional / executed;
+    cost.slippageCost = sign * (notional - cost.arrivalPrice * executed);
+    cost.fees = notional * order.fees.taker;
+    cost.totalCost = cost.slippageCost + cost.fees;
+    cost.costBps = cost.totalCost / (cost.arrivalPrice * executed) * 1e4;
+    return cost;
+}
+
+std::vector<ScheduleCost> ScheduleSimulator::evaluate(const BookPath& path, const ParentOrder& order,
+                                                      const std::vector<ScheduleSpec>& candidates) {
+    std::vector<ScheduleCost> costs(candidates.size());
+    size_t tasks = (candidates.size() + kSchedulesPerTask - 1) / kSchedulesPerTask;
+    pool.parallelFor(tasks, [&](size_t task) {
+        size_t end = std::min(candidates.size(), (task + 1) * kSchedulesPerTask);
+        for (size_t i = task * kSchedulesPerTask; i < end; ++i) costs[i] = simulate(path, order, candidates[i]);
+    });
+    return costs;
+}
+
+size_t ScheduleSimulator::cheapest(const std::vector<ScheduleCost>& costs) {
+    size_t best = costs.size();
+    for (size_t i = 0; i < costs.size(); ++i) {
+        if (costs[i].unfilledQuantity > 0.0 || costs[i].executedQuantity <= 0.0) continue;
+        if (best == costs.size() || costs[i].totalCost < costs[best].totalCost) best = i;
+    }
+    return best;
+}
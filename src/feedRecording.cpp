@@ -0,0 +1,94 @@
+#include "feedRecording.h"
+#include "latency.h"
+#include "logger.h"
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kAlignment = 8;
+constexpr size_t kWriteBuffer = size_t(1) << 20;
+
+size_t padded(size_t n) {
+    return (n + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+} // namespace
+
+bool FeedRecorder::open(const std::string& path) {
+    close();
+    failed = false;
+    records = 0;
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    std::setvbuf(file, nullptr, _IOFBF, kWriteBuffer);
+
+    FeedFileHeader header{};
+    std::memcpy(header.magic, FeedFileHeader::kMagic, sizeof(header.magic));
+    header.version = FeedFileHeader::kVersion;
+    header.wallClockStartNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.steadyStartNs = latencyNow();
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void FeedRecorder::close() {
+    if (file && std::fclose(file) != 0 && !failed) {
+        failed = true;
+        LOG_ERROR("Recording", "Cannot flush the session log after {} records", records);
+    }
+    file = nullptr;
+}
+
+void FeedRecorder::fail() {
+    failed = true;
+    LOG_ERROR("Recording", "Write failed after {} records; recording stopped", records);
+}
+
+void FeedRecorder::append(std::string_view payload, int64_t receiveNs) {
+    if (!isOpen()) return;
+    static const char zeros[kAlignment] = {};
+    const size_t padding = padded(payload.size()) - payload.size();
+    FeedRecordHeader header{receiveNs, static_cast<uint32_t>(payload.size()), 0};
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+        std::fwrite(payload.data(), 1, payload.size(), file) != payload.size() ||
+        std::fwrite(zeros, 1, padding, file) != padding) {
+        fail();
+        return;
+    }
+    ++records;
+}
+
+bool FeedReader::open(const std::string& path) {
+    valid = false;
+    if (!file.open(path) || file.size() < sizeof(FeedFileHeader)) return false;
+    std::memcpy(&fileHeader, file.data(), sizeof(fileHeader));
+    if (std::memcmp(fileHeader.magic, FeedFileHeader::kMagic, sizeof(fileHeader.magic)) != 0 ||
+        fileHeader.version != FeedFileHeader::kVersion)
+        return false;
+    offset = sizeof(FeedFileHeader);
+    valid = true;
+    return true;
+}
+
+bool FeedReader::next(FeedRecord& out) {
+    if (!valid || file.size() - offset < sizeof(FeedRecordHeader)) return false;
+    FeedRecordHeader header;
+    std::memcpy(&header, file.data() + offset, sizeof(header));
+    size_t payloadAt = offset + sizeof(header);
+    if (file.size() - payloadAt < header.length) return false;
+    out.receiveNs = header.receiveNs;
+    out.payload = std::string_view(file.data() + payloadAt, header.length);
+    offset = payloadAt + padded(header.length);
+    if (offset > file.size()) offset = file.size();
+    return true;
+}
+
+void FeedReader::rewind() {
+    offset = sizeof(FeedFileHeader);
+}
@@ -0,0 +1,586 @@
+#include "feedServer.h"
+#include "crc32.h"
+#include "feedRecording.h"
+#include "latency.h"
+#include "logger.h"
+#include <ixwebsocket/IXNetSystem.h>
+#include <ixwebsocket/IXWebSocketServer.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr size_t kChecksumDepth = 25;
+constexpr size_t kStampSlots = 4096;                  // remembered send times per symbol (power of two)
+constexpr size_t kMaxBufferedBytes = size_t(4) << 20;  // per client before the stream waits
+
+const char* const kSymbolNames[] = {"BTC-USDT", "ETH-USDT", "BNB-USDT", "SOL-USDT"};
+const int64_t kSymbolMidTicks[] = {673215, 35214, 5802, 1523};
+
+using Level = std::pair<int64_t, int64_t>;  // price ticks (0.1), size lots (1e-8)
+
+// Prices and sizes formatted the way OKX sends them for BTC-USDT
+void appendFixed(std::string& out, int64_t value, int64_t scale, int decimals) {
+    char buffer[32];
+    char* p = std::to_chars(buffer, buffer + sizeof(buffer), value / scale).ptr;
+    *p++ = '.';
+    int64_t fraction = value % scale;
+    for (int i = decimals - 1; i >= 0; --i, fraction /= 10) p[i] = static_cast<char>('0' + fraction % 10);
+    out.append(buffer, static_cast<size_t>(p + decimals - buffer));
+}
+
+void appendPrice(std::string& out, int64_t ticks) {
+    appendFixed(out, ticks, 10, 1);
+}
+
+void appendSize(std::string& out, int64_t lots) {
+    appendFixed(out, lots, 100000000, 8);
+}
+
+void appendLevels(std::string& out, const std::vector<Level>& levels) {
+    out += '[';
+    for (size_t i = 0; i < levels.size(); ++i) {
+        if (i) out += ',';
+        out += "[\"";
+        appendPrice(out, levels[i].first);
+        out += "\",\"";
+        appendSize(out, levels[i].second);
+        out += "\",\"0\",\"1\"]";
+    }
+    out += ']';
+}
+
+// One side of a synthetic book, best first. direction is +1 for bids
+// (better = higher price), -1 for asks.
+struct SyntheticSide {
+    std::vector<Level> levels;
+    int64_t direction;
+
+    bool better(int64_t a, int64_t b) const { return direction * (a - b) > 0; }
+
+    // First level not better than price
+    std::vector<Level>::iterator find(int64_t price) {
+        return std::lower_bound(levels.begin(), levels.end(), price,
+                                [this](const Level& level, int64_t p) { return better(level.first, p); });
+    }
+};
+
+// One random change to one side, biased toward the top: resize, delete or
+// add a level, or move the best price (which makes the mid wander). Every
+// change is appended to changes in the order it must be applied.
+void mutateSide(SyntheticSide& side, int64_t oppositeBest, size_t depth, std::mt19937& rng,
+                std::vector<Level>& changes) {
+    std::vector<Level>& levels = side.levels;
+    auto randomLots = [&rng] { return 100000 + static_cast<int64_t>(rng() % 300000000); };
+    auto skewedIndex = [&rng](size_t n) { return static_cast<std::ptrdiff_t>(std::min(rng() % n, rng() % n)); };
+    auto remove = [&](std::vector<Level>::iterator it) {
+        changes.emplace_back(it->first, 0);
+        levels.erase(it);
+    };
+    auto insert = [&](int64_t price) {
+        if (price <= 0) return;
+        auto at = side.find(price);
+        if (at != levels.end() && at->first == price) return;
+        if (levels.size() >= depth) {
+            if (at == levels.end()) return;  // would not make the cut
+            size_t index = static_cast<size_t>(at - levels.begin());
+            remove(levels.end() - 1);
+            at = levels.begin() + static_cast<std::ptrdiff_t>(index);
+        }
+        int64_t lots = randomLots();
+        levels.emplace(at, price, lots);
+        changes.emplace_back(price, lots);
+    };
+
+    size_t n = levels.size();
+    unsigned action = n == 0 || n < depth / 2 ? 12 : rng() % 16;
+    if (action < 9) {
+        Level& level = levels[static_cast<size_t>(skewedIndex(n))];
+        level.second = randomLots();
+        changes.push_back(level);
+    } else if (action < 12 && n > 1) {
+        remove(levels.begin() + skewedIndex(n));
+    } else if (action < 15) {
+        int64_t best = n ? levels.front().first : oppositeBest - side.direction;
+        insert(best - side.direction * static_cast<int64_t>(1 + rng() % (2 * depth)));
+    } else {
+        int64_t improved = levels.front().first + side.direction;
+        if (side.better(oppositeBest, improved)) insert(improved);
+        else if (n > 1) remove(levels.begin());
+    }
+}
+
+// Self-consistent L2 book that emits OKX "books" pushes: a snapshot on
+// request, then deltas chained by seqId with checksums over the top levels.
+class SyntheticBook {
+public:
+    SyntheticBook(std::string instId, int64_t midTicks, size_t depth, uint32_t seed)
+        : instId(std::move(instId)), depth(depth), rng(seed) {
+        bids.direction = +1;
+        asks.direction = -1;
+        int64_t bid = midTicks - 1;
+        int64_t ask = midTicks + 1;
+        for (size_t i = 0; i < depth; ++i) {
+            bids.levels.emplace_back(bid, 100000 + static_cast<int64_t>(rng() % 300000000));
+            asks.levels.emplace_back(ask, 100000 + static_cast<int64_t>(rng() % 300000000));
+            bid -= 1 + static_cast<int64_t>(rng() % 2);
+            ask += 1 + static_cast<int64_t>(rng() % 2);
+        }
+    }
+
+    int64_t seqId() const { return seq; }
+
+    // Whole book as a "snapshot" push at the current seqId
+    void snapshot(std::string& out, int64_t timestampMs) {
+        writeMessage(out, "snapshot", bids.levels, asks.levels, -1, timestampMs);
+    }
+
+    // Advances the book and writes the change as an "update" push
+    void update(std::string& out, int levelsPerSide, int64_t timestampMs) {
+        bidChanges.clear();
+        askChanges.clear();
+        for (int i = 0; i < levelsPerSide; ++i) {
+            mutateSide(bids, asks.levels.front().first, depth, rng, bidChanges);
+            mutateSide(asks, bids.levels.front().first, depth, rng, askChanges);
+        }
+        int64_t prevSeqId = seq++;
+        writeMessage(out, "update", bidChanges, askChanges, prevSeqId, timestampMs);
+    }
+
+private:
+    void writeMessage(std::string& out, const char* action, const std::vector<Level>& bidLevels,
+                      const std::vector<Level>& askLevels, int64_t prevSeqId, int64_t timestampMs) {
+        char tail[128];
+        out.clear();
+        out += "{\"arg\":{\"channel\":\"books\",\"instId\":\"";
+        out += instId;
+        out += "\"},\"action\":\"";
+        out += action;
+        out += "\",\"data\":[{\"asks\":";
+        appendLevels(out, askLevels);
+        out += ",\"bids\":";
+        appendLevels(out, bidLevels);
+        int n = std::snprintf(tail, sizeof(tail), ",\"ts\":\"%lld\",\"checksum\":%d,\"prevSeqId\":%lld,\"seqId\":%lld}]}",
+                              static_cast<long long>(timestampMs), checksum(), static_cast<long long>(prevSeqId),
+                              static_cast<long long>(seq));
+        out.append(tail, static_cast<size_t>(n));
+    }
+
+    // Same layout Orderbook verifies: bidPx:bidSz:askPx:askSz:... over the top 25
+    int32_t checksum() {
+        checksumText.clear();
+        for (size_t i = 0; i < kChecksumDepth; ++i) {
+            if (i < bids.levels.size()) appendLevelText(bids.levels[i].first, bids.levels[i].second);
+            if (i < asks.levels.size()) appendLevelText(asks.levels[i].first, asks.levels[i].second);
+        }
+        return static_cast<int32_t>(crc32(checksumText.data(), checksumText.size()));
+    }
+
+    void appendLevelText(int64_t ticks, int64_t lots) {
+        if (!checksumText.empty()) checksumText += ':';
+        appendPrice(checksumText, ticks);
+        checksumText += ':';
+        appendSize(checksumText, lots);
+    }
+
+    std::string instId;
+    SyntheticSide bids;
+    SyntheticSide asks;
+    size_t depth;
+    std::mt19937 rng;
+    int64_t seq = 1000;
+    std::vector<Level> bidChanges;
+    std::vector<Level> askChanges;
+    std::string checksumText;
+};
+
+// Adds delta to the integer following key; false if the key is absent
+bool adjustField(std::string& message, std::string_view key, int64_t delta) {
+    size_t at = message.find(key);
+    if (at == std::string::npos) return false;
+    const char* begin = message.data() + at + key.size();
+    const char* end = message.data() + message.size();
+    int64_t value = 0;
+    auto parsed = std::from_chars(begin, end, value);
+    if (parsed.ec != std::errc()) return false;
+    size_t offset = static_cast<size_t>(begin - message.data());
+    message.replace(offset, static_cast<size_t>(parsed.ptr - begin), std::to_string(value + delta));
+    return true;
+}
+
+int64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+class FeedServer::Impl {
+public:
+    explicit Impl(const FeedServerConfig& config)
+        : config(config), server(config.port, config.host), rng(config.seed), faults(config.faults) {
+        ix::initNetSystem();
+        if (config.replayPath.empty()) {
+            for (size_t i = 0; i < config.symbols; ++i) {
+                int64_t mid = i < 4 ? kSymbolMidTicks[i] : 10000 + 1000 * static_cast<int64_t>(i);
+                books.emplace_back(symbolName(i), mid, std::max<size_t>(config.depth, 1),
+                                   config.seed + static_cast<uint32_t>(i));
+            }
+            stamps.reset(new SendStamp[books.size() * kStampSlots]);
+        }
+        server.disablePerMessageDeflate();
+        server.setOnClientMessageCallback(
+            [this](std::shared_ptr<ix::ConnectionState> state, ix::WebSocket& socket,
+                   const ix::WebSocketMessagePtr& msg) { onClientMessage(state->getId(), socket, msg); });
+    }
+
+    ~Impl() {
+        stop();
+        ix::uninitNetSystem();
+    }
+
+    bool start() {
+        if (running) return true;
+        if (!config.replayPath.empty()) {
+            FeedReader probe;
+            if (!probe.open(config.replayPath)) {
+                LOG_ERROR("FeedServer", "Cannot open session log {}", config.replayPath);
+                return false;
+            }
+        }
+        auto listening = server.listen();
+        if (!listening.first) {
+            LOG_ERROR("FeedServer", "Cannot listen on {}:{}: {}", config.host, config.port, listening.second);
+            return false;
+        }
+        server.start();
+        running = true;
+        streamer = std::thread(&Impl::run, this);
+        LOG_INFO("FeedServer", "Listening on ws://{}:{}", config.host, config.port);
+        return true;
+    }
+
+    void stop() {
+        if (!running) return;
+        running = false;
+        if (streamer.joinable()) streamer.join();
+        server.stop();
+    }
+
+    void setFaults(const FeedFaults& f) {
+        std::lock_guard<std::mutex> lock(mutex);
+        faults = f;
+    }
+
+    FeedServerStats stats() {
+        FeedServerStats s;
+        s.messages = messages.load(std::memory_order_relaxed);
+        s.bytes = bytes.load(std::memory_order_relaxed);
+        s.dropped = dropped.load(std::memory_order_relaxed);
+        s.gaps = gaps.load(std::memory_order_relaxed);
+        s.corrupted = corrupted.load(std::memory_order_relaxed);
+        s.disconnects = disconnects.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex);
+        s.clients = sessions.size();
+        return s;
+    }
+
+    int64_t sendTimeNs(size_t symbol, int64_t seqId) const {
+        if (symbol >= books.size() || seqId < 0) return 0;
+        const SendStamp& stamp = stamps[symbol * kStampSlots + (static_cast<size_t>(seqId) & (kStampSlots - 1))];
+        // The slot may be overwritten while we read it, so confirm the seqId around the read
+        if (stamp.seqId.load() != seqId) return 0;
+        int64_t sentNs = stamp.sentNs.load();
+        return stamp.seqId.load() == seqId ? sentNs : 0;
+    }
+
+private:
+    struct Session {
+        ix::WebSocket* socket;      // owned by the server; valid until the Close callback
+        std::string id;
+        std::vector<bool> subscribed;  // per synthetic symbol
+        std::unique_ptr<FeedReader> replay;  // own cursor into the session log, once subscribed
+        bool closing = false;
+    };
+
+    struct SendStamp {
+        std::atomic<int64_t> seqId{-1};
+        std::atomic<int64_t> sentNs{0};
+    };
+
+    void onClientMessage(const std::string& id, ix::WebSocket& socket, const ix::WebSocketMessagePtr& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (msg->type == ix::WebSocketMessageType::Open) {
+            Session& session = sessions[id];
+            session.socket = &socket;
+            session.id = id;
+            session.subscribed.assign(books.size(), false);
+            LOG_INFO("FeedServer", "Client {} connected", id);
+        } else if (msg->type == ix::WebSocketMessageType::Close) {
+            sessions.erase(id);
+            LOG_INFO("FeedServer", "Client {} disconnected", id);
+        } else if (msg->type == ix::WebSocketMessageType::Message) {
+            auto it = sessions.find(id);
+            if (it != sessions.end()) handleRequest(it->second, msg->str);
+        }
+    }
+
+    // subscribe/unsubscribe ops and pings, answered like OKX does
+    void handleRequest(Session& session, const std::string& text) {
+        if (text == "ping") {
+            session.socket->send("pong");
+            return;
+        }
+        json request = json::parse(text, nullptr, false);
+        std::string op = request.is_object() ? request.value("op", "") : "";
+        if ((op != "subscribe" && op != "unsubscribe") || !request["args"].is_array()) {
+            sendError(session, "60012", "Invalid request: " + text);
+            return;
+        }
+        for (const auto& arg : request["args"]) {
+            std::string channel = arg.value("channel", "");
+            std::string instId = arg.value("instId", "");
+            size_t symbol = findSymbol(instId);
+            if (channel != "books" || symbol == SIZE_MAX) {
+                sendError(session, "60018", "Wrong URL or channel:" + channel + ",instId:" + instId + " doesn't exist");
+                continue;
+            }
+            json ack = {{"event", op}, {"arg", {{"channel", channel}, {"instId", instId}}}, {"connId", session.id}};
+            session.socket->send(ack.dump());
+            if (op == "subscribe") subscribe(session, symbol);
+            else unsubscribe(session, symbol);
+        }
+    }
+
+    void subscribe(Session& session, size_t symbol) {
+        if (!config.replayPath.empty()) {
+            // Each subscription replays the log from the start
+            session.replay.reset(new FeedReader());
+            if (!session.replay->open(config.replayPath)) session.replay.reset();
+            return;
+        }
+        if (session.subscribed[symbol]) return;
+        session.subscribed[symbol] = true;
+        books[symbol].snapshot(scratch, wallClockMs());
+        send(session, scratch);
+    }
+
+    void unsubscribe(Session& session, size_t symbol) {
+        if (!config.replayPath.empty()) session.replay.reset();
+        else session.subscribed[symbol] = false;
+    }
+
+    // Index of a synthetic symbol; a session log answers to any instId
+    size_t findSymbol(const std::string& instId) const {
+        if (!config.replayPath.empty()) return 0;
+        for (size_t i = 0; i < books.size(); ++i)
+            if (symbolName(i) == instId) return i;
+        return SIZE_MAX;
+    }
+
+    void sendError(Session& session, const char* code, const std::string& message) {
+        json error = {{"event", "error"}, {"code", code}, {"msg", message}, {"connId", session.id}};
+        session.socket->send(error.dump());
+    }
+
+    void send(Session& session, const std::string& message) {
+        session.socket->send(message);
+        messages.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(message.size(), std::memory_order_relaxed);
+    }
+
+    bool roll(double probability) {
+        return probability > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng) < probability;
+    }
+
+    // Sends one stream message to a session, applying the configured faults
+    void deliver(Session& session, const std::string& message, bool isUpdate) {
+        if (session.closing) return;
+        if (roll(faults.disconnect)) {
+            session.closing = true;
+            closeRequests.push_back(session.socket);
+            disconnects.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (roll(faults.drop)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        bool gap = isUpdate && roll(faults.gap);
+        bool corrupt = roll(faults.corrupt);
+        if (!gap && !corrupt) {
+            send(session, message);
+            return;
+        }
+        faulty = message;
+        if (gap && adjustField(faulty, "\"prevSeqId\":", 1)) gaps.fetch_add(1, std::memory_order_relaxed);
+        if (corrupt && adjustField(faulty, "\"checksum\":", 1)) corrupted.fetch_add(1, std::memory_order_relaxed);
+        send(session, faulty);
+    }
+
+    // True while any client has more unsent data queued than we allow
+    bool backlogged() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& entry : sessions)
+            if (!entry.second.closing && entry.second.socket->bufferedAmount() > kMaxBufferedBytes) return true;
+        return false;
+    }
+
+    // One update per subscribed symbol; false if nobody is subscribed
+    bool streamSynthetic() {
+        bool sent = false;
+        int64_t timestampMs = wallClockMs();
+        for (size_t symbol = 0; symbol < books.size(); ++symbol) {
+            bool wanted = false;
+            for (auto& entry : sessions) wanted = wanted || entry.second.subscribed[symbol];
+            if (!wanted) continue;
+
+            SyntheticBook& book = books[symbol];
+            book.update(scratch, config.levelsPerUpdate, timestampMs);
+            SendStamp& stamp = stamps[symbol * kStampSlots + (static_cast<size_t>(book.seqId()) & (kStampSlots - 1))];
+            stamp.seqId.store(-1);
+            stamp.sentNs.store(latencyNow());
+            stamp.seqId.store(book.seqId());
+            for (auto& entry : sessions)
+                if (entry.second.subscribed[symbol]) deliver(entry.second, scratch, true);
+            sent = true;
+        }
+        return sent;
+    }
+
+    // Next recorded message for every subscribed session, looping at the end
+    bool streamRecorded() {
+        bool sent = false;
+        FeedRecord record;
+        for (auto& entry : sessions) {
+            Session& session = entry.second;
+            if (!session.replay) continue;
+            if (!session.replay->next(record)) {
+                session.replay->rewind();
+                if (!session.replay->next(record)) continue;
+            }
+            scratch.assign(record.payload.data(), record.payload.size());
+            deliver(session, scratch, scratch.find("\"action\":\"update\"") != std::string::npos);
+            sent = true;
+        }
+        return sent;
+    }
+
+    // Closes the connections picked for a disconnect fault. Done outside the
+    // lock because close() may report the closure through our own callback;
+    // the server's handles keep the sockets alive meanwhile.
+    void closeRequested() {
+        std::vector<ix::WebSocket*> targets;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            targets.swap(closeRequests);
+        }
+        for (const auto& client : server.getClients())
+            for (ix::WebSocket* target : targets)
+                if (client.get() == target) client->close();
+    }
+
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        auto interval = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(config.rate > 0.0 ? 1.0 / config.rate : 0.0));
+        auto next = Clock::now();
+        while (running) {
+            if (backlogged()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            bool sent;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                sent = config.replayPath.empty() ? streamSynthetic() : streamRecorded();
+            }
+            if (!closeRequests.empty()) closeRequested();
+            if (!sent) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                next = Clock::now();
+                continue;
+            }
+            if (config.rate <= 0.0) continue;
+
+            // Sleep only for gaps the scheduler can honour; shorter ones are
+            // spun off so high rates stay accurate on average
+            next += interval;
+            auto now = Clock::now();
+            if (now - next > std::chrono::seconds(1)) next = now;  // stalled; don't burst to catch up
+            while (running && (now = Clock::now()) < next) {
+                if (next - now > std::chrono::milliseconds(2)) std::this_thread::sleep_for(next - now - std::chrono::milliseconds(1));
+                else std::this_thread::yield();
+            }
+        }
+    }
+
+    FeedServerConfig config;
+    ix::WebSocketServer server;
+
+    std::mutex mutex;  // guards everything below up to the counters
+    std::map<std::string, Session> sessions;
+    std::vector<SyntheticBook> books;
+    std::mt19937 rng;
+    FeedFaults faults;
+    std::string scratch;
+    std::string faulty;
+    std::vector<ix::WebSocket*> closeRequests;  // see closeRequested()
+
+    std::unique_ptr<SendStamp[]> stamps;  // kStampSlots per synthetic symbol
+
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> gaps{0};
+    std::atomic<uint64_t> corrupted{0};
+    std::atomic<uint64_t> disconnects{0};
+
+    std::atomic<bool> running{false};
+    std::thread streamer;
+};
+
+FeedServer::FeedServer(const FeedServerConfig& config) : impl(new Impl(config)) {}
+
+FeedServer::~FeedServer() {
+    delete impl;
+}
+
+bool FeedServer::start() {
+    return impl->start();
+}
+
+void FeedServer::stop() {
+    impl->stop();
+}
+
+void FeedServer::setFaults(const FeedFaults& faults) {
+    impl->setFaults(faults);
+}
+
+FeedServerStats FeedServer::stats() const {
+    return impl->stats();
+}
+
+int64_t FeedServer::sendTimeNs(size_t symbol, int64_t seqId) const {
+    return impl->sendTimeNs(symbol, seqId);
+}
+
+std::string FeedServer::symbolName(size_t i) {
+    if (i < sizeof(kSymbolNames) / sizeof(kSymbolNames[0])) return kSymbolNames[i];
+    return "SYM" + std::to_string(i) + "-USDT";
+}
@@ -0,0 +1,105 @@
+// Local OKX-compatible feed for load tests (see FeedServer). Point the
+// client at it with e.g. `tradesim_headless --url ws://127.0.0.1:8765`.
+//
+//   tradesim_feed_server [--host H] [--port N] [--symbols N] [--depth N] [--levels N]
+//                        [--rate MSGS_PER_S] [--replay FILE] [--drop P] [--gap P]
+//                        [--corrupt P] [--disconnect P] [--seed N] [--duration SECONDS]
+//
+// --rate 0 streams as fast as the slowest client reads. Fault rates are
+// per-message, per-client probabilities.
+#include "feedServer.h"
+#include "logger.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> stopRequested{false};
+
+void onSignal(int) {
+    stopRequested.store(true);
+}
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "usage: tradesim_feed_server [--host H] [--port N] [--symbols N] [--depth N] [--levels N]\n"
+                 "                            [--rate MSGS_PER_S] [--replay FILE] [--drop P] [--gap P]\n"
+                 "                            [--corrupt P] [--disconnect P] [--seed N] [--duration SECONDS]\n");
+}
+
+bool parseOptions(int argc, char** argv, FeedServerConfig& config, double& durationSeconds) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--host") config.host = value;
+        else if (arg == "--port") config.port = std::atoi(value);
+        else if (arg == "--symbols") config.symbols = static_cast<size_t>(std::atoi(value));
+        else if (arg == "--depth") config.depth = static_cast<size_t>(std::atoi(value));
+        else if (arg == "--levels") config.levelsPerUpdate = std::atoi(value);
+        else if (arg == "--rate") config.rate = std::atof(value);
+        else if (arg == "--replay") config.replayPath = value;
+        else if (arg == "--drop") config.faults.drop = std::atof(value);
+        else if (arg == "--gap") config.faults.gap = std::atof(value);
+        else if (arg == "--corrupt") config.faults.corrupt = std::atof(value);
+        else if (arg == "--disconnect") config.faults.disconnect = std::atof(value);
+        else if (arg == "--seed") config.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--duration") durationSeconds = std::atof(value);
+        else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return config.symbols > 0 && config.depth > 0 && config.levelsPerUpdate > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    FeedServerConfig config;
+    double durationSeconds = 0.0;  // 0 = until interrupted
+    if (!parseOptions(argc, argv, config, durationSeconds)) {
+        printUsage();
+        return 2;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    FeedServer server(config);
+    if (!server.start()) {
+        Logger::instance().flush();
+        return 1;
+    }
+
+    // One stats line per second
+    auto start = std::chrono::steady_clock::now();
+    FeedServerStats last = server.stats();
+    while (!stopRequested.load()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        FeedServerStats now = server.stats();
+        std::fprintf(stderr,
+                     "clients %zu  msgs/s %llu  MB/s %.2f  dropped %llu  gaps %llu  corrupted %llu  disconnects %llu\n",
+                     now.clients, static_cast<unsigned long long>(now.messages - last.messages),
+                     (now.bytes - last.bytes) / 1e6, static_cast<unsigned long long>(now.dropped),
+                     static_cast<unsigned long long>(now.gaps), static_cast<unsigned long long>(now.corrupted),
+                     static_cast<unsigned long long>(now.disconnects));
+        last = now;
+        if (durationSeconds > 0.0 &&
+            std::chrono::steady_clock::now() - start >= std::chrono::duration<double>(durationSeconds))
+            break;
+    }
+
+    server.stop();
+    Logger::instance().flush();
+    return 0;
+}
@@ -0,0 +1,622 @@
+// GUI-free runner. Streams a venue's book (live, or replayed from an OKX
+// capture) and writes one simulation result per book update, as JSON lines,
+// to stdout or a file. No render loop, so results come out at feed rate.
+//
+//   tradesim_headless [--exchange okx|binance|bybit] [--url URL] [--symbol INST] [--record FILE]
+//                     [--replay FILE] [--pace fast|original] [--speed X] [--quantity Q]
+//                     [--side buy|sell|both] [--fee-tier N] [--horizon SECONDS] [--duration SECONDS]
+//                     [--output FILE] [--history DIR] [--share] [--rest-bps BPS]
+//                     [--schedules SECONDS] [--validate-slippage]
+//   tradesim_headless --symbols INST,INST,... [--shards N] [--url URL] [--quantity Q] [--side buy|sell|both]
+//                     [--fee-tier N] [--duration SECONDS] [--output FILE]
+//
+//   --exchange V          venue whose book is streamed (default okx)
+//   --url URL             feed endpoint; the venue's public one by default, or a
+//                         local tradesim_feed_server for load tests
+//   --symbol INST         instrument (default BTC/USDT on the venue)
+//   --record FILE         write the live session to a binary log (see FeedRecorder)
+//   --replay FILE         play such a log back instead of connecting; read as OKX --symbol
+//   --pace, --speed       replay timing: as fast as possible, or the original gaps / X
+//   --quantity Q          order size in the base asset (default 1)
+//   --side S              which market orders to simulate (default buy)
+//   --fee-tier N          row of the venue's fee schedule, 1 = entry tier
+//   --horizon SECONDS     Almgren-Chriss working horizon (default 60, see models/impact.h)
+//   --duration SECONDS    stop after this long (default: until interrupted)
+//   --output FILE         JSON lines go here instead of stdout
+//   --history DIR         record the top of every book into segment files (see BookHistory)
+//   --share               publish the book into shared memory (see SharedBookPublisher)
+//   --rest-bps BPS        keep a post-only order resting BPS behind the touch and print
+//                         its fills at exit (see MatchingEngine)
+//   --schedules SECONDS   at exit, compare TWAP/VWAP/POV schedules of up to SECONDS
+//                         (see ScheduleSimulator)
+//   --validate-slippage   score each slippage band against the simulated fill
+//   --symbols LIST        several OKX books through a ShardedFeed; market sweeps only
+//   --shards N            decode workers for --symbols (default 2)
+//
+// Each result also carries the impact-model cost, the maker probability
+// (see MakerTakerModel), the slippage band (see SlippageModel) and the
+// feed's features (see FeatureEngine).
+#include "bookFeatures.h"
+#include "bookHistory.h"
+#include "bookRegistry.h"
+#include "exchange.h"
+#include "executionSchedule.h"
+#include "logger.h"
+#include "latency.h"
+#include "matchingEngine.h"
+#include "models/impact.h"
+#include "models/makerTaker.h"
+#include "models/slippage.h"
+#include "orderbook.h"
+#include "replaySource.h"
+#include "sharedBookPublisher.h"
+#include "shardedFeed.h"
+#include "tradeSim.h"
+#include "webSocketClient.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+
+namespace {
+
+struct Options {
+    ExchangeId exchange = ExchangeId::Okx;
+    std::string url;     // empty: the venue's default
+    std::string symbol;  // empty: the venue's default
+    std::vector<std::string> symbols;  // --symbols: several OKX books through a ShardedFeed
+    size_t shards = 2;
+    std::string replayPath;
+    std::string recordPath;
+    ReplayPacing pacing = ReplayPacing::AsFastAsPossible;
+    double speed = 1.0;
+    std::string outputPath;
+    double quantity = 1.0;  // base asset
+    bool buy = true;
+    bool sell = false;
+    int feeTier = 1;
+    FeeTier fees{};  // the venue's rates for feeTier
+    double horizonSeconds = 60.0;  // for the impact estimate
+    double durationSeconds = 0.0;  // 0 = until interrupted
+    std::string historyDirectory;  // empty: no history
+    bool share = false;
+    double restBps = -1.0;  // < 0: no resting orders
+    double scheduleSeconds = 0.0;  // 0: no schedule evaluation
+    bool validateSlippage = false;
+};
+
+std::atomic<bool> stopRequested{false};
+
+// Trained on the feed thread by whichever book is running
+MakerTakerModel makerTaker;
+SlippageModel slippageModel;
+FeatureEngine features;
+SlippageValidation slippageValidation;  // simulation thread only
+
+void onSignal(int) {
+    stopRequested.store(true);
+}
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "usage: tradesim_headless [--exchange okx|binance|bybit] [--url URL] [--symbol INST]\n"
+                 "                         [--record FILE] [--replay FILE] [--pace fast|original] [--speed X]\n"
+                 "                         [--quantity Q] [--side buy|sell|both] [--fee-tier N]\n"
+                 "                         [--horizon SECONDS] [--duration SECONDS] [--output FILE]\n"
+                 "                         [--history DIR] [--share] [--rest-bps BPS] [--schedules SECONDS]\n"
+                 "                         [--validate-slippage]\n"
+                 "       tradesim_headless --symbols INST,INST,... [--shards N] [--url URL] [--quantity Q]\n"
+                 "                         [--side buy|sell|both] [--fee-tier N] [--duration SECONDS]\n"
+                 "                         [--output FILE]\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h") return false;
+        if (arg == "--validate-slippage") {
+            options.validateSlippage = true;
+            continue;
+        }
+        if (arg == "--share") {
+            options.share = true;
+            continue;
+        }
+        if (!hasValue) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--exchange") {
+            if (!parseExchangeId(value, options.exchange)) {
+                std::fprintf(stderr, "unknown exchange %s\n", value);
+                return false;
+            }
+        } else if (arg == "--url") {
+            options.url = value;
+        } else if (arg == "--symbol") {
+            options.symbol = value;
+        } else if (arg == "--symbols") {
+            std::string list = value;
+            for (size_t begin = 0; begin <= list.size();) {
+                size_t end = std::min(list.find(',', begin), list.size());
+                if (end > begin) options.symbols.push_back(list.substr(begin, end - begin));
+                begin = end + 1;
+            }
+        } else if (arg == "--shards") {
+            options.shards = static_cast<size_t>(std::max(1, std::atoi(value)));
+        } else if (arg == "--replay") {
+            options.replayPath = value;
+        } else if (arg == "--record") {
+            options.recordPath = value;
+        } else if (arg == "--pace") {
+            if (std::strcmp(value, "original") == 0) options.pacing = ReplayPacing::Original;
+            else if (std::strcmp(value, "fast") == 0) options.pacing = ReplayPacing::AsFastAsPossible;
+            else {
+                std::fprintf(stderr, "unknown pace %s\n", value);
+                return false;
+            }
+        } else if (arg == "--speed") {
+            options.speed = std::atof(value);
+        } else if (arg == "--output") {
+            options.outputPath = value;
+        } else if (arg == "--quantity") {
+            options.quantity = std::atof(value);
+        } else if (arg == "--fee-tier") {
+            options.feeTier = std::atoi(value);
+        } else if (arg == "--horizon") {
+            options.horizonSeconds = std::atof(value);
+        } else if (arg == "--duration") {
+            options.durationSeconds = std::atof(value);
+        } else if (arg == "--history") {
+            options.historyDirectory = value;
+        } else if (arg == "--rest-bps") {
+            options.restBps = std::atof(value);
+        } else if (arg == "--schedules") {
+            options.scheduleSeconds = std::atof(value);
+        } else if (arg == "--side") {
+            options.buy = std::strcmp(value, "buy") == 0 || std::strcmp(value, "both") == 0;
+            options.sell = std::strcmp(value, "sell") == 0 || std::strcmp(value, "both") == 0;
+            if (!options.buy && !options.sell) {
+                std::fprintf(stderr, "unknown side %s\n", value);
+                return false;
+            }
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    if (!options.replayPath.empty() && options.exchange != ExchangeId::Okx) {
+        std::fprintf(stderr, "--replay reads OKX captures only\n");
+        return false;
+    }
+    if (!options.symbols.empty() &&
+        (options.exchange != ExchangeId::Okx || !options.symbol.empty() || !options.replayPath.empty() ||
+         !options.recordPath.empty() || !options.historyDirectory.empty() || options.share ||
+         options.restBps >= 0.0 || options.scheduleSeconds > 0.0 || options.validateSlippage)) {
+        std::fprintf(stderr, "--symbols streams live OKX books only, without --symbol, --replay, --record, "
+                             "--history, --share, --rest-bps, --schedules or --validate-slippage\n");
+        return false;
+    }
+    return options.quantity > 0.0;
+}
+
+void writeResult(FILE* out, const OrderBookSnapshot& book, const char* side, const TradeResult& r,
+                 const ImpactEstimate& impact, double makerProbability, const SlippageBand& band,
+                 const BookFeatures& f) {
+    std::fprintf(out,
+                 "{\"version\":%llu,\"side\":\"%s\",\"executedQuantity\":%.8f,\"averagePrice\":%.8f,"
+                 "\"slippage\":%.8g,\"fees\":%.8f,\"marketImpact\":%.8g,\"totalCost\":%.8f,"
+                 "\"totalProceeds\":%.8f,\"impactCost\":%.8g,\"impactStdDev\":%.8g,\"makerProbability\":%.4f,"
+                 "\"slippageLowBps\":%.4f,\"slippageMedianBps\":%.4f,\"slippageHighBps\":%.4f,"
+                 "\"microprice\":%.8f,\"orderFlowImbalance\":%.8g,\"realizedVolatility\":%.6g,"
+                 "\"latencyUs\":%.3f}\n",
+                 static_cast<unsigned long long>(book.version), side, r.executedQuantity, r.averagePrice,
+                 r.slippage, r.feesPaid, r.marketImpact, r.totalCost, r.totalProceeds, impact.expectedCost,
+                 std::sqrt(impact.variance), makerProbability, band.low, band.median, band.high, f.microprice,
+                 f.orderFlowImbalance[0], f.volatility, r.internalLatency);
+}
+
+// Simulates one side; the band is predicted for this book, so under
+// --validate-slippage it is scored against this very fill
+void simulateSide(const Options& options, const OrderBookSnapshot& book, Side side, const ImpactEstimate& impact,
+                  std::chrono::steady_clock::time_point now, FILE* out) {
+    TradeResult r = simulateMarketOrder(book, side, options.quantity, options.fees, now);
+    double mid = (book.bids.front().price + book.asks.front().price) / 2.0;
+    SlippageBand band = slippageModel.quantiles(book, options.quantity * mid, side);
+    if (options.validateSlippage)
+        slippageValidation.add(SlippageCheck{band, r.slippage * 1e4, r.executedQuantity >= options.quantity});
+    writeResult(out, book, side == Side::Buy ? "buy" : "sell", r, impact, makerTaker.predict(side), band,
+                features.latest());
+}
+
+// Simulates the configured order(s) against one published book
+void simulate(const Options& options, const OrderBookSnapshot& book, FILE* out) {
+    if (book.bids.empty() || book.asks.empty()) return;
+    static const MarketImpactModel impactModel;
+    auto now = std::chrono::steady_clock::now();
+    // The calibration averages both sides, so one estimate serves either
+    ImpactEstimate impact = impactModel.estimate(calibrateImpact(book), options.quantity, options.horizonSeconds);
+    if (options.buy) simulateSide(options, book, Side::Buy, impact, now, out);
+    if (options.sell) simulateSide(options, book, Side::Sell, impact, now, out);
+}
+
+bool timeUp(const Options& options, std::chrono::steady_clock::time_point start) {
+    if (stopRequested.load()) return true;
+    if (options.durationSeconds <= 0.0) return false;
+    return std::chrono::steady_clock::now() - start >= std::chrono::duration<double>(options.durationSeconds);
+}
+
+// Fast replay runs on this thread and simulates after every message, so
+// results are deterministic for a given log
+uint64_t runReplayInline(const Options& options, ReplaySource& replay, Orderbook& book, FILE* out,
+                         std::chrono::steady_clock::time_point start) {
+    uint64_t simulated = 0;
+    BookUpdateResult result;
+    while (!timeUp(options, start) && replay.step(&result)) {
+        if (result != BookUpdateResult::Applied) continue;
+        if (SnapshotHandle snap = book.snapshot()) {
+            simulate(options, *snap, out);
+            ++simulated;
+        }
+    }
+    return simulated;
+}
+
+// Runs a feed source on its own thread (live websocket, or a paced replay)
+// and picks up each new book version as soon as it is published. If
+// simulation falls behind, intermediate versions are skipped rather than queued.
+uint64_t followSource(const Options& options, FeedSource& source, Orderbook& book, FILE* out,
+                      std::chrono::steady_clock::time_point start) {
+    source.start();
+    uint64_t simulated = 0;
+    uint64_t lastVersion = book.getVersion();
+    while (!timeUp(options, start)) {
+        uint64_t version = book.getVersion();
+        if (version == lastVersion) {
+            if (source.finished() && book.getVersion() == lastVersion) break;
+            std::this_thread::yield();
+            continue;
+        }
+        SnapshotHandle snap = book.snapshot();
+        if (!snap) continue;
+        lastVersion = snap->version;
+        simulate(options, *snap, out);
+        ++simulated;
+    }
+    source.stop();
+    return simulated;
+}
+
+// Book history spilling to --history, on the book's grid; null without it
+std::unique_ptr<BookHistory> openHistory(const Options& options, const InstrumentSpec& spec) {
+    if (options.historyDirectory.empty()) return nullptr;
+    HistoryConfig config;
+    config.directory = options.historyDirectory;
+    config.spec = spec;
+    return std::make_unique<BookHistory>(config);
+}
+
+// Shared-memory publisher for --share; null without it
+std::unique_ptr<SharedBookPublisher> openShared(const Options& options, std::string_view exchange,
+                                                const std::string& symbol, const InstrumentSpec& spec) {
+    if (!options.share) return nullptr;
+    auto publisher = std::make_unique<SharedBookPublisher>(std::string(exchange), symbol, spec);
+    if (publisher->isOpen()) std::fprintf(stderr, "sharing the book as %s\n", publisher->name().c_str());
+    return publisher;
+}
+
+// Keeps a post-only order resting behind the touch on each side asked for,
+// matched by its own MatchingEngine on the feed thread
+class RestingQuoter : public BookObserver {
+public:
+    RestingQuoter(const Options& options, const InstrumentSpec& spec)
+        : options(options), engine(config(options, spec)) {}
+
+    void onPublish(const OrderBookSnapshot& book) override {
+        engine.onPublish(book);
+        engine.drainFills(fills);  // only the totals are reported
+        if (book.bids.empty() || book.asks.empty()) return;
+        double distance = options.restBps / 10000.0;
+        if (options.buy && !engine.isResting(buyOrder))
+            buyOrder = engine.submit({Side::Buy, OrderType::PostOnly, book.bids.front().price * (1.0 - distance),
+                                      options.quantity});
+        if (options.sell && !engine.isResting(sellOrder))
+            sellOrder = engine.submit({Side::Sell, OrderType::PostOnly, book.asks.front().price * (1.0 + distance),
+                                       options.quantity});
+    }
+
+    const MatchingStats& stats() const { return engine.stats(); }
+
+private:
+    static MatchingConfig config(const Options& options, const InstrumentSpec& spec) {
+        MatchingConfig c;
+        c.spec = spec;
+        c.fees = options.fees;
+        return c;
+    }
+
+    const Options& options;
+    MatchingEngine engine;
+    std::vector<SimFill> fills;
+    OrderId buyOrder = 0;
+    OrderId sellOrder = 0;
+};
+
+// Resting quoter for --rest-bps; null without it
+std::unique_ptr<RestingQuoter> openQuoter(const Options& options, const InstrumentSpec& spec) {
+    return options.restBps < 0.0 ? nullptr : std::make_unique<RestingQuoter>(options, spec);
+}
+
+void printRestingSummary(const MatchingStats& s) {
+    std::fprintf(stderr,
+                 "resting orders: %llu placed, %llu filled (mean %.3f s, max %.3f s to fill), "
+                 "%.8g maker / %.8g taker filled (maker share %.3f), %llu rejected, fees %.6f\n",
+                 static_cast<unsigned long long>(s.submitted), static_cast<unsigned long long>(s.restedFills),
+                 s.meanTimeToFillSeconds(), s.maxTimeToFillNs / 1e9, s.makerQuantity, s.takerQuantity,
+                 s.makerTakerRatio(), static_cast<unsigned long long>(s.rejected), s.fees);
+}
+
+// Book path for --schedules, covering its window only; null without it.
+// Allocated up front for kScheduleBooksPerSecond, so recording never
+// reallocates on the feed thread; books past that are counted as dropped.
+constexpr double kScheduleBooksPerSecond = 200.0;
+
+std::unique_ptr<BookPath> openPath(const Options& options) {
+    if (options.scheduleSeconds <= 0.0) return nullptr;
+    double states = std::min(options.scheduleSeconds * kScheduleBooksPerSecond + 2.0, double(1 << 20));
+    auto path = std::make_unique<BookPath>(25, static_cast<size_t>(states), options.scheduleSeconds);
+    path->reserve(static_cast<size_t>(states));
+    return path;
+}
+
+// Cheapest of TWAP, VWAP and POV schedules for each side asked for
+void printScheduleSummary(const Options& options, const BookPath& path) {
+    if (path.size() == 0) return;
+    if (path.dropped())
+        std::fprintf(stderr,
+                     "schedules: %llu books dropped above %.0f per second; the path covers %.3f s of the window\n",
+                     static_cast<unsigned long long>(path.dropped()), kScheduleBooksPerSecond,
+                     (path.timestampAt(path.size() - 1) - path.timestampAt(0)) / 1e9);
+    std::vector<ScheduleSpec> candidates;
+    for (size_t slices = 1; slices <= 60; ++slices) {
+        ScheduleSpec twap;
+        twap.durationSeconds = options.scheduleSeconds;
+        twap.slices = slices;
+        candidates.push_back(twap);
+        ScheduleSpec vwap = twap;
+        vwap.policy = SchedulePolicy::Vwap;
+        vwap.volumeProfile = path.activityProfile(path.timestampAt(0), options.scheduleSeconds, slices);
+        candidates.push_back(vwap);
+    }
+    for (double participation = 0.01; participation <= 0.5; participation *= 1.25) {
+        ScheduleSpec pov;
+        pov.policy = SchedulePolicy::Pov;
+        pov.durationSeconds = options.scheduleSeconds;
+        pov.participation = participation;
+        candidates.push_back(pov);
+    }
+    static const char* const kPolicyNames[] = {"twap", "vwap", "pov", "custom"};
+
+    ScheduleSimulator simulator;
+    for (Side side : {Side::Buy, Side::Sell}) {
+        if (!(side == Side::Buy ? options.buy : options.sell)) continue;
+        ParentOrder order;
+        order.side = side;
+        order.quantity = options.quantity;
+        order.startNs = path.timestampAt(0);
+        order.fees = options.fees;
+        std::vector<ScheduleCost> costs = simulator.evaluate(path, order, candidates);
+        size_t best = ScheduleSimulator::cheapest(costs);
+        const char* sideName = side == Side::Buy ? "buy" : "sell";
+        if (best == costs.size()) {
+            std::fprintf(stderr, "schedules (%s): none of %zu filled within the recorded books\n", sideName,
+                         candidates.size());
+            continue;
+        }
+        const ScheduleSpec& spec = candidates[best];
+        const ScheduleCost& c = costs[best];
+        std::fprintf(stderr,
+                     "schedules (%s): cheapest of %zu is %s with %zu children, %.2f bps "
+                     "(slippage %.6f, fees %.6f); one sweep at arrival %.2f bps\n",
+                     sideName, candidates.size(), kPolicyNames[static_cast<int>(spec.policy)], c.childOrders,
+                     c.costBps, c.slippageCost, c.fees, costs[0].costBps);
+    }
+}
+
+// Live feed from one venue; the book and client are built for Venue, so the
+// message path has no venue checks left in it. False if recording fails to
+// open or a write to it fails.
+template <class Venue>
+bool runLive(const Options& options, FILE* out, std::chrono::steady_clock::time_point start, uint64_t& simulated) {
+    std::string url = options.url.empty() ? std::string(Venue::kDefaultUrl) : options.url;
+    std::string symbol = options.symbol.empty() ? std::string(Venue::kDefaultSymbol) : options.symbol;
+    FeedRecorder recorder;
+    if (!options.recordPath.empty() && !recorder.open(options.recordPath)) {
+        std::fprintf(stderr, "cannot open %s for recording\n", options.recordPath.c_str());
+        return false;
+    }
+    InstrumentSpec spec = Venue::instrument(symbol);
+    Orderbook book(400, 400, spec);
+    book.addObserver(&makerTaker);
+    book.addObserver(&slippageModel);
+    book.addObserver(&features);
+    std::unique_ptr<BookHistory> history = openHistory(options, spec);
+    if (history) book.addObserver(history.get());
+    std::unique_ptr<SharedBookPublisher> shared = openShared(options, Venue::kName, symbol, spec);
+    if (shared) book.addObserver(shared.get());
+    std::unique_ptr<RestingQuoter> quoter = openQuoter(options, spec);
+    if (quoter) book.addObserver(quoter.get());
+    std::unique_ptr<BookPath> path = openPath(options);
+    if (path) book.addObserver(path.get());
+    BasicWebSocketClient<Venue> client(url, book, symbol);
+    if (recorder.isOpen()) client.setRecorder(&recorder);
+    simulated = followSource(options, client, book, out, start);
+    std::fprintf(stderr, "%llu resyncs\n", static_cast<unsigned long long>(client.resyncCount()));
+    if (quoter) printRestingSummary(quoter->stats());
+    if (path) printScheduleSummary(options, *path);
+    recorder.close();
+    if (recorder.writeFailed()) {
+        std::fprintf(stderr, "recording to %s failed; the log holds at most the first %llu messages\n",
+                     options.recordPath.c_str(), static_cast<unsigned long long>(recorder.recordCount()));
+        return false;
+    }
+    return true;
+}
+
+// Market order sweeps for one book of a --symbols session
+void simulateSymbol(const Options& options, const std::string& symbol, const OrderBookSnapshot& book, FILE* out) {
+    if (book.bids.empty() || book.asks.empty()) return;
+    auto now = std::chrono::steady_clock::now();
+    for (Side side : {Side::Buy, Side::Sell}) {
+        if (!(side == Side::Buy ? options.buy : options.sell)) continue;
+        TradeResult r = simulateMarketOrder(book, side, options.quantity, options.fees, now);
+        std::fprintf(out,
+                     "{\"symbol\":\"%s\",\"version\":%llu,\"side\":\"%s\",\"executedQuantity\":%.8f,"
+                     "\"averagePrice\":%.8f,\"slippage\":%.8g,\"fees\":%.8f,\"marketImpact\":%.8g,"
+                     "\"totalCost\":%.8f,\"totalProceeds\":%.8f,\"latencyUs\":%.3f}\n",
+                     symbol.c_str(), static_cast<unsigned long long>(book.version),
+                     side == Side::Buy ? "buy" : "sell", r.executedQuantity, r.averagePrice, r.slippage, r.feesPaid,
+                     r.marketImpact, r.totalCost, r.totalProceeds, r.internalLatency);
+    }
+}
+
+// --symbols: every book on a ShardedFeed, simulated as each new version
+// shows up; versions published while another book is simulated are skipped
+uint64_t runSharded(const Options& options, FILE* out, std::chrono::steady_clock::time_point start) {
+    BookRegistry registry;
+    for (const std::string& symbol : options.symbols)
+        registry.add({std::string(Okx::kName), symbol}, Okx::instrument(symbol));
+    ShardedFeedConfig config;
+    config.url = options.url.empty() ? std::string(Okx::kDefaultUrl) : options.url;
+    config.shards = options.shards;
+    ShardedFeed feed(registry, config);
+    std::fprintf(stderr, "streaming %zu books over %zu connections on %zu shards\n", feed.symbolCount(),
+                 feed.connectionCount(), feed.shardCount());
+
+    feed.start();
+    uint64_t simulated = 0;
+    std::vector<uint64_t> lastVersions(registry.size(), 0);
+    while (!timeUp(options, start)) {
+        bool any = false;
+        for (size_t i = 0; i < registry.size(); ++i) {
+            Orderbook& book = registry.bookAt(i);
+            if (book.getVersion() == lastVersions[i]) continue;
+            SnapshotHandle snap = book.snapshot();
+            if (!snap) continue;
+            lastVersions[i] = snap->version;
+            simulateSymbol(options, registry.keyAt(i).symbol, *snap, out);
+            ++simulated;
+            any = true;
+        }
+        if (!any) std::this_thread::yield();
+    }
+    feed.stop();
+    feed.mergeLatency(latencyStats());
+    std::fprintf(stderr, "%llu messages, %llu resyncs\n", static_cast<unsigned long long>(feed.messageCount()),
+                 static_cast<unsigned long long>(feed.resyncCount()));
+    return simulated;
+}
+
+void printLatencySummary() {
+    std::fprintf(stderr, "%-18s %10s %10s %10s %10s %10s\n", "stage (us)", "p50", "p99", "p99.9", "max", "count");
+    for (int i = 0; i < static_cast<int>(LatencyStage::Count); ++i) {
+        LatencyStage stage = static_cast<LatencyStage>(i);
+        LatencySummary s = latencyStats().summary(stage);
+        if (!s.count) continue;
+        std::fprintf(stderr, "%-18s %10.2f %10.2f %10.2f %10.2f %10llu\n", latencyStageName(stage),
+                     s.p50Ns / 1000.0, s.p99Ns / 1000.0, s.p999Ns / 1000.0, s.maxNs / 1000.0,
+                     static_cast<unsigned long long>(s.count));
+    }
+}
+
+void printSlippageValidation() {
+    std::fprintf(stderr,
+                 "slippage bands over %llu fills: actual below p10 %.3f, p50 %.3f, p90 %.3f; "
+                 "mean |actual - median| %.3f bps\n",
+                 static_cast<unsigned long long>(slippageValidation.count()), slippageValidation.belowLow(),
+                 slippageValidation.belowMedian(), slippageValidation.belowHigh(),
+                 slippageValidation.meanAbsErrorBps());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    FILE* out = stdout;
+    if (!options.outputPath.empty()) {
+        out = std::fopen(options.outputPath.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "cannot open %s for writing\n", options.outputPath.c_str());
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    options.fees = withExchange(options.exchange, [&](auto venue) {
+        return decltype(venue)::feeTier(options.feeTier);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t simulated = 0;
+    if (!options.symbols.empty()) {
+        simulated = runSharded(options, out, start);
+    } else if (!options.replayPath.empty()) {
+        // Captures are OKX, so the book and its observers use OKX's grid, as live
+        std::string symbol = options.symbol.empty() ? std::string(Okx::kDefaultSymbol) : options.symbol;
+        InstrumentSpec spec = Okx::instrument(symbol);
+        Orderbook book(400, 400, spec);
+        book.addObserver(&makerTaker);
+        book.addObserver(&slippageModel);
+        book.addObserver(&features);
+        std::unique_ptr<BookHistory> history = openHistory(options, spec);
+        if (history) book.addObserver(history.get());
+        std::unique_ptr<SharedBookPublisher> shared = openShared(options, Okx::kName, symbol, spec);
+        if (shared) book.addObserver(shared.get());
+        std::unique_ptr<RestingQuoter> quoter = openQuoter(options, spec);
+        if (quoter) book.addObserver(quoter.get());
+        std::unique_ptr<BookPath> path = openPath(options);
+        if (path) book.addObserver(path.get());
+        ReplaySource replay(options.replayPath, book, options.pacing, options.speed);
+        if (!replay.isOpen()) return 1;
+        simulated = options.pacing == ReplayPacing::AsFastAsPossible
+                        ? runReplayInline(options, replay, book, out, start)
+                        : followSource(options, replay, book, out, start);
+        std::fprintf(stderr, "replayed %llu messages (%llu resyncs)\n",
+                     static_cast<unsigned long long>(replay.messageCount()),
+                     static_cast<unsigned long long>(replay.resyncCount()));
+        if (quoter) printRestingSummary(quoter->stats());
+        if (path) printScheduleSummary(options, *path);
+    } else {
+        bool ok = withExchange(options.exchange, [&](auto venue) {
+            return runLive<decltype(venue)>(options, out, start, simulated);
+        });
+        if (!ok) return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::fflush(out);
+    if (out != stdout) std::fclose(out);
+    Logger::instance().flush();
+    std::fprintf(stderr, "%llu books simulated in %.2f s (%.0f/s)\n",
+                 static_cast<unsigned long long>(simulated), seconds, seconds > 0 ? simulated / seconds : 0.0);
+    printLatencySummary();
+    if (options.validateSlippage) printSlippageValidation();
+    return 0;
+}
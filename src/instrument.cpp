@@ -0,0 +1,99 @@
+#include "instrument.h"
+#include "bookKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int kMaxDigits = 18;  // keeps the mantissa inside int64
+
+const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12};
+const int64_t kIntPow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+                             1000000000, 10000000000, 100000000000, 1000000000000};
+
+} // namespace
+
+InstrumentSpec::Grid::Grid(double stepSize) : size(stepSize), decimals(0), stepUnits(1), scale(1.0) {
+    // Smallest number of decimals that represents the step as an integer
+    for (int d = 0; d <= kMaxDecimals; ++d) {
+        double scaled = stepSize * kPow10[d];
+        double rounded = std::round(scaled);
+        if (rounded >= 1.0 && std::fabs(scaled - rounded) < 1e-6) {
+            decimals = d;
+            stepUnits = static_cast<int64_t>(rounded);
+            scale = kPow10[d];
+            return;
+        }
+    }
+    decimals = kMaxDecimals;
+    stepUnits = 1;
+    scale = kPow10[kMaxDecimals];
+}
+
+bool InstrumentSpec::Grid::parse(std::string_view text, int64_t& out) const {
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) negative = text[i++] == '-';
+
+    int64_t mantissa = 0;
+    int digits = 0;
+    bool sawDigit = false;
+    int fraction = -1;  // digits seen after the point, -1 before it
+    int trailingZeros = 0;
+    for (; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '.' && fraction < 0) {
+            fraction = 0;
+            continue;
+        }
+        if (c < '0' || c > '9') return false;
+        sawDigit = true;
+        if (fraction >= 0) {
+            ++fraction;
+            trailingZeros = c == '0' ? trailingZeros + 1 : 0;
+        }
+        if (mantissa == 0 && c == '0' && fraction < 0) continue;  // leading zeros
+        if (++digits > kMaxDigits) return false;
+        mantissa = mantissa * 10 + (c - '0');
+    }
+    if (!sawDigit) return false;
+
+    // Drop zeros past the grid's precision ("0.10000000" at 8 decimals is fine)
+    if (fraction < 0) fraction = 0;
+    while (fraction > decimals && trailingZeros > 0) {
+        mantissa /= 10;
+        --fraction;
+        --trailingZeros;
+    }
+    if (fraction > decimals) return false;
+
+    // mantissa / 10^fraction expressed in units of 10^-decimals, then in steps
+    int64_t scale = kIntPow10[decimals - fraction];
+    if (mantissa > INT64_MAX / scale) return false;
+    int64_t units = mantissa * scale;
+    if (units % stepUnits != 0) return false;
+    out = (negative ? -units : units) / stepUnits;
+    return true;
+}
+
+void InstrumentSpec::Grid::toDoubles(const int64_t* units, size_t n, double* out) const {
+    bookKernels().unitsToDoubles(units, n, stepUnits, scale, out);
+}
+
+InstrumentSpec::InstrumentSpec(double tickSize, double lotSize) : tick(tickSize), lot(lotSize) {}
+
+InstrumentSpec InstrumentSpec::fromDecimals(int priceDecimals, int sizeDecimals) {
+    priceDecimals = std::clamp(priceDecimals, 0, kMaxDecimals);
+    sizeDecimals = std::clamp(sizeDecimals, 0, kMaxDecimals);
+    InstrumentSpec spec(1.0 / kPow10[priceDecimals], 1.0 / kPow10[sizeDecimals]);
+    spec.derived = true;
+    return spec;
+}
+
+int InstrumentSpec::decimalsOf(std::string_view text) {
+    size_t point = text.find('.');
+    if (point == std::string_view::npos) return 0;
+    size_t last = text.find_last_not_of('0');
+    int decimals = last > point ? static_cast<int>(last - point) : 0;
+    return decimals > kMaxDecimals ? kMaxDecimals + 1 : decimals;
+}
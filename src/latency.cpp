@@ -0,0 +1,136 @@
+#include "latency.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Index of the highest set bit; value must be non-zero
+int highestBit(uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+} // namespace
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    // Values below kSubBuckets get exact buckets. Above that, bucket group g
+    // covers [2^(g+4), 2^(g+5)) in kSubBuckets equal steps.
+    if (value < kSubBuckets) return static_cast<size_t>(value);
+    int shift = highestBit(value) - kSubBucketBits;
+    size_t group = static_cast<size_t>(shift + 1);
+    size_t sub = static_cast<size_t>(value >> shift) - kSubBuckets;
+    return group * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::highestInBucket(size_t bucket) {
+    if (bucket < kSubBuckets) return bucket;
+    size_t group = bucket / kSubBuckets;
+    uint64_t top = bucket % kSubBuckets + kSubBuckets;
+    int shift = static_cast<int>(group) - 1;
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t ns) {
+    uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t seen = maxValue.load(std::memory_order_relaxed);
+    while (value > seen && !maxValue.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    // Sum the buckets rather than trusting total, which may be a few records
+    // ahead of them while writers are active
+    uint64_t n = 0;
+    for (const auto& bucket : buckets) n += bucket.load(std::memory_order_relaxed);
+    if (n == 0) return 0;
+
+    double wanted = q * static_cast<double>(n);
+    uint64_t rank = wanted <= 1.0 ? 1 : static_cast<uint64_t>(wanted + 0.999999);
+    if (rank > n) rank = n;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t value = highestInBucket(i);
+            uint64_t top = max();
+            return value < top ? value : top;
+        }
+    }
+    return max();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maxValue.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; ++i)
+        buckets[i].fetch_add(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    total.fetch_add(other.count(), std::memory_order_relaxed);
+    sum.fetch_add(other.sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    uint64_t value = other.max();
+    uint64_t seen = maxValue.load(std::memory_order_relaxed);
+    while (value > seen && !maxValue.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+    case LatencyStage::Parse: return "parse";
+    case LatencyStage::Apply: return "apply";
+    case LatencyStage::Publish: return "publish";
+    case LatencyStage::FeedTotal: return "feed total";
+    case LatencyStage::Simulate: return "simulate";
+    case LatencyStage::PublishToResult: return "publish to result";
+    default: return "?";
+    }
+}
+
+void LatencyStats::record(const LatencyTrace& trace) {
+    if (!trace.receiveNs) return;
+    if (trace.parsedNs) record(LatencyStage::Parse, trace.parsedNs - trace.receiveNs);
+    if (trace.parsedNs && trace.appliedNs) record(LatencyStage::Apply, trace.appliedNs - trace.parsedNs);
+    if (trace.appliedNs && trace.publishedNs) record(LatencyStage::Publish, trace.publishedNs - trace.appliedNs);
+    if (trace.publishedNs) record(LatencyStage::FeedTotal, trace.publishedNs - trace.receiveNs);
+}
+
+LatencySummary LatencyStats::summary(LatencyStage stage) const {
+    const LatencyHistogram& h = histogram(stage);
+    LatencySummary s;
+    s.count = h.count();
+    s.p50Ns = h.percentile(0.50);
+    s.p99Ns = h.percentile(0.99);
+    s.p999Ns = h.percentile(0.999);
+    s.maxNs = h.max();
+    s.meanNs = h.mean();
+    return s;
+}
+
+void LatencyStats::reset() {
+    for (auto& h : histograms) h.reset();
+}
+
+void LatencyStats::merge(const LatencyStats& other) {
+    for (size_t i = 0; i < static_cast<size_t>(LatencyStage::Count); ++i) histograms[i].merge(other.histograms[i]);
+}
+
+LatencyStats& latencyStats() {
+    static LatencyStats stats;
+    return stats;
+}
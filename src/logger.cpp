@@ -1,9 +1,296 @@
 #include "logger.h"
-#include <iostream>
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Single-producer/single-consumer record ring. The owning thread is the only
+// producer, the writer thread the only consumer.
+struct Logger::Ring {
+    static constexpr size_t kCapacity = 2048;  // power of two
+
+    alignas(64) std::atomic<uint64_t> head{0};  // next record to write out (writer)
+    alignas(64) std::atomic<uint64_t> tail{0};  // next free record (producer)
+    uint64_t cachedHead = 0;                    // producer's last view of head
+    std::atomic<bool> closed{false};            // owner thread has exited
+    LogRecord records[kCapacity];
+};
+
+namespace {
+
+// Marks the thread's ring closed on thread exit so the writer can free it
+// once drained
+struct ThreadRing {
+    Logger::Ring* ring = nullptr;
+    ~ThreadRing() {
+        if (ring) ring->closed.store(true, std::memory_order_release);
+        ring = nullptr;
+    }
+};
+
+thread_local ThreadRing threadRing;
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO ";
+    case LogLevel::Warn: return "WARN ";
+    case LogLevel::Error: return "ERROR";
+    default: return "?    ";
+    }
+}
+
+void appendTimestamp(std::string& line, int64_t timestampNs) {
+    std::time_t seconds = static_cast<std::time_t>(timestampNs / 1000000000);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char buffer[48];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    n += std::snprintf(buffer + n, sizeof(buffer) - n, ".%09lld",
+                       static_cast<long long>(timestampNs % 1000000000));
+    line.append(buffer, n);
+}
+
+void appendArg(std::string& line, const LogRecord& record, const LogArg& arg) {
+    char buffer[32];
+    int n = 0;
+    switch (arg.type) {
+    case LogArg::Type::Int:
+        n = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(arg.i));
+        break;
+    case LogArg::Type::UInt:
+        n = std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(arg.u));
+        break;
+    case LogArg::Type::Double:
+        n = std::snprintf(buffer, sizeof(buffer), "%.15g", arg.d);
+        break;
+    case LogArg::Type::Bool:
+        line += arg.b ? "true" : "false";
+        return;
+    case LogArg::Type::Text:
+        line.append(record.text + arg.text.offset, arg.text.length);
+        return;
+    }
+    line.append(buffer, static_cast<size_t>(n));
+}
+
+// "timestamp LEVEL [tag] message\n", with each {} replaced by the next argument
+void formatRecord(std::string& line, const LogRecord& record) {
+    appendTimestamp(line, record.timestampNs);
+    line += ' ';
+    line += levelName(record.level);
+    line += " [";
+    line += record.tag;
+    line += "] ";
+    size_t next = 0;
+    for (const char* p = record.format; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}' && next < record.argCount) {
+            appendArg(line, record, record.args[next++]);
+            ++p;
+        } else {
+            line += *p;
+        }
+    }
+    line += '\n';
+}
+
+} // namespace
+
+// Owns the rings and the background thread that formats and writes them out
+class Logger::Writer {
+public:
+    explicit Writer(Logger& owner) : owner(owner), thread(&Writer::run, this) {}
+
+    ~Writer() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        thread.join();
+        for (Ring* ring : rings) delete ring;
+        if (ownsFile) std::fclose(out);
+    }
+
+    Ring* registerRing() {
+        Ring* ring = new Ring();
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(ring);
+        return ring;
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        uint64_t ticket = ++flushRequested;
+        wake.notify_one();
+        flushed.wait(lock, [&] { return flushCompleted >= ticket; });
+    }
+
+    bool openFile(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "a");
+        if (!file) return false;
+        std::lock_guard<std::mutex> lock(outMutex);
+        if (ownsFile) std::fclose(out);
+        out = file;
+        ownsFile = true;
+        return true;
+    }
+
+private:
+    void run() {
+        std::string line;
+        for (;;) {
+            uint64_t ticket;
+            bool stop;
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                ticket = flushRequested;
+                stop = stopping;
+            }
+            size_t written = drain(line);
+            if (ticket > flushCompleted) {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                flushCompleted = ticket;
+                flushed.notify_all();
+            }
+            if (written) continue;
+            if (stop) break;
+            // Producers never signal (that would put a syscall on their path),
+            // so an idle writer polls
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(1),
+                          [&] { return stopping || flushRequested != ticket; });
+        }
+    }
+
+    // Writes out everything queued so far; returns the number of records.
+    // The ring list is copied under ringsMutex and formatted outside it, so a
+    // thread logging for the first time never waits on formatting or file I/O
+    size_t drain(std::string& line) {
+        size_t written = 0;
+        line.clear();
+        {
+            std::lock_guard<std::mutex> ringsLock(ringsMutex);
+            draining.assign(rings.begin(), rings.end());
+        }
+        retired.clear();
+        for (Ring* ring : draining) {
+            // Read closed before tail: every record of a closed ring is then visible
+            bool closed = ring->closed.load(std::memory_order_acquire);
+            uint64_t head = ring->head.load(std::memory_order_relaxed);
+            uint64_t tail = ring->tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                formatRecord(line, ring->records[head & (Ring::kCapacity - 1)]);
+                ++written;
+                // Keep producers moving during long bursts
+                if ((written & 63) == 0) ring->head.store(head + 1, std::memory_order_release);
+            }
+            ring->head.store(head, std::memory_order_release);
+            if (closed) retired.push_back(ring);
+        }
+        if (!retired.empty()) {
+            std::lock_guard<std::mutex> ringsLock(ringsMutex);
+            for (Ring* ring : retired) {
+                rings.erase(std::find(rings.begin(), rings.end(), ring));
+                delete ring;
+            }
+        }
+
+        uint64_t dropped = owner.dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            LogRecord note{};
+            note.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            note.level = LogLevel::Warn;
+            note.tag = "Logger";
+            note.format = "dropped {} records (ring full)";
+            note.push(dropped - reportedDrops);
+            formatRecord(line, note);
+            reportedDrops = dropped;
+        }
+
+        if (!line.empty()) {
+            std::lock_guard<std::mutex> lock(outMutex);
+            std::fwrite(line.data(), 1, line.size(), out);
+            std::fflush(out);
+        }
+        return written;
+    }
+
+    Logger& owner;
+
+    std::mutex ringsMutex;  // taken by producers only when registering a thread
+    std::vector<Ring*> rings;
+    std::vector<Ring*> draining;  // writer thread only: this pass's copy of rings
+    std::vector<Ring*> retired;   // writer thread only: closed rings found this pass
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    uint64_t flushRequested = 0;
+    uint64_t flushCompleted = 0;
+    bool stopping = false;
+
+    std::mutex outMutex;
+    FILE* out = stderr;
+    bool ownsFile = false;
+    uint64_t reportedDrops = 0;
+
+    std::thread thread;  // last, so it starts after everything above is initialized
+};
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : writer(new Writer(*this)) {}
+
+Logger::~Logger() {
+    delete writer;
+}
+
+bool Logger::openFile(const std::string& path) {
+    return writer->openFile(path);
+}
+
+void Logger::flush() {
+    writer->flush();
+}
+
+LogRecord* Logger::claim() {
+    Ring* ring = threadRing.ring;
+    if (!ring) ring = threadRing.ring = writer->registerRing();
+
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    while (tail - ring->cachedHead >= Ring::kCapacity) {
+        ring->cachedHead = ring->head.load(std::memory_order_acquire);
+        if (tail - ring->cachedHead < Ring::kCapacity) break;
+        if (overflow.load(std::memory_order_relaxed) == LogOverflowPolicy::Drop) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        std::this_thread::yield();
+    }
+
+    LogRecord* record = &ring->records[tail & (Ring::kCapacity - 1)];
+    record->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return record;
+}
+
+void Logger::commit() {
+    Ring* ring = threadRing.ring;
+    ring->tail.store(ring->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
 
 void log(const std::string& msg) {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::cout << "[" << std::ctime(&now_c) << "] " << msg << "\n";
+    LOG_INFO("app", "{}", msg);
 }
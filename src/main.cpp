@@ -6,16 +6,31 @@
 #include <SDL_opengl.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
 #include <tradeSim.h>
 #include <datafeed.h>
+#include <bookFeatures.h>
+#include <costCurve.h>
+#include <latency.h>
+#include <models/impact.h>
+#include <models/makerTaker.h>
+#include <models/slippage.h>
+#include <monteCarlo.h>
+#include <orderbook.h>
+#include <replaySource.h>
+#include <webSocketClient.h>
+#include <memory>
+#include <cstring>
 
 // Input parameter variables
 std::string exchange = "OKX";
 std::string spotAsset = "BTC-USDT";
 std::string orderType = "Market";
 float quantity = 100.0f;
-float volatility = 0.05f;
+float volatility = 0.6f;  // annualized, drives the Monte Carlo cost engine
+bool useRealizedVolatility = false;  // take it from the feed instead (FeatureEngine)
 int feeTier = 1;
+float executionHorizon = 60.0f;  // seconds, for the Almgren-Chriss schedule
 
 // Output parameters (dummy for now)
 float expectedSlippage = 0.0f;
@@ -24,6 +39,12 @@ float expectedMarketImpact = 0.0f;
 float netCost = 0.0f;
 float makerTakerRatio = 0.0f;
 float internalLatency = 0.0f;
+float netCostVar = 0.0f;   // at the Monte Carlo confidence level
+float netCostCvar = 0.0f;
+float slippageLowBps = 0.0f;  // learned band for the input size
+float slippageMedianBps = 0.0f;
+float slippageHighBps = 0.0f;
+float monteCarloMs = 0.0f;
 
 // Flags for actions
 bool startTrade = false;
@@ -59,8 +80,31 @@ void simulateTrade(
 
 // Main function
 // This is where the program starts executing
-int main(int, char**)
+int main(int argc, char** argv)
 {
+    // Book source: "--live" streams OKX, "--replay FILE" plays back a session
+    // log at its original pace; with neither the dummy levels are used
+    MakerTakerModel makerTaker;  // trained on the feed thread; declared first so they outlive the book
+    SlippageModel slippageModel;
+    FeatureEngine features;
+    Orderbook orderbook;
+    std::unique_ptr<FeedSource> feed;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--live") == 0)
+            feed.reset(new WebSocketClient("wss://ws.okx.com:8443/ws/v5/public", orderbook));
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            feed.reset(new ReplaySource(argv[++i], orderbook, ReplayPacing::Original));
+    }
+    if (feed)
+    {
+        attachOrderbook(&orderbook);
+        orderbook.addObserver(&makerTaker);
+        orderbook.addObserver(&slippageModel);
+        orderbook.addObserver(&features);
+        feed->start();
+    }
+
     // Setup SDL
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_GAMECONTROLLER) != 0)
     {
@@ -118,13 +162,42 @@ int main(int, char**)
 
         if (startTrade)
         {
-            // Simulated logic (you'll later replace this with real computation)
-            expectedSlippage = quantity * volatility * 0.001f;
-            expectedFees = quantity * 0.001f * feeTier;
-            expectedMarketImpact = quantity * volatility * 0.0005f;
-            makerTakerRatio = (orderType == "Limit") ? 0.7f : 0.3f;
-            internalLatency = 500.0f + (float)(rand() % 100);
-            netCost = expectedSlippage + expectedFees + expectedMarketImpact;
+            // The volatility input, or the feed's realized estimate once it has one
+            TradeConfig tradeConfig;
+            tradeConfig.volatility = volatility;
+            tradeConfig.realizedVolatility = useRealizedVolatility;
+            double tradeVolatility = effectiveVolatility(tradeConfig, features.latest());
+            // Cost distribution of a market buy under that volatility
+            static MonteCarloEngine monteCarlo;
+            MonteCarloConfig monteCarloConfig;
+            monteCarloConfig.volatility = tradeVolatility;
+            SnapshotHandle snapshot = getCurrentOrderBookSnapshot();
+            double bestAsk = snapshot->asks.empty() ? 0.0 : snapshot->asks.front().price;
+            double baseQuantity = bestAsk > 0.0 ? quantity / bestAsk : 0.0;  // the input is in USD
+            MonteCarloResult costs = monteCarlo.run(*snapshot, Side::Buy, baseQuantity, Okx::feeTier(feeTier),
+                                                    monteCarloConfig);
+            expectedSlippage = (float)costs.slippage.mean;
+            expectedFees = (float)costs.fees.mean;
+            netCostVar = (float)costs.totalCost.var;
+            netCostCvar = (float)costs.totalCost.cvar;
+            monteCarloMs = (float)(costs.elapsedUs / 1000.0);
+            // Impact of working the same size over the horizon on the optimal schedule
+            static MarketImpactModel impactModel;
+            ImpactCalibration calibration;
+            calibration.annualVolatility = tradeVolatility;
+            ImpactEstimate impact =
+                impactModel.estimate(calibrateImpact(*snapshot, calibration), baseQuantity, executionHorizon);
+            expectedMarketImpact = (float)(impact.temporaryCost + impact.permanentCost);
+            // Share expected to fill passively if the order works at the touch
+            makerTakerRatio = (float)makerTaker.predict(Side::Buy);
+            // Slippage quantiles learned from the stream, for the same size
+            SlippageBand band = slippageModel.quantiles(*snapshot, quantity, Side::Buy);
+            slippageLowBps = (float)band.low;
+            slippageMedianBps = (float)band.median;
+            slippageHighBps = (float)band.high;
+            // Median measured snapshot-to-result latency
+            internalLatency = latencyStats().summary(LatencyStage::PublishToResult).p50Ns / 1000.0f;
+            netCost = (float)costs.totalCost.mean;
 
             hasOutput = true;
             startTrade = false;  // reset button flag
@@ -151,27 +224,36 @@ int main(int, char**)
 
         ImGui::InputFloat("Quantity (USD)", &quantity, 1.0f, 10.0f, "%.2f");
 
-        ImGui::InputFloat("Volatility", &volatility, 0.01f, 0.1f, "%.4f");
+        ImGui::InputFloat("Volatility (annual)", &volatility, 0.01f, 0.1f, "%.4f");
+        ImGui::Checkbox("Use realized volatility", &useRealizedVolatility);
 
         ImGui::InputInt("Fee Tier", &feeTier);
 
+        ImGui::InputFloat("Execution Horizon (s)", &executionHorizon, 1.0f, 60.0f, "%.0f");
+
 
         static TradeResult lastTradeResult{};
         static bool tradeStarted = false;
 
+        static const int kCostCurvePoints = 20;
+        static CostCurveCache costCurveCache;
+        static std::vector<double> costCurveQuantities;
+        static std::vector<float> buyCostCurve;
+        static std::vector<float> sellCostCurve;
+
         // Input fields (exchangeBuf, spotAssetBuf, orderTypeBuf, quantity, feeTier, etc.) as before
 
         if (ImGui::Button("Start Trade"))
         {
             // Build or get current order book snapshot (replace this with your real live orderbook data)
-            OrderBookSnapshot snapshot = getCurrentOrderBookSnapshot();
+            SnapshotHandle snapshot = getCurrentOrderBookSnapshot();
 
             // Map orderTypeBuf to Side enum (here assuming Market order and side Buy for example)
             Side side = Side::Buy;  // Or set based on user input
 
             // Call simulateMarketOrder
             lastTradeResult = simulateMarketOrder(
-                snapshot,
+                *snapshot,
                 side,
                 quantity,
                 feeTier,
@@ -181,6 +263,23 @@ int main(int, char**)
             tradeStarted = true;
         }
 
+        // Live cost curve from 10% to 200% of the requested size, both sides in
+        // one pass. Recomputed only when the book version or the sizes change,
+        // so frames between book updates are cache hits.
+        {
+            SnapshotHandle snapshot = getCurrentOrderBookSnapshot();
+            double bestAsk = snapshot->asks.empty() ? 0.0 : snapshot->asks.front().price;
+            double baseQuantity = bestAsk > 0.0 ? quantity / bestAsk : 0.0;  // the input is in USD
+            costCurveQuantities.resize(kCostCurvePoints);
+            for (int i = 0; i < kCostCurvePoints; ++i)
+                costCurveQuantities[i] = baseQuantity * 2.0 * (i + 1) / kCostCurvePoints;
+            const CostCurve& curve = costCurveCache.get(*snapshot, costCurveQuantities, CurveSides::Both, feeTier);
+            buyCostCurve.resize(curve.buy.size());
+            sellCostCurve.resize(curve.sell.size());
+            for (size_t i = 0; i < curve.buy.size(); ++i) buyCostCurve[i] = (float)curve.buy[i].netCost;
+            for (size_t i = 0; i < curve.sell.size(); ++i) sellCostCurve[i] = (float)curve.sell[i].netCost;
+        }
+
         // Output panel
         if (tradeStarted)
         {
@@ -195,6 +294,10 @@ int main(int, char**)
             ImGui::Text("Internal Latency (µs): %.0f", lastTradeResult.internalLatency);
         }
 
+        ImGui::Text("Net cost vs size (0.1x - 2x quantity)");
+        ImGui::PlotLines("Buy", buyCostCurve.data(), (int)buyCostCurve.size(), 0, NULL, FLT_MAX, FLT_MAX, ImVec2(0, 60));
+        ImGui::PlotLines("Sell", sellCostCurve.data(), (int)sellCostCurve.size(), 0, NULL, FLT_MAX, FLT_MAX, ImVec2(0, 60));
+
 
         // Add some spacing before the button
         ImGui::Spacing();
@@ -217,9 +320,13 @@ int main(int, char**)
         if (hasOutput)
         {
             ImGui::Text("Expected Slippage: %.6f", expectedSlippage);
+            ImGui::Text("Slippage p10 / p50 / p90 (bps): %.2f / %.2f / %.2f", slippageLowBps, slippageMedianBps,
+                        slippageHighBps);
             ImGui::Text("Expected Fees: %.6f", expectedFees);
             ImGui::Text("Expected Market Impact: %.6f", expectedMarketImpact);
             ImGui::Text("Net Cost: %.6f", netCost);
+            ImGui::Text("Net Cost VaR / CVaR (95%%): %.6f / %.6f", netCostVar, netCostCvar);
+            ImGui::Text("Monte Carlo time: %.2f ms", monteCarloMs);
             ImGui::Text("Maker/Taker Proportion: %.6f", makerTakerRatio);
             ImGui::Text("Internal Latency (µs): %.0f", internalLatency);
         }
@@ -228,6 +335,35 @@ int main(int, char**)
             ImGui::Text("Click 'Start Trade' to calculate.");
         }
 
+        // Live, straight from the feature engine; no book walk per frame
+        BookFeatures book = features.latest();
+        ImGui::Spacing();
+        ImGui::Text("Book features (version %llu)", (unsigned long long)book.version);
+        ImGui::Separator();
+        ImGui::Text("Mid / Microprice: %.2f / %.2f", book.mid, book.microprice);
+        ImGui::Text("Spread: %.2f (%.2f bps)", book.spread, book.spreadBps);
+        ImGui::Text("Order flow imbalance L1 / L%d: %.3f / %.3f", (int)BookFeatures::kFlowLevels,
+                    book.orderFlowImbalance[0], book.orderFlowImbalance[BookFeatures::kFlowLevels - 1]);
+        ImGui::Text("Depth within %.0f bps (bid / ask USD): %.0f / %.0f", features.configuration().depthBandsBps[1],
+                    book.bidDepthWithin[1], book.askDepthWithin[1]);
+        ImGui::Text("Realized volatility (annual): %.4f over %llu returns", book.volatility,
+                    (unsigned long long)book.returns);
+
+        ImGui::Spacing();
+        ImGui::Text("Latency by stage (µs)");
+        ImGui::Separator();
+        ImGui::Text("%-18s %8s %8s %8s %8s %8s", "stage", "p50", "p99", "p99.9", "max", "count");
+        for (int i = 0; i < (int)LatencyStage::Count; ++i)
+        {
+            LatencyStage stage = (LatencyStage)i;
+            LatencySummary s = latencyStats().summary(stage);
+            ImGui::Text("%-18s %8.1f %8.1f %8.1f %8.1f %8llu", latencyStageName(stage),
+                        s.p50Ns / 1000.0, s.p99Ns / 1000.0, s.p999Ns / 1000.0, s.maxNs / 1000.0,
+                        (unsigned long long)s.count);
+        }
+        if (ImGui::Button("Reset Latency"))
+            latencyStats().reset();
+
 
         ImGui::End();
 
@@ -242,6 +378,11 @@ int main(int, char**)
     }
 
     // Cleanup
+    if (feed)
+    {
+        feed->stop();
+        attachOrderbook(nullptr);
+    }
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -0,0 +1,308 @@
+#include "matchingEngine.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace {
+
+OrderId makeId(uint32_t index, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | index;
+}
+
+} // namespace
+
+bool parseOrderType(std::string_view text, OrderType& out) {
+    std::string lower(text);
+    for (char& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    if (lower == "market") out = OrderType::Market;
+    else if (lower == "limit") out = OrderType::Limit;
+    else if (lower == "post-only") out = OrderType::PostOnly;
+    else if (lower == "ioc") out = OrderType::ImmediateOrCancel;
+    else return false;
+    return true;
+}
+
+MatchingEngine::MatchingEngine(const MatchingConfig& matchingConfig) : config(matchingConfig) {
+    config.depth = std::max<size_t>(config.depth, 1);
+    config.frontShare = std::clamp(config.frontShare, 0.0, 1.0);
+    bids.reserve(config.depth);
+    asks.reserve(config.depth);
+    nodes.reserve(config.reserveOrders);
+    freeNodes.reserve(config.reserveOrders);
+}
+
+void MatchingEngine::onPublish(const OrderBookSnapshot& snapshot) {
+    // A reset book (Orderbook::invalidate) says nothing about the queues, and
+    // would read as every level emptied at the touch; wait for the resync
+    if (snapshot.bids.empty() || snapshot.asks.empty()) return;
+    size_t bidLevelsKept = std::min(config.depth, snapshot.bids.size());
+    size_t askLevelsKept = std::min(config.depth, snapshot.asks.size());
+    bids.prices.assign(snapshot.bids.prices.begin(), snapshot.bids.prices.begin() + bidLevelsKept);
+    bids.quantities.assign(snapshot.bids.quantities.begin(), snapshot.bids.quantities.begin() + bidLevelsKept);
+    asks.prices.assign(snapshot.asks.prices.begin(), snapshot.asks.prices.begin() + askLevelsKept);
+    asks.quantities.assign(snapshot.asks.quantities.begin(), snapshot.asks.quantities.begin() + askLevelsKept);
+    bookNs = std::chrono::duration_cast<std::chrono::nanoseconds>(snapshot.timestamp.time_since_epoch()).count();
+
+    const bool hasBid = !bids.empty();
+    const bool hasAsk = !asks.empty();
+    const int64_t bestBid = hasBid ? config.spec.toTicks(bids.prices[0]) : 0;
+    const int64_t bestAsk = hasAsk ? config.spec.toTicks(asks.prices[0]) : 0;
+
+    // Backwards, so a level released by swapping in the last one is not skipped
+    for (size_t i = active.size(); i-- > 0;) {
+        uint32_t index = active[i];
+        Level& level = levels[index];
+        bool buy = level.side == Side::Buy;
+        bool crossed = buy ? hasAsk && bestAsk <= level.ticks : hasBid && bestBid >= level.ticks;
+        if (crossed) {
+            if (!level.armed) continue;
+            // Traded through: what is left fills at the orders' price
+            while (level.head != kNone) fillResting(level.head, nodes[level.head].lots);
+            continue;
+        }
+        level.armed = true;
+        int64_t lots = visibleLots(level.side, level.ticks);
+        if (lots < 0) continue;  // out of view, so no news
+        bool atTouch = buy ? !hasBid || level.ticks >= bestBid : !hasAsk || level.ticks <= bestAsk;
+        updateLevel(index, lots, atTouch);
+    }
+}
+
+OrderId MatchingEngine::submit(const SimOrder& order) {
+    ++totals.submitted;
+    int64_t lots = config.spec.toLots(order.quantity);
+    if (lots <= 0) {
+        ++totals.rejected;
+        return 0;
+    }
+    bool buy = order.side == Side::Buy;
+
+    if (order.type == OrderType::Market) {
+        int64_t left = sweep(order.side, 0, false, lots, order.tag);
+        if (left > 0) ++totals.canceled;
+        else ++totals.completed;
+        return 0;
+    }
+
+    int64_t ticks = config.spec.toTicks(order.price);
+    const OrderBookSide& opposite = buy ? asks : bids;
+    bool crosses = false;
+    if (!opposite.empty()) {
+        int64_t best = config.spec.toTicks(opposite.prices[0]);
+        crosses = buy ? best <= ticks : best >= ticks;
+    }
+    if (crosses && order.type == OrderType::PostOnly) {
+        ++totals.rejected;
+        return 0;
+    }
+    int64_t left = crosses ? sweep(order.side, ticks, true, lots, order.tag) : lots;
+    if (left == 0) {
+        ++totals.completed;
+        return 0;
+    }
+    if (order.type == OrderType::ImmediateOrCancel) {
+        ++totals.canceled;
+        return 0;
+    }
+
+    // Rest the remainder at the back of the queue
+    uint32_t index = levelFor(order.side, ticks);
+    uint32_t o;
+    if (freeNodes.empty()) {
+        o = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+    } else {
+        o = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    Level& level = levels[index];
+    // The book still shows the liquidity this order just took; wait for it to go
+    if (crosses) level.armed = false;
+    OrderNode& n = nodes[o];
+    n.level = index;
+    n.mark = level.consumed + static_cast<double>(level.visibleLots);
+    n.lots = left;
+    n.submitNs = bookNs;
+    n.tag = order.tag;
+    n.next = kNone;
+    n.prev = level.tail;
+    if (level.tail != kNone) nodes[level.tail].next = o;
+    else level.head = o;
+    level.tail = o;
+    ++resting;
+    return makeId(o, n.generation);
+}
+
+bool MatchingEngine::cancel(OrderId id) {
+    if (!node(id)) return false;
+    unlink(static_cast<uint32_t>(id));
+    ++totals.canceled;
+    return true;
+}
+
+double MatchingEngine::remaining(OrderId id) const {
+    const OrderNode* n = node(id);
+    return n ? config.spec.fromLots(n->lots) : 0.0;
+}
+
+double MatchingEngine::queueAhead(OrderId id) const {
+    const OrderNode* n = node(id);
+    if (!n) return 0.0;
+    double ahead = std::max(0.0, n->mark - levels[n->level].consumed);
+    return ahead * config.spec.lotSize();
+}
+
+void MatchingEngine::drainFills(std::vector<SimFill>& out) {
+    out.clear();
+    out.swap(fills);
+}
+
+const MatchingEngine::OrderNode* MatchingEngine::node(OrderId id) const {
+    uint32_t index = static_cast<uint32_t>(id);
+    if (index >= nodes.size()) return nullptr;
+    const OrderNode& n = nodes[index];
+    return n.level != kNone && n.generation == static_cast<uint32_t>(id >> 32) ? &n : nullptr;
+}
+
+int64_t MatchingEngine::visibleLots(Side side, int64_t ticks) const {
+    const OrderBookSide& book = side == Side::Buy ? bids : asks;
+    if (book.empty()) return 0;
+    // Bids run high to low, asks low to high
+    double price = config.spec.fromTicks(ticks);
+    auto begin = book.prices.begin(), end = book.prices.end();
+    auto it = side == Side::Buy ? std::lower_bound(begin, end, price, std::greater<double>())
+                                : std::lower_bound(begin, end, price);
+    if (it != end && config.spec.toTicks(*it) == ticks)
+        return config.spec.toLots(book.quantities[it - begin]);
+    // Absent inside the kept range means empty; past it, unknown
+    return it == end && book.size() == config.depth ? -1 : 0;
+}
+
+int64_t MatchingEngine::sweep(Side side, int64_t limitTicks, bool limited, int64_t lots, uint64_t tag) {
+    const OrderBookSide& book = side == Side::Buy ? asks : bids;
+    int64_t left = lots;
+    double notional = 0.0;
+    for (size_t i = 0; i < book.size() && left > 0; ++i) {
+        if (limited) {
+            int64_t ticks = config.spec.toTicks(book.prices[i]);
+            if (side == Side::Buy ? ticks > limitTicks : ticks < limitTicks) break;
+        }
+        int64_t take = std::min(left, config.spec.toLots(book.quantities[i]));
+        left -= take;
+        notional += book.prices[i] * config.spec.fromLots(take);
+    }
+    if (left < lots) {
+        double quantity = config.spec.fromLots(lots - left);
+        record(0, tag, side, false, left == 0, notional / quantity, quantity, 0);
+    }
+    return left;
+}
+
+uint32_t MatchingEngine::levelFor(Side side, int64_t ticks) {
+    auto& byTick = side == Side::Buy ? bidLevels : askLevels;
+    auto found = byTick.find(ticks);
+    if (found != byTick.end()) return found->second;
+
+    uint32_t index;
+    if (freeLevels.empty()) {
+        index = static_cast<uint32_t>(levels.size());
+        levels.emplace_back();
+    } else {
+        index = freeLevels.back();
+        freeLevels.pop_back();
+    }
+    Level& level = levels[index];
+    level = Level{};
+    level.ticks = ticks;
+    level.side = side;
+    level.visibleLots = std::max<int64_t>(0, visibleLots(side, ticks));
+    level.activeSlot = static_cast<uint32_t>(active.size());
+    active.push_back(index);
+    byTick.emplace(ticks, index);
+    return index;
+}
+
+void MatchingEngine::updateLevel(uint32_t index, int64_t lots, bool atTouch) {
+    Level& level = levels[index];
+    if (lots < level.visibleLots) {
+        level.consumed += config.frontShare * static_cast<double>(level.visibleLots - lots);
+        // Nothing trades away from the touch, so cancels cannot pass the first order
+        if (!atTouch) level.consumed = std::min(level.consumed, nodes[level.head].mark);
+    }
+    level.visibleLots = lots;
+
+    // Nobody has more ahead of it than the whole level. Marks rise from head
+    // to tail, so only a run at the tail can need this.
+    double cap = level.consumed + static_cast<double>(lots);
+    for (uint32_t o = level.tail; o != kNone && nodes[o].mark > cap; o = nodes[o].prev) nodes[o].mark = cap;
+
+    if (!atTouch) return;
+    // Consumption past an order's mark traded against it
+    for (uint32_t o = level.head; o != kNone;) {
+        OrderNode& n = nodes[o];
+        int64_t traded = std::min(n.lots, static_cast<int64_t>(level.consumed - n.mark));
+        if (traded <= 0) break;
+        uint32_t next = n.next;
+        n.mark += static_cast<double>(traded);
+        fillResting(o, traded);
+        o = next;
+    }
+}
+
+void MatchingEngine::fillResting(uint32_t o, int64_t lots) {
+    OrderNode& n = nodes[o];
+    const Level& level = levels[n.level];
+    n.lots -= lots;
+    bool complete = n.lots == 0;
+    int64_t sinceSubmitNs = bookNs - n.submitNs;
+    record(makeId(o, n.generation), n.tag, level.side, true, complete, config.spec.fromTicks(level.ticks),
+           config.spec.fromLots(lots), sinceSubmitNs);
+    if (!complete) return;
+    ++totals.completed;
+    ++totals.restedFills;
+    totals.totalTimeToFillNs += static_cast<double>(sinceSubmitNs);
+    totals.maxTimeToFillNs = std::max(totals.maxTimeToFillNs, sinceSubmitNs);
+    unlink(o);
+}
+
+void MatchingEngine::unlink(uint32_t o) {
+    OrderNode& n = nodes[o];
+    Level& level = levels[n.level];
+    if (n.prev != kNone) nodes[n.prev].next = n.next;
+    else level.head = n.next;
+    if (n.next != kNone) nodes[n.next].prev = n.prev;
+    else level.tail = n.prev;
+    uint32_t index = n.level;
+    n.level = kNone;
+    ++n.generation;  // stale ids stop matching
+    freeNodes.push_back(o);
+    --resting;
+    if (level.head == kNone) releaseLevel(index);
+}
+
+void MatchingEngine::releaseLevel(uint32_t index) {
+    Level& level = levels[index];
+    (level.side == Side::Buy ? bidLevels : askLevels).erase(level.ticks);
+    uint32_t slot = level.activeSlot;
+    active[slot] = active.back();
+    levels[active[slot]].activeSlot = slot;
+    active.pop_back();
+    freeLevels.push_back(index);
+}
+
+void MatchingEngine::record(OrderId id, uint64_t tag, Side side, bool maker, bool complete, double price,
+                            double quantity, int64_t sinceSubmitNs) {
+    double notional = price * quantity;
+    double fee = notional * (maker ? config.fees.maker : config.fees.taker);
+    fills.push_back({id, tag, side, maker, complete, price, quantity, fee, bookNs, sinceSubmitNs});
+    if (maker) {
+        totals.makerQuantity += quantity;
+        totals.makerNotional += notional;
+    } else {
+        totals.takerQuantity += quantity;
+        totals.takerNotional += notional;
+    }
+    totals.fees += fee;
+}
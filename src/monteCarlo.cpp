@@ -0,0 +1,105 @@
+#include "monteCarlo.h"
+#include "config.h"
+#include "philox.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+constexpr size_t kPathsPerTask = 4096;
+
+// Mean and spread in path order; VaR/CVaR by partial selection, which
+// reorders values (callers are done with path order by then)
+CostDistribution summarize(std::vector<double>& values, double confidence) {
+    CostDistribution d;
+    size_t n = values.size();
+    if (n == 0) return d;
+
+    double sum = 0.0;
+    d.min = d.max = values[0];
+    for (double v : values) {
+        sum += v;
+        d.min = std::min(d.min, v);
+        d.max = std::max(d.max, v);
+    }
+    d.mean = sum / n;
+    double squares = 0.0;
+    for (double v : values) squares += (v - d.mean) * (v - d.mean);
+    d.stdDev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+
+    size_t k = std::min(n - 1, static_cast<size_t>(confidence * n));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    d.var = values[k];
+    double tail = 0.0;
+    for (size_t i = k; i < n; ++i) tail += values[i];
+    d.cvar = tail / (n - k);
+    return d;
+}
+
+} // namespace
+
+MonteCarloEngine::MonteCarloEngine(size_t threads) : pool(threads) {}
+
+MonteCarloResult MonteCarloEngine::run(const OrderBookSnapshot& book, Side side, double quantity,
+                                       const FeeTier& feeRates, const MonteCarloConfig& config) {
+    auto start = std::chrono::steady_clock::now();
+    MonteCarloResult result;
+    result.version = book.version;
+
+    bool isBuy = side == Side::Buy;
+    const OrderBookSide& levels = isBuy ? book.asks : book.bids;
+    const DepthIndex* depth = isBuy ? &book.askDepth : &book.bidDepth;
+    if (book.bids.empty() || book.asks.empty() || quantity <= 0.0 || config.paths == 0) return result;
+    if (depth->cumQuantity.size() != levels.size()) {
+        buildDepthIndex(levels, scratchDepth);
+        depth = &scratchDepth;
+    }
+
+    const double mid = (book.bids.front().price + book.asks.front().price) / 2.0;
+    const double priceSigma = config.volatility * std::sqrt(config.horizonSeconds / kSecondsPerYear);
+    const double depthSigma = config.depthVolatility;
+    const double totalDepth = depth->totalQuantity();
+    const size_t paths = config.paths;
+    const Philox4x32 rng(config.seed);
+    result.midPrice = mid;
+    result.paths = paths;
+
+    slippage.resize(paths);
+    fees.resize(paths);
+    total.resize(paths);
+    unfilled.resize(paths);
+
+    size_t tasks = (paths + kPathsPerTask - 1) / kPathsPerTask;
+    pool.parallelFor(tasks, [&](size_t task) {
+        size_t end = std::min(paths, (task + 1) * kPathsPerTask);
+        for (size_t p = task * kPathsPerTask; p < end; ++p) {
+            double z0, z1;
+            rng.normals(0, p, z0, z1);
+            double priceScale = std::exp(priceSigma * z0 - 0.5 * priceSigma * priceSigma);
+            double depthScale = std::exp(depthSigma * z1 - 0.5 * depthSigma * depthSigma);
+
+            // Fill on the scaled book = fill q / L on the snapshot, scaled back
+            double target = quantity / depthScale;
+            FillEstimate fill = fillFromDepth(levels, *depth, target);
+            double executedQty = fill.quantity * depthScale;
+            double notional = fill.notional * depthScale * priceScale;
+
+            double slip = isBuy ? notional - mid * executedQty : mid * executedQty - notional;
+            double fee = notional * feeRates.taker;
+            slippage[p] = slip;
+            fees[p] = fee;
+            total[p] = slip + fee;
+            unfilled[p] = target > totalDepth;
+        }
+    });
+
+    for (uint8_t u : unfilled) result.unfilledPaths += u;
+    std::vector<double>* series[] = {&slippage, &fees, &total};
+    CostDistribution* summaries[] = {&result.slippage, &result.fees, &result.totalCost};
+    pool.parallelFor(3, [&](size_t i) { *summaries[i] = summarize(*series[i], config.confidence); });
+
+    result.elapsedUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,62 @@
+#include "okxParser.h"
+#include "jsonScanner.h"
+
+namespace {
+
+bool parseBook(JsonScanner& s, BookMessage& out) {
+    return s.forEachMember([&](std::string_view key) {
+        if (key == "bids") return readLevels(s, out.bids);
+        if (key == "asks") return readLevels(s, out.asks);
+        if (key == "ts") return s.readInt(out.timestampMs);
+        if (key == "seqId") return s.readInt(out.seqId);
+        if (key == "prevSeqId") return s.readInt(out.prevSeqId);
+        if (key == "checksum") {
+            int64_t value = 0;
+            if (!s.readInt(value)) return false;
+            out.checksum = static_cast<int32_t>(value);
+            out.hasChecksum = true;
+            return true;
+        }
+        return s.skipValue();
+    });
+}
+
+} // namespace
+
+BookParseStatus parseOkxBookMessage(std::string_view message, BookMessage& out) {
+    out.reset();
+    JsonScanner s(message);
+    bool hasData = false;
+    bool isEvent = false;
+
+    bool ok = s.forEachMember([&](std::string_view key) {
+        if (key == "arg") {
+            return s.forEachMember([&](std::string_view argKey) {
+                if (argKey == "channel") return s.readString(out.channel);
+                if (argKey == "instId") return s.readString(out.instId);
+                return s.skipValue();
+            });
+        }
+        if (key == "action") return s.readString(out.action);
+        if (key == "event") {
+            isEvent = true;
+            return s.skipValue();
+        }
+        if (key == "data") {
+            // OKX sends exactly one book per push; extra elements are skipped
+            bool first = true;
+            return s.forEachElement([&] {
+                if (!first) return s.skipValue();
+                first = false;
+                hasData = true;
+                return parseBook(s, out);
+            });
+        }
+        return s.skipValue();
+    });
+
+    if (!ok) return BookParseStatus::Malformed;
+    if (isEvent || !hasData) return BookParseStatus::NotBook;
+    if (out.channel.substr(0, 5) != "books" && out.channel != "bbo-tbt") return BookParseStatus::NotBook;
+    return BookParseStatus::Book;
+}
@@ -1,67 +1,216 @@
-#include "Orderbook.h"
-#include <nlohmann/json.hpp>
-#include <iostream>
+#include "orderbook.h"
+#include "logger.h"
+#include <algorithm>
 
-using json = nlohmann::json;
+Orderbook::Orderbook(size_t maxDepth, size_t publishDepth, const InstrumentSpec& spec)
+    : bids(LadderSide::Bid, maxDepth, spec), asks(LadderSide::Ask, maxDepth, spec), publishDepth(publishDepth),
+      deriveGrid(spec.isDerived()), priceDecimals(spec.priceDecimals()), sizeDecimals(spec.sizeDecimals()),
+      publisher(8, std::min(maxDepth, publishDepth)) {
+    observerBook.reserve(std::min(maxDepth, publishDepth));
+}
+
+namespace {
+
+// Applies decoded levels; a zero size deletes the level. The venue's text is
+// parsed straight into ticks/lots so level matching is exact; the doubles are
+// only used for levels built without text. False at the first level whose
+// text is off the grid, leaving the ladder partly updated.
+bool applyLadderLevels(PriceLadder& ladder, const std::vector<BookLevel>& levels) {
+    const InstrumentSpec& spec = ladder.instrument();
+    for (const auto& level : levels) {
+        int64_t ticks, lots;
+        if (level.priceText.empty()) ticks = spec.toTicks(level.price);
+        else if (!spec.parseTicks(level.priceText, ticks)) return false;
+        if (level.quantityText.empty()) lots = spec.toLots(level.quantity);
+        else if (!spec.parseLots(level.quantityText, lots)) return false;
+        ladder.set(ticks, lots, level.priceText, level.quantityText);
+    }
+    return true;
+}
+
+} // namespace
 
-void Orderbook::updateFromJson(const std::string& jsonString) {
-    std::lock_guard<std::mutex> lock(mtx);
+BookUpdateResult Orderbook::updateFromJson(const std::string& jsonString, LatencyTrace* trace) {
+    return update<Okx>(jsonString, trace);
+}
 
-    try {
-        auto j = json::parse(jsonString);
+template <class Venue>
+BookUpdateResult Orderbook::update(std::string_view payload, LatencyTrace* trace) {
+    // The per-thread message keeps its level capacity between calls
+    thread_local BookMessage message;
 
-        // This assumes OKX L2 message: { "arg": {...}, "data": [ { "bids": [...], "asks": [...] } ] }
-        if (!j.contains("data") || !j["data"].is_array() || j["data"].empty()) {
-            std::cerr << "[Orderbook] Malformed update JSON: no data array\n";
-            return;
+    BookParseStatus status = Venue::decode(payload, message);
+    if (trace) trace->parsedNs = latencyNow();
+    switch (status) {
+    case BookParseStatus::Book:
+        return apply<Venue>(message, trace);
+    case BookParseStatus::NotBook:
+        return BookUpdateResult::Ignored;
+    case BookParseStatus::Malformed:
+        break;
+    }
+
+    LOG_WARN("Orderbook", "Malformed {} book message", Venue::kName);
+    if (!isSynced()) return BookUpdateResult::Ignored;
+    // We may have lost a delta, so the book can no longer be trusted
+    invalidate();
+    return BookUpdateResult::ResyncRequired;
+}
+
+template <class Venue>
+BookUpdateResult Orderbook::apply(const BookMessage& message, LatencyTrace* trace) {
+    bool isSnapshot = message.isSnapshot();
+    if (!isSnapshot) {
+        if (!isSynced()) return BookUpdateResult::Ignored;
+        switch (Venue::sequence(lastSeqId, message)) {
+        case SequenceCheck::InOrder:
+            break;
+        case SequenceCheck::Stale:
+            return BookUpdateResult::Ignored;
+        case SequenceCheck::Gap:
+            LOG_WARN("Orderbook", "{} sequence gap: last seqId {}, got prevSeqId {}", Venue::kName, lastSeqId,
+                     message.prevSeqId);
+            invalidate();
+            return BookUpdateResult::ResyncRequired;
         }
+    }
 
-        const auto& book = j["data"][0];
+    if (!applyLevels(message, isSnapshot)) {
+        LOG_WARN("Orderbook", "{} level off the instrument grid (tick {}, lot {})", Venue::kName,
+                 bids.instrument().tickSize(), bids.instrument().lotSize());
+        // The next snapshot then lands on a grid fine enough for this message
+        if (deriveGrid) learnGrid(message);
+        invalidate();
+        return BookUpdateResult::ResyncRequired;
+    }
 
-        if (book.contains("bids")) {
-            bids.clear();
-            for (const auto& level : book["bids"]) {
-                if (level.size() < 2) continue;
-                double price = std::stod(level[0].get<std::string>());
-                double quantity = std::stod(level[1].get<std::string>());
-                if (quantity > 0.0) bids[price] = quantity;
+    if constexpr (Venue::kHasChecksum) {
+        if (message.hasChecksum) {
+            int32_t actual = Venue::checksum(bids, asks);
+            if (actual != message.checksum) {
+                LOG_WARN("Orderbook", "Checksum mismatch: expected {}, computed {}", message.checksum, actual);
+                invalidate();
+                return BookUpdateResult::ResyncRequired;
             }
         }
+    }
+    return commit(message.seqId, trace);
+}
 
-        if (book.contains("asks")) {
-            asks.clear();
-            for (const auto& level : book["asks"]) {
-                if (level.size() < 2) continue;
-                double price = std::stod(level[0].get<std::string>());
-                double quantity = std::stod(level[1].get<std::string>());
-                if (quantity > 0.0) asks[price] = quantity;
-            }
+template BookUpdateResult Orderbook::update<Okx>(std::string_view, LatencyTrace*);
+template BookUpdateResult Orderbook::update<Binance>(std::string_view, LatencyTrace*);
+template BookUpdateResult Orderbook::update<Bybit>(std::string_view, LatencyTrace*);
+template BookUpdateResult Orderbook::apply<Okx>(const BookMessage&, LatencyTrace*);
+template BookUpdateResult Orderbook::apply<Binance>(const BookMessage&, LatencyTrace*);
+template BookUpdateResult Orderbook::apply<Bybit>(const BookMessage&, LatencyTrace*);
+
+bool Orderbook::applyLevels(const BookMessage& message, bool isSnapshot) {
+    if (isSnapshot) {
+        bids.clear();
+        asks.clear();
+        if (deriveGrid) {
+            learnGrid(message);
+            InstrumentSpec spec = InstrumentSpec::fromDecimals(priceDecimals, sizeDecimals);
+            bids.setInstrument(spec);
+            asks.setInstrument(spec);
         }
+    }
+    return applyLadderLevels(bids, message.bids) && applyLadderLevels(asks, message.asks);
+}
 
-        lastUpdateTime = std::chrono::steady_clock::now();
-    } catch (const std::exception& e) {
-        std::cerr << "[Orderbook] Failed to parse/update: " << e.what() << '\n';
+void Orderbook::learnGrid(const BookMessage& message) {
+    int price = priceDecimals, size = sizeDecimals;
+    for (const auto* levels : {&message.bids, &message.asks}) {
+        for (const BookLevel& level : *levels) {
+            price = std::max(price, InstrumentSpec::decimalsOf(level.priceText));
+            size = std::max(size, InstrumentSpec::decimalsOf(level.quantityText));
+        }
     }
+    // Text finer than the finest grid can never be matched; it stays rejected
+    price = std::min(price, InstrumentSpec::kMaxDecimals);
+    size = std::min(size, InstrumentSpec::kMaxDecimals);
+    if (price == priceDecimals && size == sizeDecimals) return;
+    LOG_INFO("Orderbook", "Derived grid refined to {} price / {} size decimals", price, size);
+    priceDecimals = price;
+    sizeDecimals = size;
+}
+
+BookUpdateResult Orderbook::commit(int64_t seqId, LatencyTrace* trace) {
+    lastSeqId = seqId;
+    synced.store(true, std::memory_order_release);
+    if (trace) trace->appliedNs = latencyNow();
+    publish();
+    if (trace) trace->publishedNs = latencyNow();
+    return BookUpdateResult::Applied;
+}
+
+void Orderbook::invalidate() {
+    bids.clear();
+    asks.clear();
+    synced.store(false, std::memory_order_release);
+    lastSeqId = -1;
+    // Readers must not keep trading on the last good book
+    publish();
+}
+
+void Orderbook::publish() {
+    auto now = std::chrono::steady_clock::now();
+
+    TopOfBook top;
+    top.bidPrice = bids.bestPrice();
+    top.bidQuantity = bids.bestQuantity();
+    top.askPrice = asks.bestPrice();
+    top.askQuantity = asks.bestQuantity();
+    top.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    top.version = ++updateCount;
+    top.seqId = lastSeqId;
+    topOfBook.store(top);
+
+    // Readers pin slots only briefly; if all are pinned this update is folded
+    // into the next publication instead of waiting. Observers see every
+    // update, so they get it in a private copy.
+    OrderBookSnapshot* snap = publisher.beginWrite();
+    if (!snap) {
+        unpublished.fetch_add(1, std::memory_order_relaxed);
+        if (observers.empty()) return;
+        snap = &observerBook;
+        snap->version = publisher.reserveVersion();
+    }
+
+    // The running totals are built on the published arrays, which are
+    // already best-first, so the kernel reads them in place
+    auto copySide = [this](const PriceLadder& ladder, OrderBookSide& out, DepthIndex& depth) {
+        ladder.copyTop(std::min(ladder.size(), publishDepth), out);
+        buildDepthIndex(out, depth);
+    };
+    copySide(bids, snap->bids, snap->bidDepth);
+    copySide(asks, snap->asks, snap->askDepth);
+    snap->spec = bids.instrument();
+    snap->timestamp = now;
+    if (snap != &observerBook) publisher.publish();
+    // Only this thread recycles slots, so snap stays intact for the call
+    for (BookObserver* observer : observers) observer->onPublish(*snap);
 }
 
 double Orderbook::getBestBid() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return bids.empty() ? 0.0 : bids.begin()->first;
+    return topOfBook.load().bidPrice;
 }
 
 double Orderbook::getBestAsk() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return asks.empty() ? 0.0 : asks.begin()->first;
+    return topOfBook.load().askPrice;
 }
 
-double Orderbook::simulateMarketBuy(double usdAmount) {
-    std::lock_guard<std::mutex> lock(mtx);
+namespace {
+
+// Average fill price of spending usdAmount against one side, normalized by the best price
+double sweepNotional(const OrderBookSide& levels, double usdAmount) {
+    if (levels.empty()) return 0.0;
     double remaining = usdAmount;
     double cost = 0.0;
 
-    for (auto it = asks.begin(); it != asks.end() && remaining > 0; ++it) {
-        double price = it->first;
-        double qty = it->second;
+    for (size_t i = 0; i < levels.size() && remaining > 0; ++i) {
+        double price = levels[i].price;
+        double qty = levels[i].quantity;
         double value = price * qty;
 
         if (value <= remaining) {
@@ -74,53 +223,59 @@ double Orderbook::simulateMarketBuy(double usdAmount) {
         }
     }
 
-    return remaining > 0 ? 0.0 : cost / (usdAmount / getBestAsk());  // normalized average
+    return remaining > 0 ? 0.0 : cost / (usdAmount / levels.front().price);  // normalized average
 }
 
-double Orderbook::simulateMarketSell(double usdAmount) {
-    std::lock_guard<std::mutex> lock(mtx);
-    double remaining = usdAmount;
-    double cost = 0.0;
+size_t copyLevels(const OrderBookSide& side, size_t depth, std::vector<std::pair<double, double>>& out) {
+    size_t n = std::min(depth, side.size());
+    out.resize(n);
+    for (size_t i = 0; i < n; ++i) out[i] = {side.prices[i], side.quantities[i]};
+    return n;
+}
 
-    for (auto it = bids.begin(); it != bids.end() && remaining > 0; ++it) {
-        double price = it->first;
-        double qty = it->second;
-        double value = price * qty;
+} // namespace
 
-        if (value <= remaining) {
-            cost += value;
-            remaining -= value;
-        } else {
-            double partialQty = remaining / price;
-            cost += partialQty * price;
-            remaining = 0;
-        }
-    }
+double Orderbook::simulateMarketBuy(double usdAmount) {
+    SnapshotHandle snap = publisher.acquire();
+    return snap ? sweepNotional(snap->asks, usdAmount) : 0.0;
+}
 
-    return remaining > 0 ? 0.0 : cost / (usdAmount / getBestBid());
+double Orderbook::simulateMarketSell(double usdAmount) {
+    SnapshotHandle snap = publisher.acquire();
+    return snap ? sweepNotional(snap->bids, usdAmount) : 0.0;
 }
 
 std::vector<std::pair<double, double>> Orderbook::getBidLevels(size_t depth) const {
-    std::lock_guard<std::mutex> lock(mtx);
     std::vector<std::pair<double, double>> levels;
-    for (const auto& [price, qty] : bids) {
-        levels.emplace_back(price, qty);
-        if (levels.size() >= depth) break;
-    }
+    getBidLevels(levels, depth);
     return levels;
 }
 
 std::vector<std::pair<double, double>> Orderbook::getAskLevels(size_t depth) const {
-    std::lock_guard<std::mutex> lock(mtx);
     std::vector<std::pair<double, double>> levels;
-    for (const auto& [price, qty] : asks) {
-        levels.emplace_back(price, qty);
-        if (levels.size() >= depth) break;
-    }
+    getAskLevels(levels, depth);
     return levels;
 }
 
+size_t Orderbook::getBidLevels(std::vector<std::pair<double, double>>& out, size_t depth) const {
+    SnapshotHandle snap = publisher.acquire();
+    if (!snap) {
+        out.clear();
+        return 0;
+    }
+    return copyLevels(snap->bids, depth, out);
+}
+
+size_t Orderbook::getAskLevels(std::vector<std::pair<double, double>>& out, size_t depth) const {
+    SnapshotHandle snap = publisher.acquire();
+    if (!snap) {
+        out.clear();
+        return 0;
+    }
+    return copyLevels(snap->asks, depth, out);
+}
+
 std::chrono::steady_clock::time_point Orderbook::getLastUpdateTime() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return lastUpdateTime;
+    auto ns = std::chrono::nanoseconds(topOfBook.load().timestampNs);
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(ns));
 }
@@ -0,0 +1,135 @@
+#include "priceLadder.h"
+#include <algorithm>
+#include <cstring>
+
+void LevelText::assign(std::string_view priceText, std::string_view quantityText) {
+    priceLength = static_cast<uint8_t>(std::min(priceText.size(), kMaxLength));
+    quantityLength = static_cast<uint8_t>(std::min(quantityText.size(), kMaxLength));
+    if (priceLength) std::memcpy(price, priceText.data(), priceLength);
+    if (quantityLength) std::memcpy(quantity, quantityText.data(), quantityLength);
+}
+
+namespace {
+
+// Moves count elements starting at from to start at to (ranges may overlap)
+template <typename T>
+void moveRange(std::vector<T>& v, size_t from, size_t to, size_t count) {
+    if (count && from != to) std::memmove(v.data() + to, v.data() + from, count * sizeof(T));
+}
+
+} // namespace
+
+PriceLadder::PriceLadder(LadderSide side, size_t capacity, const InstrumentSpec& instrument)
+    : ladderSide(side), spec(instrument), levelCapacity(capacity),
+      priceTicks(2 * capacity + 2), sizeLots(2 * capacity + 2), textIds(2 * capacity + 2), textPool(capacity) {
+    clear();
+}
+
+void PriceLadder::clear() {
+    begin = end = priceTicks.size() / 2;
+    freeTextIds.clear();
+    for (size_t id = levelCapacity; id-- > 0;) freeTextIds.push_back(static_cast<uint32_t>(id));
+}
+
+size_t PriceLadder::lowerBound(int64_t ticks) const {
+    // Snapshots arrive best-first, so each of their levels lands past the worst
+    if (empty() || isBetter(priceTicks[end - 1], ticks)) return end;
+    // Binary search with conditional moves instead of branches: where an
+    // update lands is unpredictable, so a branching search mispredicts about
+    // every other step
+    const int64_t* base = priceTicks.data() + begin;
+    size_t n = size();
+    if (ladderSide == LadderSide::Bid) {
+        while (n > 1) {
+            size_t half = n / 2;
+            base += (base[half - 1] > ticks) * half;
+            n -= half;
+        }
+        return static_cast<size_t>(base - priceTicks.data()) + (*base > ticks);
+    }
+    while (n > 1) {
+        size_t half = n / 2;
+        base += (base[half - 1] < ticks) * half;
+        n -= half;
+    }
+    return static_cast<size_t>(base - priceTicks.data()) + (*base < ticks);
+}
+
+void PriceLadder::moveLevels(size_t from, size_t to, size_t n) {
+    moveRange(priceTicks, from, to, n);
+    moveRange(sizeLots, from, to, n);
+    moveRange(textIds, from, to, n);
+}
+
+void PriceLadder::recenter() {
+    size_t n = size();
+    size_t newBegin = (priceTicks.size() - n) / 2;
+    moveLevels(begin, newBegin, n);
+    begin = newBegin;
+    end = newBegin + n;
+}
+
+bool PriceLadder::set(int64_t ticks, int64_t lots,
+                      std::string_view priceText, std::string_view quantityText) {
+    if (lots <= 0) return erase(ticks);
+
+    size_t i = lowerBound(ticks);
+    if (i < end && priceTicks[i] == ticks) {
+        sizeLots[i] = lots;
+        textPool[textIds[i]].assign(priceText, quantityText);
+        return true;
+    }
+
+    if (size() == levelCapacity) {
+        if (i == end) return false;  // worse than every level of a full ladder
+        --end;
+        freeTextIds.push_back(textIds[end]);
+    }
+
+    // Open a gap at i by shifting whichever neighbouring run is shorter
+    bool shiftBetter = i - begin < end - i;
+    if (shiftBetter ? begin == 0 : end == priceTicks.size()) {
+        recenter();
+        i = lowerBound(ticks);
+    }
+    if (shiftBetter) {
+        moveLevels(begin, begin - 1, i - begin);
+        --begin;
+        --i;
+    } else {
+        moveLevels(i, i + 1, end - i);
+        ++end;
+    }
+
+    uint32_t id = freeTextIds.back();
+    freeTextIds.pop_back();
+    priceTicks[i] = ticks;
+    sizeLots[i] = lots;
+    textIds[i] = id;
+    textPool[id].assign(priceText, quantityText);
+    return true;
+}
+
+bool PriceLadder::erase(int64_t ticks) {
+    size_t i = lowerBound(ticks);
+    if (i >= end || priceTicks[i] != ticks) return false;
+
+    freeTextIds.push_back(textIds[i]);
+    if (i - begin < end - 1 - i) {
+        moveLevels(begin, begin + 1, i - begin);
+        ++begin;
+    } else {
+        moveLevels(i + 1, i, end - 1 - i);
+        --end;
+    }
+    if (empty()) begin = end = priceTicks.size() / 2;
+    return true;
+}
+
+void PriceLadder::copyTop(size_t n, OrderBookSide& out) const {
+    out.resize(n);
+    out.ticks.assign(priceTicks.begin() + begin, priceTicks.begin() + begin + n);
+    out.lots.assign(sizeLots.begin() + begin, sizeLots.begin() + begin + n);
+    spec.fromTicks(out.ticks.data(), n, out.prices.data());
+    spec.fromLots(out.lots.data(), n, out.quantities.data());
+}
@@ -0,0 +1,79 @@
+#include "replaySource.h"
+#include "latency.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+
+ReplaySource::ReplaySource(const std::string& path, Orderbook& book, ReplayPacing pacing, double speed)
+    : orderbook(book), pacing(pacing), speed(speed > 0.0 ? speed : 1.0) {
+    if (!reader.open(path)) LOG_ERROR("ReplaySource", "Cannot open session log {}", path);
+}
+
+BookUpdateResult ReplaySource::applyRecord(const FeedRecord& record) {
+    LatencyTrace trace;
+    trace.receiveNs = latencyNow();
+    BookParseStatus status = parseOkxBookMessage(record.payload, bookMessage);
+    trace.parsedNs = latencyNow();
+
+    BookUpdateResult outcome = BookUpdateResult::Ignored;
+    if (status == BookParseStatus::Book) {
+        outcome = orderbook.apply(bookMessage, &trace);
+        latencyStats().record(trace);
+    } else if (status == BookParseStatus::Malformed && orderbook.isSynced()) {
+        orderbook.invalidate();
+        outcome = BookUpdateResult::ResyncRequired;
+    }
+    // Unlike the live client there is nobody to ask for a fresh snapshot;
+    // the book resyncs on the next one in the recording
+    if (outcome == BookUpdateResult::ResyncRequired) resyncs.fetch_add(1, std::memory_order_relaxed);
+    messages.fetch_add(1, std::memory_order_relaxed);
+    return outcome;
+}
+
+bool ReplaySource::step(BookUpdateResult* result) {
+    FeedRecord record;
+    if (!reader.next(record)) return false;
+    BookUpdateResult outcome = applyRecord(record);
+    if (result) *result = outcome;
+    return true;
+}
+
+void ReplaySource::start() {
+    if (running || !reader.isOpen()) return;
+    running = true;
+    done = false;
+    worker = std::thread(&ReplaySource::run, this);
+}
+
+void ReplaySource::stop() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void ReplaySource::run() {
+    // Original pacing maps each recorded receive time onto the replay clock,
+    // scaled by speed, so gaps are reproduced without drift accumulating
+    int64_t recordedStart = 0;
+    auto replayStart = std::chrono::steady_clock::now();
+    bool first = true;
+
+    FeedRecord record;
+    while (running.load(std::memory_order_relaxed) && reader.next(record)) {
+        if (pacing == ReplayPacing::Original) {
+            if (first) {
+                recordedStart = record.receiveNs;
+                first = false;
+            }
+            auto due = replayStart + std::chrono::nanoseconds(
+                static_cast<int64_t>((record.receiveNs - recordedStart) / speed));
+            // Sleep in slices so stop() is not held up by long recorded gaps
+            for (auto now = std::chrono::steady_clock::now(); now < due && running.load(std::memory_order_relaxed);
+                 now = std::chrono::steady_clock::now())
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                    due - now, std::chrono::milliseconds(50)));
+            if (!running.load(std::memory_order_relaxed)) break;
+        }
+        applyRecord(record);
+    }
+    done.store(true, std::memory_order_release);
+}
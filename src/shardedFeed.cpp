@@ -0,0 +1,272 @@
+#include "shardedFeed.h"
+#include "latency.h"
+#include "logger.h"
+#include "exchange.h"
+#include "threadAffinity.h"
+#include <ixwebsocket/IXNetSystem.h>
+#include <ixwebsocket/IXWebSocket.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr size_t kBatch = 32;            // messages taken from one queue before moving to the next
+constexpr size_t kSubscribeBatch = 100;  // args per subscribe request
+constexpr int kIdleSpins = 256;          // empty passes before an idle worker starts sleeping
+
+// instId of a push, found without a full parse; empty if there is none
+std::string_view findInstId(std::string_view payload) {
+    constexpr std::string_view key = "\"instId\":\"";
+    size_t at = payload.find(key);
+    if (at == std::string_view::npos) return {};
+    size_t begin = at + key.size();
+    size_t end = payload.find('"', begin);
+    if (end == std::string_view::npos) return {};
+    return payload.substr(begin, end - begin);
+}
+
+} // namespace
+
+// Single-producer/single-consumer message queue: the connection's thread
+// produces, the shard's worker consumes. Slots keep their string capacity.
+struct ShardedFeed::Ring {
+    struct Slot {
+        std::string payload;  // empty: the connection dropped, invalidate the book
+        int64_t receiveNs = 0;
+        size_t route = 0;
+    };
+
+    explicit Ring(size_t capacity) : slots(capacity), mask(capacity - 1) {}
+
+    alignas(64) std::atomic<uint64_t> head{0};  // next slot to process (worker)
+    alignas(64) std::atomic<uint64_t> tail{0};  // next free slot (producer)
+    uint64_t cachedHead = 0;                    // producer's last view of head
+    std::vector<Slot> slots;
+    size_t mask;
+};
+
+struct ShardedFeed::Shard {
+    BookMessage message;  // reused by the worker
+    std::thread worker;
+    alignas(64) std::atomic<uint64_t> processed{0};
+    LatencyStats latency;  // written by the worker only
+};
+
+struct ShardedFeed::Connection {
+    size_t index = 0;
+    std::vector<size_t> routes;  // symbols subscribed on this connection
+    ix::WebSocket socket;
+};
+
+ShardedFeed::ShardedFeed(BookRegistry& registry, const ShardedFeedConfig& cfg) : config(cfg) {
+    config.shards = std::max<size_t>(config.shards, 1);
+    config.symbolsPerConnection = std::max<size_t>(config.symbolsPerConnection, 1);
+    size_t capacity = 2;
+    while (capacity < config.queueCapacity) capacity <<= 1;
+
+    // Round-robin over shards, consecutive blocks per connection, in registration order
+    size_t skipped = 0;
+    for (size_t i = 0; i < registry.size(); ++i) {
+        if (registry.keyAt(i).exchange != Okx::kName) {
+            ++skipped;
+            continue;
+        }
+        size_t n = routes.size();
+        routes.push_back({registry.keyAt(i).symbol, &registry.bookAt(i), n % config.shards,
+                          n / config.symbolsPerConnection});
+    }
+    if (skipped) LOG_WARN("ShardedFeed", "{} registry books are not {} and will not be streamed", skipped, Okx::kName);
+    size_t connectionTotal = (routes.size() + config.symbolsPerConnection - 1) / config.symbolsPerConnection;
+    std::sort(routes.begin(), routes.end(), [](const Route& a, const Route& b) { return a.symbol < b.symbol; });
+
+    for (size_t s = 0; s < config.shards; ++s) shards.emplace_back(new Shard());
+    for (size_t c = 0; c < connectionTotal; ++c) {
+        connections.emplace_back(new Connection());
+        connections.back()->index = c;
+    }
+    for (size_t r = 0; r < routes.size(); ++r) connections[routes[r].connection]->routes.push_back(r);
+    for (size_t i = 0; i < connectionTotal * config.shards; ++i) rings.emplace_back(new Ring(capacity));
+
+    if (!config.url.empty()) ix::initNetSystem();
+}
+
+ShardedFeed::~ShardedFeed() {
+    stop();
+    if (!config.url.empty()) ix::uninitNetSystem();
+}
+
+bool ShardedFeed::assignShard(const std::string& symbol, size_t shard) {
+    size_t route = findRoute(symbol);
+    if (running || route == SIZE_MAX || shard >= shards.size()) return false;
+    routes[route].shard = shard;
+    return true;
+}
+
+void ShardedFeed::start() {
+    if (running) return;
+    running = true;
+    for (size_t s = 0; s < shards.size(); ++s) shards[s]->worker = std::thread(&ShardedFeed::runShard, this, s);
+    if (!config.url.empty())
+        for (auto& connection : connections) connect(*connection);
+}
+
+void ShardedFeed::stop() {
+    if (!running) return;
+    // Producers first, so no connection is left waiting on a full queue
+    for (auto& connection : connections) connection->socket.stop();
+    running = false;
+    for (auto& shard : shards)
+        if (shard->worker.joinable()) shard->worker.join();
+}
+
+uint64_t ShardedFeed::messageCount() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards) total += shard->processed.load(std::memory_order_relaxed);
+    return total;
+}
+
+void ShardedFeed::mergeLatency(LatencyStats& out) const {
+    for (const auto& shard : shards) out.merge(shard->latency);
+}
+
+size_t ShardedFeed::findRoute(std::string_view symbol) const {
+    auto it = std::lower_bound(routes.begin(), routes.end(), symbol,
+                               [](const Route& route, std::string_view s) { return route.symbol < s; });
+    return it != routes.end() && it->symbol == symbol ? static_cast<size_t>(it - routes.begin()) : SIZE_MAX;
+}
+
+ShardedFeed::Ring& ShardedFeed::ring(size_t connection, size_t shard) const {
+    return *rings[connection * shards.size() + shard];
+}
+
+void ShardedFeed::submit(size_t connection, std::string_view payload, int64_t receiveNs) {
+    if (payload.compare(0, 9, "{\"event\":") == 0) {
+        handleEvent(payload);
+        return;
+    }
+    size_t route = findRoute(findInstId(payload));
+    if (route == SIZE_MAX) return;  // pong, or a symbol we do not stream
+    enqueue(connection, route, payload, receiveNs);
+}
+
+void ShardedFeed::enqueue(size_t connection, size_t route, std::string_view payload, int64_t receiveNs) {
+    Ring& r = ring(connection, routes[route].shard);
+    uint64_t tail = r.tail.load(std::memory_order_relaxed);
+    while (tail - r.cachedHead >= r.slots.size()) {
+        r.cachedHead = r.head.load(std::memory_order_acquire);
+        if (tail - r.cachedHead < r.slots.size()) break;
+        if (!running.load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();  // backpressure onto the socket
+    }
+    Ring::Slot& slot = r.slots[tail & r.mask];
+    slot.payload.assign(payload.data(), payload.size());
+    slot.receiveNs = receiveNs;
+    slot.route = route;
+    r.tail.store(tail + 1, std::memory_order_release);
+}
+
+void ShardedFeed::handleEvent(std::string_view payload) {
+    // Rare, so the full JSON parser is fine here
+    json event = json::parse(payload.begin(), payload.end(), nullptr, false);
+    if (!event.is_object()) return;
+    if (event.value("event", "") == "error")
+        LOG_ERROR("ShardedFeed", "Exchange error {}: {}", event.value("code", ""), event.value("msg", ""));
+}
+
+void ShardedFeed::connect(Connection& connection) {
+    connection.socket.setUrl(config.url);
+    connection.socket.setOnMessageCallback([this, &connection](const ix::WebSocketMessagePtr& msg) {
+        if (msg->type == ix::WebSocketMessageType::Message) {
+            submit(connection.index, msg->str, latencyNow());
+        } else if (msg->type == ix::WebSocketMessageType::Open) {
+            LOG_INFO("ShardedFeed", "Connection {} open, subscribing {} symbols", connection.index,
+                     connection.routes.size());
+            subscribe(connection, "subscribe", connection.routes);
+        } else if (msg->type == ix::WebSocketMessageType::Close) {
+            LOG_INFO("ShardedFeed", "Connection {} closed, reconnecting", connection.index);
+            // Readers must not keep trading on books that stopped updating
+            for (size_t route : connection.routes) enqueue(connection.index, route, {}, 0);
+        } else if (msg->type == ix::WebSocketMessageType::Error) {
+            LOG_ERROR("ShardedFeed", "Connection {} error: {}", connection.index, msg->errorInfo.reason);
+        }
+    });
+    connection.socket.start();  // reconnects automatically
+}
+
+// OKX takes many books per request, so the initial subscription is batched
+void ShardedFeed::subscribe(Connection& connection, const char* op, const std::vector<size_t>& symbols) {
+    for (size_t first = 0; first < symbols.size(); first += kSubscribeBatch) {
+        json args = json::array();
+        size_t last = std::min(symbols.size(), first + kSubscribeBatch);
+        for (size_t i = first; i < last; ++i)
+            args.push_back({{"channel", "books"}, {"instId", routes[symbols[i]].symbol}});
+        connection.socket.send(json{{"op", op}, {"args", args}}.dump());
+    }
+}
+
+void ShardedFeed::resubscribe(size_t route) {
+    if (config.url.empty()) return;
+    Connection& connection = *connections[routes[route].connection];
+    connection.socket.send(Okx::subscribeMessage(routes[route].symbol, false));
+    connection.socket.send(Okx::subscribeMessage(routes[route].symbol, true));
+}
+
+void ShardedFeed::runShard(size_t index) {
+    Shard& shard = *shards[index];
+    if (index < config.shardCpus.size() && !pinCurrentThread(config.shardCpus[index]))
+        LOG_WARN("ShardedFeed", "Could not pin shard {} to CPU {}", index, config.shardCpus[index]);
+
+    int idle = 0;
+    while (running.load(std::memory_order_acquire)) {
+        uint64_t done = 0;
+        for (size_t c = 0; c < connections.size(); ++c) {
+            Ring& r = ring(c, index);
+            uint64_t head = r.head.load(std::memory_order_relaxed);
+            uint64_t tail = r.tail.load(std::memory_order_acquire);
+            for (size_t n = 0; head != tail && n < kBatch; ++n, ++head) {
+                Ring::Slot& slot = r.slots[head & r.mask];
+                process(shard, slot.route, slot.payload, slot.receiveNs);
+            }
+            done += head - r.head.load(std::memory_order_relaxed);
+            r.head.store(head, std::memory_order_release);
+        }
+        if (done) {
+            shard.processed.fetch_add(done, std::memory_order_relaxed);
+            idle = 0;
+        } else if (config.busyPoll || ++idle < kIdleSpins) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+void ShardedFeed::process(Shard& shard, size_t route, const std::string& payload, int64_t receiveNs) {
+    Orderbook& book = *routes[route].book;
+    if (payload.empty()) {
+        book.invalidate();
+        return;
+    }
+
+    LatencyTrace trace;
+    trace.receiveNs = receiveNs;
+    BookParseStatus status = Okx::decode(payload, shard.message);
+    trace.parsedNs = latencyNow();
+    if (status == BookParseStatus::Book) {
+        if (book.apply<Okx>(shard.message, &trace) == BookUpdateResult::ResyncRequired) {
+            LOG_WARN("ShardedFeed", "{} out of sync, resubscribing for a snapshot", routes[route].symbol);
+            resyncs.fetch_add(1, std::memory_order_relaxed);
+            resubscribe(route);
+        }
+        shard.latency.record(trace);
+    } else if (status == BookParseStatus::Malformed && book.isSynced()) {
+        LOG_WARN("ShardedFeed", "Malformed book message for {}", routes[route].symbol);
+        book.invalidate();
+        resyncs.fetch_add(1, std::memory_order_relaxed);
+        resubscribe(route);
+    }
+}
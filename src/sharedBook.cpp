@@ -0,0 +1,117 @@
+#include "sharedBook.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// A reader overlapping the writer spins; after this many attempts it yields
+// (the writer may be descheduled), and after kMaxAttempts it gives up on a
+// writer that died mid-update
+constexpr int kSpinsBeforeYield = 64;
+constexpr int kMaxAttempts = 1 << 20;
+
+double asDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool backOff(int& attempts) {
+    if (++attempts >= kMaxAttempts) return false;
+    if (attempts % kSpinsBeforeYield == 0) std::this_thread::yield();
+    return true;
+}
+
+} // namespace
+
+std::string sharedBookName(const std::string& exchange, const std::string& symbol) {
+    std::string name = "/tradesim." + exchange + "." + symbol;
+    for (size_t i = 1; i < name.size(); ++i) {
+        char c = name[i];
+        bool plain = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' ||
+                     c == '_' || c == '-';
+        if (!plain) name[i] = '_';
+    }
+    return name;
+}
+
+bool SharedBookReader::open(const std::string& name) {
+    close();
+    if (!region.open(name)) return false;
+    const SharedBookHeader* h = reinterpret_cast<const SharedBookHeader*>(region.data());
+    if (region.size() < sharedBookLayout::kLevelsOffset ||
+        std::memcmp(h->magic, SharedBookHeader::kMagic, sizeof(h->magic)) != 0 ||
+        h->version != SharedBookHeader::kVersion || region.size() < sharedBookLayout::regionSize(h->levels)) {
+        region.close();
+        return false;
+    }
+    header = h;
+    state = reinterpret_cast<const SharedBookState*>(region.data() + sharedBookLayout::kStateOffset);
+    words = reinterpret_cast<const std::atomic<uint64_t>*>(region.data() + sharedBookLayout::kLevelsOffset);
+    return true;
+}
+
+void SharedBookReader::close() {
+    region.close();
+    header = nullptr;
+    state = nullptr;
+    words = nullptr;
+}
+
+bool SharedBookReader::top(SharedTopOfBook& out) const {
+    uint64_t before, after, version, timestamp, top[4];
+    int attempts = 0;
+    for (;;) {
+        before = state->sequence.load(std::memory_order_acquire);
+        version = state->bookVersion.load(std::memory_order_relaxed);
+        timestamp = state->timestampNs.load(std::memory_order_relaxed);
+        for (int i = 0; i < 4; ++i) top[i] = state->top[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = state->sequence.load(std::memory_order_relaxed);
+        if (before == after && !(before & 1)) break;
+        if (!backOff(attempts)) return false;
+    }
+    if (before == 0) return false;
+    out.version = version;
+    out.timestampNs = static_cast<int64_t>(timestamp);
+    out.bidPrice = asDouble(top[0]);
+    out.bidQuantity = asDouble(top[1]);
+    out.askPrice = asDouble(top[2]);
+    out.askQuantity = asDouble(top[3]);
+    return true;
+}
+
+bool SharedBookReader::read(SharedDepth& out, size_t maxLevels) const {
+    const size_t capacity = header->levels;
+    const std::atomic<uint64_t>* askWords = words + 2 * capacity;
+    uint64_t before, after, version, timestamp;
+    int attempts = 0;
+    for (;;) {
+        before = state->sequence.load(std::memory_order_acquire);
+        version = state->bookVersion.load(std::memory_order_relaxed);
+        timestamp = state->timestampNs.load(std::memory_order_relaxed);
+        uint64_t counts = state->counts.load(std::memory_order_relaxed);
+        // Counts from a torn read may be garbage; clamp before sizing
+        size_t bids = std::min({static_cast<size_t>(counts & 0xffffffffu), capacity, maxLevels});
+        size_t asks = std::min({static_cast<size_t>(counts >> 32), capacity, maxLevels});
+        out.bids.resize(bids);
+        out.asks.resize(asks);
+        for (size_t k = 0; k < bids; ++k) {
+            out.bids.prices[k] = asDouble(words[2 * k].load(std::memory_order_relaxed));
+            out.bids.quantities[k] = asDouble(words[2 * k + 1].load(std::memory_order_relaxed));
+        }
+        for (size_t k = 0; k < asks; ++k) {
+            out.asks.prices[k] = asDouble(askWords[2 * k].load(std::memory_order_relaxed));
+            out.asks.quantities[k] = asDouble(askWords[2 * k + 1].load(std::memory_order_relaxed));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = state->sequence.load(std::memory_order_relaxed);
+        if (before == after && !(before & 1)) break;
+        if (!backOff(attempts)) return false;
+    }
+    if (before == 0) return false;
+    out.version = version;
+    out.timestampNs = static_cast<int64_t>(timestamp);
+    return true;
+}
@@ -0,0 +1,78 @@
+#include "sharedBookPublisher.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+uint64_t bitsOf(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+void copyName(char* to, size_t size, const std::string& from) {
+    size_t n = std::min(size - 1, from.size());
+    std::memcpy(to, from.data(), n);
+    to[n] = '\0';
+}
+
+} // namespace
+
+SharedBookPublisher::SharedBookPublisher(const std::string& exchange, const std::string& symbol,
+                                         const InstrumentSpec& spec, size_t levels)
+    : regionName(sharedBookName(exchange, symbol)), capacity(std::max<size_t>(levels, 1)) {
+    if (!region.create(regionName, sharedBookLayout::regionSize(capacity))) {
+        LOG_WARN("SharedBook", "Cannot create shared memory {}", regionName);
+        return;
+    }
+    // The region starts zeroed: sequence 0 reads as "nothing published yet"
+    header = reinterpret_cast<SharedBookHeader*>(region.data());
+    state = reinterpret_cast<SharedBookState*>(region.data() + sharedBookLayout::kStateOffset);
+    words = reinterpret_cast<std::atomic<uint64_t>*>(region.data() + sharedBookLayout::kLevelsOffset);
+    header->version = SharedBookHeader::kVersion;
+    header->levels = static_cast<uint32_t>(capacity);
+    copyName(header->exchange, sizeof(header->exchange), exchange);
+    copyName(header->symbol, sizeof(header->symbol), symbol);
+    header->tickSize = spec.tickSize();
+    header->lotSize = spec.lotSize();
+    // Magic last: a reader that sees it sees the rest of the description
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, SharedBookHeader::kMagic, sizeof(header->magic));
+}
+
+SharedBookPublisher::~SharedBookPublisher() {
+    if (header) header->closed.store(1, std::memory_order_release);
+}
+
+void SharedBookPublisher::onPublish(const OrderBookSnapshot& snapshot) {
+    if (!state) return;
+    const size_t bids = std::min(capacity, snapshot.bids.size());
+    const size_t asks = std::min(capacity, snapshot.asks.size());
+    std::atomic<uint64_t>* askWords = words + 2 * capacity;
+
+    uint64_t seq = state->sequence.load(std::memory_order_relaxed);
+    state->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    state->bookVersion.store(snapshot.version, std::memory_order_relaxed);
+    state->timestampNs.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       snapshot.timestamp.time_since_epoch())
+                                                       .count()),
+                             std::memory_order_relaxed);
+    state->counts.store(bids | (static_cast<uint64_t>(asks) << 32), std::memory_order_relaxed);
+    state->top[0].store(bitsOf(bids ? snapshot.bids.prices[0] : 0.0), std::memory_order_relaxed);
+    state->top[1].store(bitsOf(bids ? snapshot.bids.quantities[0] : 0.0), std::memory_order_relaxed);
+    state->top[2].store(bitsOf(asks ? snapshot.asks.prices[0] : 0.0), std::memory_order_relaxed);
+    state->top[3].store(bitsOf(asks ? snapshot.asks.quantities[0] : 0.0), std::memory_order_relaxed);
+    for (size_t k = 0; k < bids; ++k) {
+        words[2 * k].store(bitsOf(snapshot.bids.prices[k]), std::memory_order_relaxed);
+        words[2 * k + 1].store(bitsOf(snapshot.bids.quantities[k]), std::memory_order_relaxed);
+    }
+    for (size_t k = 0; k < asks; ++k) {
+        askWords[2 * k].store(bitsOf(snapshot.asks.prices[k]), std::memory_order_relaxed);
+        askWords[2 * k + 1].store(bitsOf(snapshot.asks.quantities[k]), std::memory_order_relaxed);
+    }
+
+    state->sequence.store(seq + 2, std::memory_order_release);
+}
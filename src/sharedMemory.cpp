@@ -0,0 +1,151 @@
+#include "sharedMemory.h"
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SharedMemory::SharedMemory(SharedMemory&& other) noexcept {
+    *this = std::move(other);
+}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(bytes, other.bytes);
+        std::swap(length, other.length);
+        std::swap(owner, other.owner);
+        std::swap(regionName, other.regionName);
+#ifdef _WIN32
+        std::swap(mappingHandle, other.mappingHandle);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+namespace {
+
+// Session-local kernel object name; the POSIX-style leading slash is dropped
+std::string mappingName(const std::string& name) {
+    return "Local\\" + (name.empty() || name[0] != '/' ? name : name.substr(1));
+}
+
+} // namespace
+
+bool SharedMemory::create(const std::string& name, size_t size) {
+    close();
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<unsigned long long>(size) >> 32),
+                                        static_cast<DWORD>(size), mappingName(name).c_str());
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    // An existing mapping of the same name is reused, so clear it
+    std::memset(view, 0, size);
+    mappingHandle = mapping;
+    bytes = static_cast<char*>(view);
+    length = size;
+    owner = true;
+    regionName = name;
+    return true;
+}
+
+bool SharedMemory::open(const std::string& name) {
+    close();
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, mappingName(name).c_str());
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (!view || VirtualQuery(view, &info, sizeof(info)) == 0) {
+        if (view) UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+    mappingHandle = mapping;
+    bytes = static_cast<char*>(view);
+    length = info.RegionSize;  // rounded up to whole pages
+    regionName = name;
+    return true;
+}
+
+void SharedMemory::close() {
+    // The mapping object goes away with its last handle
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+    bytes = nullptr;
+    mappingHandle = nullptr;
+    length = 0;
+    owner = false;
+    regionName.clear();
+}
+
+#else
+
+bool SharedMemory::create(const std::string& name, size_t size) {
+    close();
+    // A region left behind by a crashed writer is replaced, not reused, so
+    // readers still mapping it never see it reinitialized under them
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the region alive
+    if (view == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+    bytes = static_cast<char*>(view);
+    length = size;
+    owner = true;
+    regionName = name;
+    return true;
+}
+
+bool SharedMemory::open(const std::string& name) {
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    bytes = static_cast<char*>(view);
+    length = size;
+    regionName = name;
+    return true;
+}
+
+void SharedMemory::close() {
+    if (bytes) munmap(bytes, length);
+    if (owner) shm_unlink(regionName.c_str());
+    bytes = nullptr;
+    length = 0;
+    owner = false;
+    regionName.clear();
+}
+
+#endif
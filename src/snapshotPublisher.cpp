@@ -0,0 +1,67 @@
+#include "snapshotPublisher.h"
+
+SnapshotHandle::SnapshotHandle(SnapshotHandle&& other) noexcept
+    : snapshot(other.snapshot), readers(other.readers) {
+    other.snapshot = nullptr;
+    other.readers = nullptr;
+}
+
+SnapshotHandle& SnapshotHandle::operator=(SnapshotHandle&& other) noexcept {
+    if (this != &other) {
+        release();
+        snapshot = other.snapshot;
+        readers = other.readers;
+        other.snapshot = nullptr;
+        other.readers = nullptr;
+    }
+    return *this;
+}
+
+void SnapshotHandle::release() {
+    if (readers) readers->fetch_sub(1, std::memory_order_release);
+    snapshot = nullptr;
+    readers = nullptr;
+}
+
+SnapshotPublisher::SnapshotPublisher(size_t count, size_t reserveDepth)
+    : slots(new Slot[count < 2 ? 2 : count]), slotCount(count < 2 ? 2 : count) {
+    for (size_t i = 0; i < slotCount; ++i) slots[i].snapshot.reserve(reserveDepth);
+}
+
+OrderBookSnapshot* SnapshotPublisher::beginWrite() {
+    size_t live = current.load(std::memory_order_relaxed);
+    for (size_t n = 0; n < slotCount; ++n) {
+        size_t i = (nextProbe + n) % slotCount;
+        if (i == live) continue;
+        // seq_cst pairs with the reader's increment-then-recheck in acquire()
+        if (slots[i].readers.load(std::memory_order_seq_cst) == 0) {
+            writeSlot = i;
+            nextProbe = (i + 1) % slotCount;
+            return &slots[i].snapshot;
+        }
+    }
+    writeSlot = kNone;
+    return nullptr;
+}
+
+void SnapshotPublisher::publish() {
+    if (writeSlot == kNone) return;
+    uint64_t version = ++issuedVersion;
+    slots[writeSlot].snapshot.version = version;
+    current.store(writeSlot, std::memory_order_seq_cst);
+    publishedVersion.store(version, std::memory_order_release);
+    writeSlot = kNone;
+}
+
+SnapshotHandle SnapshotPublisher::acquire() const {
+    for (;;) {
+        size_t i = current.load(std::memory_order_seq_cst);
+        if (i == kNone) return {};
+        slots[i].readers.fetch_add(1, std::memory_order_seq_cst);
+        // If the writer republished in between, the slot may be getting
+        // rewritten; drop the pin and try the new current slot instead
+        if (current.load(std::memory_order_seq_cst) == i)
+            return SnapshotHandle(&slots[i].snapshot, &slots[i].readers);
+        slots[i].readers.fetch_sub(1, std::memory_order_release);
+    }
+}
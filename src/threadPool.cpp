@@ -0,0 +1,61 @@
+#include "threadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 1; i < threads; ++i) workers.emplace_back(&ThreadPool::runWorker, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+    std::lock_guard<std::mutex> loop(loopMutex);
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        current = &task;
+        taskCount = count;
+        nextTask.store(0, std::memory_order_relaxed);
+        ++generation;
+    }
+    wake.notify_all();
+    drain();
+
+    // Workers may still be finishing their last task
+    std::unique_lock<std::mutex> lock(mtx);
+    done.wait(lock, [this] { return busy == 0; });
+    current = nullptr;
+}
+
+void ThreadPool::drain() {
+    for (size_t i = nextTask.fetch_add(1, std::memory_order_relaxed); i < taskCount;
+         i = nextTask.fetch_add(1, std::memory_order_relaxed))
+        (*current)(i);
+}
+
+void ThreadPool::runWorker() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || (generation != seen && current); });
+        if (stopping) return;
+        seen = generation;
+        ++busy;
+        lock.unlock();
+        drain();
+        lock.lock();
+        if (--busy == 0) done.notify_one();
+    }
+}
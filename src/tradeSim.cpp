@@ -1,33 +1,10 @@
+#include "tradeSim.h"
+#include "bookKernels.h"
+#include "latency.h"
 #include <vector>
 #include <cmath>
 #include <chrono>
-
-struct OrderLevel {
-    double price;
-    double quantity;
-};
-
-using OrderBookSide = std::vector<OrderLevel>;  // sorted descending for bids, ascending for asks
-
-struct OrderBookSnapshot {
-    OrderBookSide bids;
-    OrderBookSide asks;
-    std::chrono::steady_clock::time_point timestamp;
-};
-
-enum class Side { Buy, Sell };
-
-struct TradeResult {
-    double executedQuantity;    // How much was filled
-    double averagePrice;        // Weighted avg execution price
-    double totalCost;           // total cost including fees (for buys)
-    double totalProceeds;       // total proceeds net of fees (for sells)
-    double slippage;            // execution price vs mid price
-    double feesPaid;            // total fees
-    double marketImpact;        // liquidity consumed ratio
-    double makerTakerRatio;     // 0 = all taker (for market orders)
-    double latencyMicroseconds; // simulated or measured latency
-};
+#include <algorithm>
 
 // Simplified fee calculation (e.g. feeTier 1 = 0.1%)
 double calculateFees(double tradeValue, int feeTier, bool isMaker) {
@@ -36,26 +13,80 @@ double calculateFees(double tradeValue, int feeTier, bool isMaker) {
     return tradeValue * feeRate;
 }
 
+FillEstimate fillFromDepth(const OrderBookSide& levels, const DepthIndex& depth, double quantity) {
+    size_t n = std::min(levels.size(), depth.cumQuantity.size());
+    if (n == 0 || quantity <= 0.0) return {0.0, 0.0};
+
+    const double* cumQty = depth.cumQuantity.data();
+    const double* cumNotional = depth.cumNotional.data();
+    if (quantity >= cumQty[n - 1]) return {cumQty[n - 1], cumNotional[n - 1]};
+
+    // First level whose running total covers the order, then a partial fill there
+    size_t k = static_cast<size_t>(std::lower_bound(cumQty, cumQty + n, quantity) - cumQty);
+    double prevQty = k ? cumQty[k - 1] : 0.0;
+    double prevNotional = k ? cumNotional[k - 1] : 0.0;
+    return {quantity, prevNotional + (quantity - prevQty) * levels.prices[k]};
+}
+
+LotFill fillLots(const OrderBookSide& levels, const DepthIndex& depth, const InstrumentSpec& spec, int64_t lots) {
+    size_t n = std::min(levels.size(), depth.cumLots.size());
+    if (n == 0 || lots <= 0) return {0, 0.0};
+
+    const int64_t* cumLots = depth.cumLots.data();
+    const double* cumNotional = depth.cumNotional.data();
+    if (lots >= cumLots[n - 1]) return {cumLots[n - 1], cumNotional[n - 1]};
+
+    size_t k = static_cast<size_t>(std::lower_bound(cumLots, cumLots + n, lots) - cumLots);
+    int64_t prevLots = k ? cumLots[k - 1] : 0;
+    double prevNotional = k ? cumNotional[k - 1] : 0.0;
+    return {lots, prevNotional + spec.fromLots(lots - prevLots) * levels.prices[k]};
+}
+
 TradeResult simulateMarketOrder(
     const OrderBookSnapshot& book,
     Side side,
-    double quantity,           // base asset quantity to buy or sell
+    double quantity,
     int feeTier,
     std::chrono::steady_clock::time_point tradeTimestamp
+) {
+    FeeTier fees{calculateFees(1.0, feeTier, /*isMaker=*/true), calculateFees(1.0, feeTier, /*isMaker=*/false)};
+    return simulateMarketOrder(book, side, quantity, fees, tradeTimestamp);
+}
+
+TradeResult simulateMarketOrder(
+    const OrderBookSnapshot& book,
+    Side side,
+    double quantity,           // base asset quantity to buy or sell
+    const FeeTier& feeRates,
+    std::chrono::steady_clock::time_point tradeTimestamp
 ) {
     const OrderBookSide& levels = (side == Side::Buy) ? book.asks : book.bids;
-    double remainingQty = quantity;
-    double executedValue = 0.0; // sum of (price * quantity)
-    double executedQty = 0.0;
-
-    // Walk through order book levels to fill the order
-    for (const auto& level : levels) {
-        if (remainingQty <= 0) break;
-        double fillQty = std::min(remainingQty, level.quantity);
-        executedValue += fillQty * level.price;
-        executedQty += fillQty;
-        remainingQty -= fillQty;
+
+    // Snapshots from Orderbook (and indexed hand-built ones) carry prefix
+    // sums on the instrument grid, so the fill is a binary search in whole
+    // lots and the quantity becomes a double once, here. Unindexed ones fall
+    // back to a single vectorized sweep.
+    const DepthIndex& depth = (side == Side::Buy) ? book.askDepth : book.bidDepth;
+    bool indexed = depth.cumQuantity.size() == levels.size();
+    bool onGrid = indexed && depth.cumLots.size() == levels.size();
+    const BookKernels& kernels = bookKernels();
+
+    FillEstimate fill;
+    double totalLiquidity;
+    if (onGrid) {
+        LotFill lots = fillLots(levels, depth, book.spec, book.spec.toLots(quantity));
+        fill = {book.spec.fromLots(lots.lots), lots.notional};
+        totalLiquidity = book.spec.fromLots(depth.totalLots());
+    } else if (indexed) {
+        fill = fillFromDepth(levels, depth, quantity);
+        totalLiquidity = depth.totalQuantity();
+    } else {
+        fill.notional = kernels.fill(levels.prices.data(), levels.quantities.data(), levels.size(),
+                                     quantity, &fill.quantity);
+        totalLiquidity = kernels.sumQuantity(levels.quantities.data(), levels.size());
     }
+    double executedValue = fill.notional; // sum of (price * quantity)
+    double executedQty = fill.quantity;
 
     // If not fully filled, executedQty < quantity
 
@@ -70,7 +101,7 @@ TradeResult simulateMarketOrder(
     double slippage = (side == Side::Buy) ? (avgPrice - midPrice) / midPrice : (midPrice - avgPrice) / midPrice;
 
     // Fees (all market orders are taker here)
-    double fees = calculateFees(executedValue, feeTier, /*isMaker=*/false);
+    double fees = executedValue * feeRates.taker;
 
     // Total cost/proceeds including fees
     double totalCost = 0.0, totalProceeds = 0.0;
@@ -81,13 +112,15 @@ TradeResult simulateMarketOrder(
     }
 
     // Market impact = quantity filled / total visible liquidity on that side
-    double totalLiquidity = 0.0;
-    for (const auto& lvl : levels)
-        totalLiquidity += lvl.quantity;
     double marketImpact = (totalLiquidity > 0) ? (executedQty / totalLiquidity) : 0.0;
 
-    // Latency simulation
-    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(tradeTimestamp - book.timestamp).count();
+    // Measured latency: snapshot publication -> result ready, plus the
+    // simulation itself (from when the caller submitted the trade)
+    auto completed = std::chrono::steady_clock::now();
+    int64_t sinceTradeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(completed - tradeTimestamp).count();
+    int64_t sincePublishNs = std::chrono::duration_cast<std::chrono::nanoseconds>(completed - book.timestamp).count();
+    latencyStats().record(LatencyStage::Simulate, sinceTradeNs);
+    latencyStats().record(LatencyStage::PublishToResult, sincePublishNs);
 
     return TradeResult{
         executedQty,
@@ -98,6 +131,6 @@ TradeResult simulateMarketOrder(
         fees,
         marketImpact,
         0.0,           // makerTakerRatio: 0 for market order (all taker)
-        static_cast<double>(latency)
+        sincePublishNs / 1000.0
     };
 }
@@ -1,30 +1,30 @@
 #include "webSocketClient.h"
+#include "logger.h"
 #include <ixwebsocket/IXNetSystem.h>
-#include <nlohmann/json.hpp>
-#include <iostream>
 #include <thread>
 #include <chrono>
-#include <tradesim.h>
 
-using json = nlohmann::json;
-
-WebSocketClient::WebSocketClient(const std::string& url, Orderbook& ob)
-    : endpointUrl(url), orderbook(ob), running(false) {
+template <class Venue>
+BasicWebSocketClient<Venue>::BasicWebSocketClient(const std::string& url, Orderbook& ob, const std::string& instId)
+    : endpointUrl(url), instrument(instId), orderbook(ob), running(false) {
     ix::initNetSystem();
 }
 
-WebSocketClient::~WebSocketClient() {
+template <class Venue>
+BasicWebSocketClient<Venue>::~BasicWebSocketClient() {
     stop();
     ix::uninitNetSystem();
 }
 
-void WebSocketClient::start() {
+template <class Venue>
+void BasicWebSocketClient<Venue>::start() {
     if (running) return;
     running = true;
-    workerThread = std::thread(&WebSocketClient::runLoop, this);
+    workerThread = std::thread(&BasicWebSocketClient::runLoop, this);
 }
 
-void WebSocketClient::stop() {
+template <class Venue>
+void BasicWebSocketClient<Venue>::stop() {
     if (!running) return;
     running = false;
     {
@@ -36,9 +36,10 @@ void WebSocketClient::stop() {
         workerThread.join();
 }
 
-void WebSocketClient::runLoop() {
+template <class Venue>
+void BasicWebSocketClient<Venue>::runLoop() {
     while (running) {
-        std::cout << "[WebSocketClient] Connecting to: " << endpointUrl << "\n";
+        LOG_INFO("WebSocketClient", "Connecting to: {}", endpointUrl);
 
         webSocket_.setUrl(endpointUrl);
 
@@ -46,12 +47,12 @@ void WebSocketClient::runLoop() {
             if (msg->type == ix::WebSocketMessageType::Message) {
                 handleMessage(msg->str);
             } else if (msg->type == ix::WebSocketMessageType::Open) {
-                std::cout << "[WebSocketClient] Connected.\n";
+                LOG_INFO("WebSocketClient", "Connected.");
                 subscribeToOrderbook();
             } else if (msg->type == ix::WebSocketMessageType::Close) {
-                std::cout << "[WebSocketClient] Connection closed. Attempting to reconnect...\n";
+                LOG_INFO("WebSocketClient", "Connection closed. Attempting to reconnect...");
             } else if (msg->type == ix::WebSocketMessageType::Error) {
-                std::cerr << "[WebSocketClient] Error: " << msg->errorInfo.reason << std::endl;
+                LOG_ERROR("WebSocketClient", "Error: {}", msg->errorInfo.reason);
             }
         });
 
@@ -65,44 +66,60 @@ void WebSocketClient::runLoop() {
 
         if (!running) break;
 
-        std::cout << "[WebSocketClient] Reconnecting in 2 seconds...\n";
+        LOG_INFO("WebSocketClient", "Reconnecting in 2 seconds...");
         std::this_thread::sleep_for(std::chrono::seconds(2));
     }
 }
 
-void WebSocketClient::subscribeToOrderbook() {
-    json subscribeMsg = {
-        {"op", "subscribe"},
-        {"args", {{{"channel", "books"}, {"instId", "BTC-USDT"}}}}
-    };
-    webSocket_.send(subscribeMsg.dump());
+template <class Venue>
+void BasicWebSocketClient<Venue>::subscribeToOrderbook() {
+    webSocket_.send(Venue::subscribeMessage(instrument, true));
 }
 
-void WebSocketClient::handleMessage(const std::string& message) {
-    try {
-        auto j = json::parse(message);
-
-        if (j.contains("arg") && j["arg"]["channel"] == "books" && j.contains("data")) {
-            const auto& data = j["data"][0];
-
-            OrderBookSnapshot snapshot;
-            snapshot.timestamp = std::chrono::high_resolution_clock::now();
-
-            for (const auto& ask : data["asks"]) {
-                double price = std::stod(ask[0].get<std::string>());
-                double size = std::stod(ask[1].get<std::string>());
-                snapshot.asks.emplace_back(price, size);
-            }
-
-            for (const auto& bid : data["bids"]) {
-                double price = std::stod(bid[0].get<std::string>());
-                double size = std::stod(bid[1].get<std::string>());
-                snapshot.bids.emplace_back(price, size);
-            }
+template <class Venue>
+void BasicWebSocketClient<Venue>::resubscribeToOrderbook() {
+    webSocket_.send(Venue::subscribeMessage(instrument, false));
+    subscribeToOrderbook();
+}
 
-            orderbook.update(snapshot);
+template <class Venue>
+void BasicWebSocketClient<Venue>::handleMessage(const std::string& message) {
+    LatencyTrace trace;
+    trace.receiveNs = latencyNow();
+    if (recorder) recorder->append(message, trace.receiveNs);
+    BookParseStatus status = Venue::decode(message, bookMessage);
+    trace.parsedNs = latencyNow();
+
+    switch (status) {
+    case BookParseStatus::Book:
+        // Orderbook tracks snapshot/delta state; we only react when it loses sync
+        if (orderbook.apply<Venue>(bookMessage, &trace) == BookUpdateResult::ResyncRequired) {
+            LOG_WARN("WebSocketClient", "Order book out of sync, resubscribing for a snapshot");
+            resyncs.fetch_add(1, std::memory_order_relaxed);
+            resubscribeToOrderbook();
+        }
+        latencyStats().record(trace);
+        break;
+    case BookParseStatus::NotBook:
+        handleControlMessage(message);
+        break;
+    case BookParseStatus::Malformed:
+        LOG_WARN("WebSocketClient", "Malformed book message");
+        if (orderbook.isSynced()) {
+            orderbook.invalidate();
+            resyncs.fetch_add(1, std::memory_order_relaxed);
+            resubscribeToOrderbook();
         }
-    } catch (const std::exception& e) {
-        std::cerr << "[WebSocketClient] Failed to parse message: " << e.what() << std::endl;
+        break;
     }
 }
+
+template <class Venue>
+void BasicWebSocketClient<Venue>::handleControlMessage(const std::string& message) {
+    std::string error = Venue::controlError(message);
+    if (!error.empty()) LOG_ERROR("WebSocketClient", "{} error {}", Venue::kName, error);
+}
+
+template class BasicWebSocketClient<Okx>;
+template class BasicWebSocketClient<Binance>;
+template class BasicWebSocketClient<Bybit>;